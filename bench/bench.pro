@@ -0,0 +1,62 @@
+QT += core
+QT -= gui
+
+TARGET = q2c_bench
+CONFIG += console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../q2c
+DEFINES += TEST_FIXTURE_DIR=\\\"$$PWD/../tests/fixtures\\\"
+
+SOURCES += main.cpp \
+    corpusgenerator.cpp \
+    ../q2c/buildmodel.cpp \
+    ../q2c/charscanner.cpp \
+    ../q2c/cmakeparser.cpp \
+    ../q2c/cmakepresetsgenerator.cpp \
+    ../q2c/cmakegenerator.cpp \
+    ../q2c/compilecommandsgenerator.cpp \
+    ../q2c/compileflags.cpp \
+    ../q2c/generic.cpp \
+    ../q2c/logs.cpp \
+    ../q2c/memoryreport.cpp \
+    ../q2c/modelcache.cpp \
+    ../q2c/modeljson.cpp \
+    ../q2c/ninjagenerator.cpp \
+    ../q2c/pchanalyzer.cpp \
+    ../q2c/sourcescan.cpp \
+    ../q2c/allocationcounter.cpp \
+    ../q2c/qmakegenerator.cpp \
+    ../q2c/qmakeparser.cpp \
+    ../q2c/roundtrip.cpp \
+    ../q2c/tokenview.cpp \
+    ../q2c/unityplanner.cpp \
+    ../q2c/warningreport.cpp \
+    ../q2c/configuration.cpp
+
+HEADERS += \
+    corpusgenerator.h \
+    ../q2c/buildmodel.h \
+    ../q2c/charscanner.h \
+    ../q2c/cmakeparser.h \
+    ../q2c/cmakepresetsgenerator.h \
+    ../q2c/cmakegenerator.h \
+    ../q2c/compilecommandsgenerator.h \
+    ../q2c/compileflags.h \
+    ../q2c/generic.h \
+    ../q2c/logs.h \
+    ../q2c/memoryreport.h \
+    ../q2c/modelcache.h \
+    ../q2c/modeljson.h \
+    ../q2c/ninjagenerator.h \
+    ../q2c/pchanalyzer.h \
+    ../q2c/sourcescan.h \
+    ../q2c/qmakegenerator.h \
+    ../q2c/qmakeparser.h \
+    ../q2c/roundtrip.h \
+    ../q2c/tokenview.h \
+    ../q2c/unityplanner.h \
+    ../q2c/warningreport.h \
+    ../q2c/configuration.h
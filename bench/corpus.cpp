@@ -0,0 +1,96 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QTextStream>
+#include "corpusgenerator.h"
+
+static const int MaximumCount = 1000000;
+
+static void PrintUsage()
+{
+    QTextStream(stderr) << "Usage: q2c_corpus --output DIR [--format qmake|cmake] [--sources N]"
+                        << " [--include-depth N] [--scopes N] [--variables N] [--subdirs N] [--per-line]\n"
+                        << "Every count accepts values from 0 to " << MaximumCount << "\n";
+}
+
+static bool ReadCount(QString value, int *count)
+{
+    bool ok = false;
+    int parsed = value.toInt(&ok);
+    if (!ok || parsed < 0 || parsed > MaximumCount)
+        return false;
+    *count = parsed;
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    Q_UNUSED(app);
+
+    CorpusParameters parameters;
+    CorpusFormat format = CorpusFormat_QMake;
+    QString output;
+    QStringList args = QCoreApplication::arguments();
+    for (int i = 1; i < args.size(); i++)
+    {
+        QString arg = args.at(i);
+        bool has_value = i + 1 < args.size();
+        bool ok = true;
+        if (arg == "--output" && has_value)
+            output = args.at(++i);
+        else if (arg == "--format" && has_value)
+        {
+            QString name = args.at(++i);
+            if (name == "cmake")
+                format = CorpusFormat_CMake;
+            else if (name != "qmake")
+                ok = false;
+        }
+        else if (arg == "--sources" && has_value)
+            ok = ReadCount(args.at(++i), &parameters.Sources);
+        else if (arg == "--include-depth" && has_value)
+            ok = ReadCount(args.at(++i), &parameters.IncludeDepth);
+        else if (arg == "--scopes" && has_value)
+            ok = ReadCount(args.at(++i), &parameters.Scopes);
+        else if (arg == "--variables" && has_value)
+            ok = ReadCount(args.at(++i), &parameters.Variables);
+        else if (arg == "--subdirs" && has_value)
+            ok = ReadCount(args.at(++i), &parameters.Subdirs);
+        else if (arg == "--per-line")
+            parameters.AppendPerLine = true;
+        else
+            ok = false;
+
+        if (!ok)
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    if (output.isEmpty())
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    QList<CorpusFile> files = CorpusGenerator(parameters).Generate(format);
+    if (!CorpusGenerator::Write(output, files))
+    {
+        QTextStream(stderr) << "Unable to write corpus to " << output << "\n";
+        return 1;
+    }
+    QTextStream(stdout) << "Wrote " << files.size() << " files, project file "
+                        << QDir(output).absoluteFilePath(files.first().RelativePath) << "\n";
+    return 0;
+}
@@ -0,0 +1,255 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "corpusgenerator.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+CorpusParameters::CorpusParameters()
+{
+    this->Sources = 100;
+    this->IncludeDepth = 0;
+    this->Scopes = 0;
+    this->Variables = 0;
+    this->Subdirs = 0;
+    this->AppendPerLine = false;
+}
+
+CorpusFile::CorpusFile(QString relative_path, QString text)
+{
+    this->RelativePath = relative_path;
+    this->Text = text;
+}
+
+CorpusGenerator::CorpusGenerator(CorpusParameters parameters)
+{
+    this->Parameters = parameters;
+}
+
+QList<CorpusFile> CorpusGenerator::Generate(CorpusFormat format) const
+{
+    if (format == CorpusFormat_CMake)
+        return this->GenerateCMake();
+    return this->GenerateQMake();
+}
+
+QString CorpusGenerator::ProjectFileName(CorpusFormat format)
+{
+    if (format == CorpusFormat_CMake)
+        return "CMakeLists.txt";
+    return "corpus.pro";
+}
+
+bool CorpusGenerator::Write(QString directory, const QList<CorpusFile> &files)
+{
+    QDir root(directory);
+    foreach (const CorpusFile &corpus_file, files)
+    {
+        QString path = root.absoluteFilePath(corpus_file.RelativePath);
+        if (!QDir().mkpath(QFileInfo(path).absolutePath()))
+            return false;
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return false;
+        file.write(corpus_file.Text.toUtf8());
+        file.close();
+    }
+    return true;
+}
+
+QList<CorpusFile> CorpusGenerator::GenerateQMake() const
+{
+    QList<CorpusFile> files;
+    if (this->Parameters.Subdirs > 0)
+    {
+        QList<QString> subdirs;
+        subdirs.reserve(this->Parameters.Subdirs);
+        for (int i = 0; i < this->Parameters.Subdirs; i++)
+            subdirs.append(QString("sub%1").arg(i));
+        files.append(CorpusFile("corpus.pro", "TEMPLATE = subdirs\n" + this->QMakeList("SUBDIRS", "+=", subdirs)));
+
+        int per_subdir = this->Parameters.Sources / this->Parameters.Subdirs;
+        for (int i = 0; i < this->Parameters.Subdirs; i++)
+        {
+            int count = i == this->Parameters.Subdirs - 1 ? this->Parameters.Sources - per_subdir * i : per_subdir;
+            files.append(CorpusFile(QString("sub%1/sub%1.pro").arg(i), this->QMakeLeaf(QString("sub%1").arg(i), per_subdir * i, count)));
+        }
+    } else
+    {
+        files.append(CorpusFile("corpus.pro", this->QMakeLeaf("corpus", 0, this->Parameters.Sources)));
+    }
+
+    for (int level = 1; level <= this->Parameters.IncludeDepth; level++)
+    {
+        QString text = QString("SOURCES += $$PWD/level%1.cpp\nDEFINES += CORPUS_LEVEL_%1\n").arg(level);
+        if (level < this->Parameters.IncludeDepth)
+            text += QString("include($$PWD/level%1.pri)\n").arg(level + 1);
+        files.append(CorpusFile(QString("pri/level%1.pri").arg(level), text));
+    }
+    return files;
+}
+
+QString CorpusGenerator::QMakeLeaf(QString name, int first_source, int source_count) const
+{
+    QString text;
+    text += "TARGET = " + name + "\nTEMPLATE = app\nQT += core gui widgets\nCONFIG += c++17\n\n";
+
+    for (int i = 0; i < this->Parameters.Variables; i++)
+        text += QString("CORPUS_VAR_%1 = src/variables/var%1_a.cpp src/variables/var%1_b.cpp\n").arg(i);
+
+    QList<QString> sources;
+    QList<QString> headers;
+    sources.reserve(source_count);
+    headers.reserve(source_count);
+    for (int i = first_source; i < first_source + source_count; i++)
+    {
+        sources.append(QString("src/module%1/file%2.cpp").arg(i / 100).arg(i));
+        headers.append(QString("include/module%1/file%2.h").arg(i / 100).arg(i));
+    }
+    if (this->Parameters.AppendPerLine)
+    {
+        foreach (const QString &source, sources)
+            text += "SOURCES += " + source + "\n";
+        foreach (const QString &header, headers)
+            text += "HEADERS += " + header + "\n";
+    } else
+    {
+        text += this->QMakeList("SOURCES", "+=", sources);
+        text += this->QMakeList("HEADERS", "+=", headers);
+    }
+
+    for (int i = 0; i < this->Parameters.Variables; i++)
+        text += QString("SOURCES += $$CORPUS_VAR_%1\n").arg(i);
+
+    for (int i = 0; i < this->Parameters.Scopes; i++)
+    {
+        QString condition = this->ScopeCondition(i, CorpusFormat_QMake);
+        if (i % 2 == 0)
+        {
+            text += QString("%1 {\n    SOURCES += platform/scope%2.cpp\n    DEFINES += CORPUS_SCOPE_%2\n}\n").arg(condition).arg(i);
+        } else
+        {
+            text += QString("%1: SOURCES += platform/scope%2.cpp\n").arg(condition).arg(i);
+        }
+    }
+
+    if (this->Parameters.IncludeDepth > 0)
+        text += this->Parameters.Subdirs > 0 ? "include($$PWD/../pri/level1.pri)\n" : "include($$PWD/pri/level1.pri)\n";
+
+    text += "LIBS += -lcorpus\nQMAKE_CXXFLAGS += -Wall\n";
+    return text;
+}
+
+QString CorpusGenerator::QMakeList(QString variable, QString op, const QList<QString> &items) const
+{
+    if (items.isEmpty())
+        return "";
+    QString text = variable + " " + op;
+    foreach (const QString &item, items)
+        text += " \\\n    " + item;
+    return text + "\n";
+}
+
+QList<CorpusFile> CorpusGenerator::GenerateCMake() const
+{
+    QList<CorpusFile> files;
+    if (this->Parameters.Subdirs > 0)
+    {
+        QString text = "cmake_minimum_required(VERSION 3.16)\nproject(corpus)\n";
+        for (int i = 0; i < this->Parameters.Subdirs; i++)
+            text += QString("add_subdirectory(sub%1)\n").arg(i);
+        files.append(CorpusFile("CMakeLists.txt", text));
+
+        int per_subdir = this->Parameters.Sources / this->Parameters.Subdirs;
+        for (int i = 0; i < this->Parameters.Subdirs; i++)
+        {
+            int count = i == this->Parameters.Subdirs - 1 ? this->Parameters.Sources - per_subdir * i : per_subdir;
+            files.append(CorpusFile(QString("sub%1/CMakeLists.txt").arg(i), this->CMakeLeaf(QString("sub%1").arg(i), per_subdir * i, count)));
+        }
+        return files;
+    }
+
+    files.append(CorpusFile("CMakeLists.txt", this->CMakeLeaf("corpus", 0, this->Parameters.Sources)));
+    return files;
+}
+
+QString CorpusGenerator::CMakeLeaf(QString name, int first_source, int source_count) const
+{
+    QString text;
+    text += "cmake_minimum_required(VERSION 3.16)\nproject(" + name + ")\n\n";
+    text += "find_package(Qt6 COMPONENTS Core Gui Widgets REQUIRED)\n\n";
+
+    for (int i = 0; i < this->Parameters.Variables; i++)
+        text += QString("set(CORPUS_VAR_%1 src/variables/var%1_a.cpp src/variables/var%1_b.cpp)\n").arg(i);
+
+    text += "add_executable(" + name + " src/main.cpp)\n";
+
+    QList<QString> files;
+    files.reserve(source_count * 2);
+    for (int i = first_source; i < first_source + source_count; i++)
+    {
+        files.append(QString("src/module%1/file%2.cpp").arg(i / 100).arg(i));
+        files.append(QString("include/module%1/file%2.h").arg(i / 100).arg(i));
+    }
+    if (this->Parameters.AppendPerLine)
+    {
+        foreach (const QString &file, files)
+            text += "target_sources(" + name + " PRIVATE " + file + ")\n";
+    } else
+    {
+        text += this->CMakeList("target_sources", name, files);
+    }
+
+    for (int i = 0; i < this->Parameters.Variables; i++)
+        text += QString("target_sources(%1 PRIVATE ${CORPUS_VAR_%2})\n").arg(name).arg(i);
+
+    for (int i = 0; i < this->Parameters.Scopes; i++)
+    {
+        text += "if(" + this->ScopeCondition(i, CorpusFormat_CMake) + ")\n";
+        text += QString("    target_sources(%1 PRIVATE platform/scope%2.cpp)\n").arg(name).arg(i);
+        text += QString("    target_compile_definitions(%1 PRIVATE CORPUS_SCOPE_%2)\n").arg(name).arg(i);
+        text += "endif()\n";
+    }
+
+    // The CMake parser does not follow include(), so depth is expressed as nested blocks. Their
+    // indentation is capped, otherwise the text and not the depth would grow with the square
+    for (int level = 1; level <= this->Parameters.IncludeDepth; level++)
+    {
+        QString indent = QString(4 * qMin(level - 1, 8), ' ');
+        text += indent + QString("if(CORPUS_LEVEL_%1)\n").arg(level);
+        text += indent + QString("    target_compile_definitions(%1 PRIVATE CORPUS_LEVEL_%2)\n").arg(name).arg(level);
+    }
+    for (int level = this->Parameters.IncludeDepth; level >= 1; level--)
+        text += QString(4 * qMin(level - 1, 8), ' ') + "endif()\n";
+
+    text += "target_link_libraries(" + name + " PRIVATE Qt6::Core Qt6::Gui Qt6::Widgets corpus)\n";
+    text += "target_compile_options(" + name + " PRIVATE -Wall)\n";
+    return text;
+}
+
+QString CorpusGenerator::CMakeList(QString command, QString target, const QList<QString> &items) const
+{
+    if (items.isEmpty())
+        return "";
+    QString text = command + "(" + target + " PRIVATE\n";
+    foreach (const QString &item, items)
+        text += "    " + item + "\n";
+    return text + ")\n";
+}
+
+QString CorpusGenerator::ScopeCondition(int index, CorpusFormat format) const
+{
+    static const char *qmake_conditions[] = { "win32", "unix", "macx", "linux" };
+    static const char *cmake_conditions[] = { "WIN32", "UNIX", "APPLE", "UNIX AND NOT APPLE" };
+    if (format == CorpusFormat_CMake)
+        return cmake_conditions[index % 4];
+    return qmake_conditions[index % 4];
+}
@@ -0,0 +1,63 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef CORPUSGENERATOR_H
+#define CORPUSGENERATOR_H
+
+#include <QList>
+#include <QString>
+
+enum CorpusFormat
+{
+    CorpusFormat_QMake,
+    CorpusFormat_CMake
+};
+
+class CorpusParameters
+{
+    public:
+        CorpusParameters();
+        int Sources;        // Source files, each one also gets a matching header
+        int IncludeDepth;   // Chain of included .pri files (nested if() blocks for CMake)
+        int Scopes;         // Platform conditional scopes
+        int Variables;      // User variables that are defined and then referenced
+        int Subdirs;        // Subprojects of a subdirs project, 0 generates a single project
+        bool AppendPerLine; // One SOURCES += line per file instead of a continued list
+};
+
+class CorpusFile
+{
+    public:
+        CorpusFile(QString relative_path, QString text);
+        QString RelativePath;
+        QString Text;
+};
+
+class CorpusGenerator
+{
+    public:
+        CorpusGenerator(CorpusParameters parameters);
+        QList<CorpusFile> Generate(CorpusFormat format) const;
+        static bool Write(QString directory, const QList<CorpusFile> &files);
+        static QString ProjectFileName(CorpusFormat format);
+
+    private:
+        QList<CorpusFile> GenerateQMake() const;
+        QList<CorpusFile> GenerateCMake() const;
+        QString QMakeLeaf(QString name, int first_source, int source_count) const;
+        QString CMakeLeaf(QString name, int first_source, int source_count) const;
+        QString QMakeList(QString variable, QString op, const QList<QString> &items) const;
+        QString CMakeList(QString command, QString target, const QList<QString> &items) const;
+        QString ScopeCondition(int index, CorpusFormat format) const;
+
+        CorpusParameters Parameters;
+};
+
+#endif // CORPUSGENERATOR_H
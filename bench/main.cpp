@@ -0,0 +1,491 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <algorithm>
+#include <functional>
+#include "buildmodel.h"
+#include "cmakeparser.h"
+#include "cmakegenerator.h"
+#include "corpusgenerator.h"
+#include "memoryreport.h"
+#include "qmakegenerator.h"
+#include "qmakeparser.h"
+
+// Prevents the optimizer from discarding generated output that is never read
+static volatile qsizetype BenchSink = 0;
+
+class BenchCase
+{
+    public:
+        QString Name;
+        qint64 Bytes;
+        qint64 Lines;
+        std::function<bool()> Run;
+};
+
+class BenchResult
+{
+    public:
+        BenchResult()
+        {
+            this->Median = 0;
+            this->P95 = 0;
+            this->Bytes = 0;
+            this->Lines = 0;
+            this->Allocations = 0;
+            this->AllocatedBytes = 0;
+        }
+
+        double LinesPerSecond() const
+        {
+            if (this->Median <= 0)
+                return 0;
+            return static_cast<double>(this->Lines) * 1e9 / static_cast<double>(this->Median);
+        }
+
+        double MegabytesPerSecond() const
+        {
+            if (this->Median <= 0)
+                return 0;
+            return static_cast<double>(this->Bytes) * 1e9 / static_cast<double>(this->Median) / (1024.0 * 1024.0);
+        }
+
+        double AllocationsPerLine() const
+        {
+            return static_cast<double>(this->Allocations) / static_cast<double>(qMax<qint64>(1, this->Lines));
+        }
+
+        QString Name;
+        qint64 Median;
+        qint64 P95;
+        qint64 Bytes;
+        qint64 Lines;
+        qint64 Allocations;    // Heap allocations of a single run
+        qint64 AllocatedBytes;
+};
+
+class BenchOptions
+{
+    public:
+        BenchOptions()
+        {
+            this->Iterations = 25;
+            this->Threshold = 25;
+            this->AllocationThreshold = 10;
+        }
+
+        int Iterations;
+        double Threshold;
+        QString Filter;
+        QString BaselineFile;
+        QString SaveBaselineFile;
+        double AllocationThreshold;
+        QString AllocationBudgetFile;
+        QString SaveAllocationBudgetFile;
+};
+
+static QString ReadFile(QString path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return "";
+    QString text = QString(file.readAll());
+    file.close();
+    return text;
+}
+
+static QString Fixture(QString relative_path)
+{
+    return QDir(QString(TEST_FIXTURE_DIR)).absoluteFilePath(relative_path);
+}
+
+static qint64 CountLines(const QString &text)
+{
+    return text.count('\n') + (text.endsWith('\n') || text.isEmpty() ? 0 : 1);
+}
+
+static QString SyntheticProject(CorpusFormat format, int sources)
+{
+    CorpusParameters parameters;
+    parameters.Sources = sources;
+    parameters.Scopes = sources / 10;
+    parameters.Variables = sources / 20;
+    return CorpusGenerator(parameters).Generate(format).first().Text;
+}
+
+static void AddQMakeCases(QList<BenchCase> *cases, QString name, QString text, QString source_file)
+{
+    BuildProject parsed;
+    QMakeParser parser;
+    if (!parser.Parse(text, &parsed, source_file, "VERSION 3.16"))
+        return;
+
+    BenchCase parse_case;
+    parse_case.Name = "qmake.parse/" + name;
+    parse_case.Bytes = text.toUtf8().size();
+    parse_case.Lines = CountLines(text);
+    parse_case.Run = [text, source_file]()
+    {
+        BuildProject project;
+        QMakeParser qmake_parser;
+        return qmake_parser.Parse(text, &project, source_file, "VERSION 3.16");
+    };
+    cases->append(parse_case);
+
+    QString generated = CMakeGenerator(CMakeQtVersion_All).Generate(parsed, QList<CMakeOption>());
+    BenchCase generate_case;
+    generate_case.Name = "cmake.generate/" + name;
+    generate_case.Bytes = generated.toUtf8().size();
+    generate_case.Lines = CountLines(generated);
+    generate_case.Run = [parsed]()
+    {
+        CMakeGenerator generator(CMakeQtVersion_All);
+        BenchSink = generator.Generate(parsed, QList<CMakeOption>()).size();
+        return true;
+    };
+    cases->append(generate_case);
+}
+
+static void AddCMakeCases(QList<BenchCase> *cases, QString name, QString text, QString source_file)
+{
+    BuildProject parsed;
+    CMakeParser parser;
+    if (!parser.Parse(text, &parsed, source_file))
+        return;
+
+    BenchCase parse_case;
+    parse_case.Name = "cmake.parse/" + name;
+    parse_case.Bytes = text.toUtf8().size();
+    parse_case.Lines = CountLines(text);
+    parse_case.Run = [text, source_file]()
+    {
+        BuildProject project;
+        CMakeParser cmake_parser;
+        return cmake_parser.Parse(text, &project, source_file);
+    };
+    cases->append(parse_case);
+
+    QString generated = QMakeGenerator().Generate(parsed);
+    BenchCase generate_case;
+    generate_case.Name = "qmake.generate/" + name;
+    generate_case.Bytes = generated.toUtf8().size();
+    generate_case.Lines = CountLines(generated);
+    generate_case.Run = [parsed]()
+    {
+        QMakeGenerator generator;
+        BenchSink = generator.Generate(parsed).size();
+        return true;
+    };
+    cases->append(generate_case);
+}
+
+static QList<BenchCase> CollectCases()
+{
+    QList<BenchCase> cases;
+    QDir qmake_root(Fixture("qmake"));
+    foreach (QString directory, qmake_root.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        if (directory == "negative")
+            continue;
+        QDir fixture_dir(qmake_root.filePath(directory));
+        foreach (QString file, fixture_dir.entryList(QStringList() << "*.pro", QDir::Files))
+        {
+            QString path = fixture_dir.absoluteFilePath(file);
+            AddQMakeCases(&cases, directory, ReadFile(path), path);
+        }
+    }
+
+    QDir cmake_root(Fixture("cmake"));
+    foreach (QString directory, cmake_root.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        if (directory == "negative")
+            continue;
+        QString path = QDir(cmake_root.filePath(directory)).absoluteFilePath("CMakeLists.txt");
+        if (QFileInfo(path).exists())
+            AddCMakeCases(&cases, directory, ReadFile(path), path);
+    }
+
+    AddQMakeCases(&cases, "synthetic_1k", SyntheticProject(CorpusFormat_QMake, 1000), "synthetic/corpus.pro");
+    AddCMakeCases(&cases, "synthetic_1k", SyntheticProject(CorpusFormat_CMake, 1000), "synthetic/CMakeLists.txt");
+    return cases;
+}
+
+static qint64 Percentile(QList<qint64> samples, double percentile)
+{
+    if (samples.isEmpty())
+        return 0;
+    std::sort(samples.begin(), samples.end());
+    int index = static_cast<int>(percentile * static_cast<double>(samples.size() - 1) + 0.5);
+    return samples.at(qBound(0, index, static_cast<int>(samples.size()) - 1));
+}
+
+static BenchResult RunCase(const BenchCase &bench_case, int iterations)
+{
+    // One untimed run warms caches and lazily initialized statics, the
+    // allocations are counted in the following run so they are not included
+    bench_case.Run();
+    qint64 allocations = MemoryReport::Allocations.load();
+    qint64 allocated_bytes = MemoryReport::AllocatedBytes.load();
+    bench_case.Run();
+    allocations = MemoryReport::Allocations.load() - allocations;
+    allocated_bytes = MemoryReport::AllocatedBytes.load() - allocated_bytes;
+
+    QList<qint64> samples;
+    samples.reserve(iterations);
+    QElapsedTimer timer;
+    for (int i = 0; i < iterations; i++)
+    {
+        timer.start();
+        bench_case.Run();
+        samples.append(timer.nsecsElapsed());
+    }
+
+    BenchResult result;
+    result.Name = bench_case.Name;
+    result.Bytes = bench_case.Bytes;
+    result.Lines = bench_case.Lines;
+    result.Median = Percentile(samples, 0.5);
+    result.P95 = Percentile(samples, 0.95);
+    result.Allocations = allocations;
+    result.AllocatedBytes = allocated_bytes;
+    return result;
+}
+
+static void PrintResults(const QList<BenchResult> &results)
+{
+    QTextStream out(stdout);
+    out << QString("case").leftJustified(34) << QString("median us").rightJustified(12)
+        << QString("p95 us").rightJustified(12) << QString("lines/s").rightJustified(14)
+        << QString("MB/s").rightJustified(10) << QString("allocs/line").rightJustified(13) << "\n";
+    foreach (const BenchResult &result, results)
+    {
+        out << result.Name.leftJustified(34)
+            << QString::number(static_cast<double>(result.Median) / 1000.0, 'f', 1).rightJustified(12)
+            << QString::number(static_cast<double>(result.P95) / 1000.0, 'f', 1).rightJustified(12)
+            << QString::number(result.LinesPerSecond(), 'f', 0).rightJustified(14)
+            << QString::number(result.MegabytesPerSecond(), 'f', 2).rightJustified(10)
+            << QString::number(result.AllocationsPerLine(), 'f', 1).rightJustified(13) << "\n";
+    }
+}
+
+static bool SaveBaseline(QString path, const QList<BenchResult> &results)
+{
+    QJsonObject cases;
+    foreach (const BenchResult &result, results)
+    {
+        QJsonObject entry;
+        entry.insert("median_ns", static_cast<double>(result.Median));
+        entry.insert("p95_ns", static_cast<double>(result.P95));
+        entry.insert("lines", static_cast<double>(result.Lines));
+        entry.insert("bytes", static_cast<double>(result.Bytes));
+        cases.insert(result.Name, entry);
+    }
+    QJsonObject root;
+    root.insert("version", 1);
+    root.insert("cases", cases);
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        QTextStream(stderr) << "Unable to write baseline: " << path << "\n";
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+    file.close();
+    return true;
+}
+
+static bool CompareBaseline(QString path, const QList<BenchResult> &results, double threshold)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        QTextStream(stderr) << "Unable to read baseline: " << path << "\n";
+        return false;
+    }
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    file.close();
+    QJsonObject cases = document.object().value("cases").toObject();
+    if (cases.isEmpty())
+    {
+        QTextStream(stderr) << "Baseline has no cases: " << path << "\n";
+        return false;
+    }
+
+    bool success = true;
+    foreach (const BenchResult &result, results)
+    {
+        if (!cases.contains(result.Name))
+        {
+            QTextStream(stdout) << "NEW: " << result.Name << " has no baseline entry\n";
+            continue;
+        }
+        double baseline = cases.value(result.Name).toObject().value("median_ns").toDouble();
+        if (baseline <= 0)
+            continue;
+        double change = (static_cast<double>(result.Median) - baseline) * 100.0 / baseline;
+        QString line = result.Name + " " + QString::number(change, 'f', 1) + "% vs baseline";
+        if (change > threshold)
+        {
+            success = false;
+            QTextStream(stderr) << "REGRESSION: " << line << " (threshold " << threshold << "%)\n";
+        } else
+        {
+            QTextStream(stdout) << "OK: " << line << "\n";
+        }
+    }
+    return success;
+}
+
+static bool SaveAllocationBudget(QString path, const QList<BenchResult> &results)
+{
+    QJsonObject cases;
+    foreach (const BenchResult &result, results)
+    {
+        QJsonObject entry;
+        entry.insert("allocations", static_cast<double>(result.Allocations));
+        entry.insert("allocations_per_line", qRound(result.AllocationsPerLine() * 100.0) / 100.0);
+        entry.insert("lines", static_cast<double>(result.Lines));
+        cases.insert(result.Name, entry);
+    }
+    QJsonObject root;
+    root.insert("version", 1);
+    root.insert("cases", cases);
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        QTextStream(stderr) << "Unable to write allocation budget: " << path << "\n";
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+    file.close();
+    return true;
+}
+
+static bool CompareAllocationBudget(QString path, const QList<BenchResult> &results, double threshold)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        QTextStream(stderr) << "Unable to read allocation budget: " << path << "\n";
+        return false;
+    }
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    file.close();
+    QJsonObject cases = document.object().value("cases").toObject();
+    if (cases.isEmpty())
+    {
+        QTextStream(stderr) << "Allocation budget has no cases: " << path << "\n";
+        return false;
+    }
+
+    bool success = true;
+    foreach (const BenchResult &result, results)
+    {
+        if (!cases.contains(result.Name))
+        {
+            QTextStream(stdout) << "NEW: " << result.Name << " has no allocation budget\n";
+            continue;
+        }
+        double budget = cases.value(result.Name).toObject().value("allocations_per_line").toDouble();
+        double limit = budget * (100.0 + threshold) / 100.0;
+        QString line = result.Name + " " + QString::number(result.AllocationsPerLine(), 'f', 2)
+                       + " allocations per line, budget " + QString::number(budget, 'f', 2);
+        if (result.AllocationsPerLine() > limit)
+        {
+            success = false;
+            QTextStream(stderr) << "OVER BUDGET: " << line << " (threshold " << threshold << "%)\n";
+        } else
+        {
+            QTextStream(stdout) << "OK: " << line << "\n";
+        }
+    }
+    return success;
+}
+
+static bool ParseArguments(const QStringList &args, BenchOptions *options)
+{
+    for (int i = 1; i < args.size(); i++)
+    {
+        QString arg = args.at(i);
+        bool has_value = i + 1 < args.size();
+        if (arg == "--iterations" && has_value)
+            options->Iterations = qMax(1, args.at(++i).toInt());
+        else if (arg == "--threshold" && has_value)
+            options->Threshold = args.at(++i).toDouble();
+        else if (arg == "--filter" && has_value)
+            options->Filter = args.at(++i);
+        else if (arg == "--baseline" && has_value)
+            options->BaselineFile = args.at(++i);
+        else if (arg == "--save-baseline" && has_value)
+            options->SaveBaselineFile = args.at(++i);
+        else if (arg == "--allocation-threshold" && has_value)
+            options->AllocationThreshold = args.at(++i).toDouble();
+        else if (arg == "--allocation-budget" && has_value)
+            options->AllocationBudgetFile = args.at(++i);
+        else if (arg == "--save-allocation-budget" && has_value)
+            options->SaveAllocationBudgetFile = args.at(++i);
+        else
+        {
+            QTextStream(stderr) << "Usage: q2c_bench [--iterations N] [--filter TEXT] [--baseline FILE]"
+                                << " [--threshold PERCENT] [--save-baseline FILE] [--allocation-budget FILE]"
+                                << " [--allocation-threshold PERCENT] [--save-allocation-budget FILE]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    Q_UNUSED(app);
+
+    BenchOptions options;
+    if (!ParseArguments(QCoreApplication::arguments(), &options))
+        return 2;
+
+    QList<BenchResult> results;
+    foreach (const BenchCase &bench_case, CollectCases())
+    {
+        if (!options.Filter.isEmpty() && !bench_case.Name.contains(options.Filter))
+            continue;
+        results.append(RunCase(bench_case, options.Iterations));
+    }
+    PrintResults(results);
+
+    if (!options.SaveBaselineFile.isEmpty() && !SaveBaseline(options.SaveBaselineFile, results))
+        return 1;
+    if (!options.BaselineFile.isEmpty() && !CompareBaseline(options.BaselineFile, results, options.Threshold))
+        return 1;
+
+    if (options.AllocationBudgetFile.isEmpty() && options.SaveAllocationBudgetFile.isEmpty())
+        return 0;
+    if (!MemoryReport::Counting)
+    {
+        QTextStream(stderr) << "This build does not count allocations\n";
+        return 1;
+    }
+    if (!options.SaveAllocationBudgetFile.isEmpty() && !SaveAllocationBudget(options.SaveAllocationBudgetFile, results))
+        return 1;
+    if (!options.AllocationBudgetFile.isEmpty()
+            && !CompareAllocationBudget(options.AllocationBudgetFile, results, options.AllocationThreshold))
+        return 1;
+    return 0;
+}
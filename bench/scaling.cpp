@@ -0,0 +1,338 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+#include "buildmodel.h"
+#include "cmakeparser.h"
+#include "cmakegenerator.h"
+#include "corpusgenerator.h"
+#include "memoryreport.h"
+#include "qmakegenerator.h"
+#include "qmakeparser.h"
+
+class ScalingOptions
+{
+    public:
+        ScalingOptions()
+        {
+            this->Dimension = "sources";
+            this->MaximumExponent = 1.3;
+            this->MaximumMemoryExponent = 1.5;
+            this->Runs = 3;
+            this->Sizes << 500 << 1000 << 2000 << 4000;
+            this->Formats << CorpusFormat_QMake << CorpusFormat_CMake;
+            this->AppendPerLine = false;
+        }
+
+        QString Dimension;
+        double MaximumExponent;
+        double MaximumMemoryExponent; // Peak RSS is noisier than time, quadratic growth is still far above
+        int Runs;
+        QList<int> Sizes;
+        QList<CorpusFormat> Formats;
+        bool AppendPerLine;
+};
+
+class ScalingSample
+{
+    public:
+        int Size;
+        qint64 Lines;
+        qint64 Nanoseconds;
+        qint64 PeakKilobytes;
+};
+
+static QString FormatName(CorpusFormat format)
+{
+    return format == CorpusFormat_CMake ? "cmake" : "qmake";
+}
+
+static QString ReadFile(QString path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return "";
+    QString text = QString(file.readAll());
+    file.close();
+    return text;
+}
+
+static bool Convert(CorpusFormat format, QString path)
+{
+    QString text = ReadFile(path);
+    BuildProject project;
+    if (format == CorpusFormat_CMake)
+    {
+        CMakeParser parser;
+        if (!parser.Parse(text, &project, path))
+            return false;
+        return !QMakeGenerator().Generate(project).isEmpty();
+    }
+    QMakeParser parser;
+    if (!parser.Parse(text, &project, path, "VERSION 3.16"))
+        return false;
+    return !CMakeGenerator(CMakeQtVersion_All).Generate(project, QList<CMakeOption>()).isEmpty();
+}
+
+//! Converts the root project and the project of every subdirectory, like a user converting the whole tree
+static bool ConvertAll(CorpusFormat format, const QStringList &paths)
+{
+    foreach (const QString &path, paths)
+    {
+        if (!Convert(format, path))
+            return false;
+    }
+    return true;
+}
+
+//! The root project comes first, included .pri files are read by the parser of the project
+static QStringList ProjectPaths(QString root, const QList<CorpusFile> &files)
+{
+    QStringList paths;
+    foreach (const CorpusFile &file, files)
+    {
+        if (file.RelativePath.endsWith(".pro") || file.RelativePath.endsWith("CMakeLists.txt"))
+            paths << QDir(root).absoluteFilePath(file.RelativePath);
+    }
+    return paths;
+}
+
+static CorpusParameters ParametersFor(const ScalingOptions &options, int size)
+{
+    CorpusParameters parameters;
+    parameters.AppendPerLine = options.AppendPerLine;
+    if (options.Dimension == "sources")
+        parameters.Sources = size;
+    else if (options.Dimension == "scopes")
+        parameters.Scopes = size;
+    else if (options.Dimension == "variables")
+        parameters.Variables = size;
+    else if (options.Dimension == "subdirs")
+        parameters.Subdirs = size;
+    else if (options.Dimension == "depth")
+        parameters.IncludeDepth = size;
+    return parameters;
+}
+
+// Peak RSS only grows within a process, so every size is measured in a fresh child
+static qint64 MeasureInChild(CorpusFormat format, const QStringList &paths)
+{
+    QProcess process;
+    process.start(QCoreApplication::applicationFilePath(), QStringList() << "--measure" << FormatName(format) << paths);
+    if (!process.waitForFinished(-1) || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+        return -1;
+    return QString(process.readAllStandardOutput()).trimmed().toLongLong();
+}
+
+static bool MeasureSample(const ScalingOptions &options, CorpusFormat format, int size, QString directory, ScalingSample *sample)
+{
+    QList<CorpusFile> files = CorpusGenerator(ParametersFor(options, size)).Generate(format);
+    QString root = QDir(directory).absoluteFilePath(QString("%1_%2").arg(FormatName(format)).arg(size));
+    if (!CorpusGenerator::Write(root, files))
+        return false;
+    QStringList paths = ProjectPaths(root, files);
+
+    sample->Size = size;
+    sample->Lines = 0;
+    foreach (const CorpusFile &file, files)
+        sample->Lines += file.Text.count('\n');
+
+    QList<qint64> runs;
+    QElapsedTimer timer;
+    for (int i = 0; i < options.Runs; i++)
+    {
+        timer.start();
+        if (!ConvertAll(format, paths))
+            return false;
+        runs.append(timer.nsecsElapsed());
+    }
+    std::sort(runs.begin(), runs.end());
+    sample->Nanoseconds = runs.at(runs.size() / 2);
+    sample->PeakKilobytes = MeasureInChild(format, paths);
+    return sample->PeakKilobytes >= 0;
+}
+
+static double GrowthExponent(double small_value, double large_value, double small_size, double large_size)
+{
+    if (small_value <= 0 || large_value <= 0 || small_size <= 0 || large_size <= small_size)
+        return 0;
+    return std::log(large_value / small_value) / std::log(large_size / small_size);
+}
+
+static bool RunFormat(const ScalingOptions &options, CorpusFormat format, QString directory)
+{
+    QTextStream out(stdout);
+    ScalingSample empty;
+    if (!MeasureSample(options, format, 0, directory, &empty))
+    {
+        QTextStream(stderr) << "FAIL: " << FormatName(format) << " empty corpus did not convert\n";
+        return false;
+    }
+
+    QList<ScalingSample> samples;
+    out << FormatName(format) << " scaling by " << options.Dimension << "\n";
+    out << QString("size").rightJustified(10) << QString("lines").rightJustified(10)
+        << QString("ms").rightJustified(12) << QString("ns/line").rightJustified(12)
+        << QString("peak KB").rightJustified(12) << "\n";
+    foreach (int size, options.Sizes)
+    {
+        ScalingSample sample;
+        if (!MeasureSample(options, format, size, directory, &sample))
+        {
+            QTextStream(stderr) << "FAIL: " << FormatName(format) << " corpus of size " << size << " did not convert\n";
+            return false;
+        }
+        samples.append(sample);
+        out << QString::number(sample.Size).rightJustified(10) << QString::number(sample.Lines).rightJustified(10)
+            << QString::number(static_cast<double>(sample.Nanoseconds) / 1e6, 'f', 2).rightJustified(12)
+            << QString::number(static_cast<double>(sample.Nanoseconds) / qMax<qint64>(1, sample.Lines), 'f', 0).rightJustified(12)
+            << QString::number(sample.PeakKilobytes).rightJustified(12) << "\n";
+    }
+    if (samples.size() < 2)
+        return true;
+
+    const ScalingSample &first = samples.first();
+    const ScalingSample &last = samples.last();
+    double time_exponent = GrowthExponent(static_cast<double>(first.Nanoseconds), static_cast<double>(last.Nanoseconds),
+                                          static_cast<double>(first.Lines - empty.Lines), static_cast<double>(last.Lines - empty.Lines));
+
+    // Memory is compared above the footprint of an empty conversion and only once
+    // the growth is large enough to not be lost in allocator and page granularity
+    int memory_start = -1;
+    for (int i = 0; i < samples.size() - 1 && memory_start < 0; i++)
+    {
+        if (samples.at(i).PeakKilobytes - empty.PeakKilobytes >= 2048)
+            memory_start = i;
+    }
+    double memory_exponent = 0;
+    if (memory_start >= 0)
+    {
+        const ScalingSample &memory_first = samples.at(memory_start);
+        memory_exponent = GrowthExponent(static_cast<double>(memory_first.PeakKilobytes - empty.PeakKilobytes),
+                                         static_cast<double>(last.PeakKilobytes - empty.PeakKilobytes),
+                                         static_cast<double>(memory_first.Lines - empty.Lines),
+                                         static_cast<double>(last.Lines - empty.Lines));
+    }
+
+    bool success = true;
+    out << "time growth exponent: " << QString::number(time_exponent, 'f', 2) << "\n";
+    if (time_exponent > options.MaximumExponent)
+    {
+        QTextStream(stderr) << "FAIL: " << FormatName(format) << " time grows with exponent "
+                            << QString::number(time_exponent, 'f', 2) << ", limit " << options.MaximumExponent << "\n";
+        success = false;
+    }
+    if (memory_start < 0)
+    {
+        out << "memory growth: too small to evaluate\n";
+    } else
+    {
+        out << "memory growth exponent: " << QString::number(memory_exponent, 'f', 2) << "\n";
+        if (memory_exponent > options.MaximumMemoryExponent)
+        {
+            QTextStream(stderr) << "FAIL: " << FormatName(format) << " memory grows with exponent "
+                                << QString::number(memory_exponent, 'f', 2) << ", limit " << options.MaximumMemoryExponent << "\n";
+            success = false;
+        }
+    }
+    return success;
+}
+
+static bool ParseArguments(const QStringList &args, ScalingOptions *options)
+{
+    for (int i = 1; i < args.size(); i++)
+    {
+        QString arg = args.at(i);
+        bool has_value = i + 1 < args.size();
+        if (arg == "--dimension" && has_value)
+        {
+            options->Dimension = args.at(++i);
+            if (!(QStringList() << "sources" << "scopes" << "variables" << "subdirs" << "depth").contains(options->Dimension))
+                return false;
+        }
+        else if (arg == "--sizes" && has_value)
+        {
+            options->Sizes.clear();
+            foreach (QString size, args.at(++i).split(",", Qt::SkipEmptyParts))
+            {
+                int value = size.toInt();
+                if (value <= 0)
+                    return false;
+                options->Sizes.append(value);
+            }
+            std::sort(options->Sizes.begin(), options->Sizes.end());
+        }
+        else if (arg == "--format" && has_value)
+        {
+            QString name = args.at(++i);
+            options->Formats.clear();
+            if (name == "qmake" || name == "both")
+                options->Formats << CorpusFormat_QMake;
+            if (name == "cmake" || name == "both")
+                options->Formats << CorpusFormat_CMake;
+            if (options->Formats.isEmpty())
+                return false;
+        }
+        else if (arg == "--max-exponent" && has_value)
+            options->MaximumExponent = args.at(++i).toDouble();
+        else if (arg == "--max-memory-exponent" && has_value)
+            options->MaximumMemoryExponent = args.at(++i).toDouble();
+        else if (arg == "--runs" && has_value)
+            options->Runs = qMax(1, args.at(++i).toInt());
+        else if (arg == "--per-line")
+            options->AppendPerLine = true;
+        else
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    Q_UNUSED(app);
+
+    QStringList args = QCoreApplication::arguments();
+    if (args.size() >= 4 && args.at(1) == "--measure")
+    {
+        if (!ConvertAll(args.at(2) == "cmake" ? CorpusFormat_CMake : CorpusFormat_QMake, args.mid(3)))
+            return 1;
+        QTextStream(stdout) << MemoryReport::PeakResidentKilobytes() << "\n";
+        return 0;
+    }
+
+    ScalingOptions options;
+    if (!ParseArguments(args, &options))
+    {
+        QTextStream(stderr) << "Usage: q2c_scaling [--format qmake|cmake|both] [--dimension sources|scopes|variables|subdirs|depth]"
+                            << " [--sizes N,N,...] [--runs N] [--max-exponent X] [--max-memory-exponent X] [--per-line]\n";
+        return 2;
+    }
+
+    QTemporaryDir directory;
+    if (!directory.isValid())
+    {
+        QTextStream(stderr) << "Unable to create a temporary directory\n";
+        return 1;
+    }
+
+    bool success = true;
+    foreach (CorpusFormat format, options.Formats)
+        success = RunFormat(options, format, directory.path()) && success;
+    return success ? 0 : 1;
+}
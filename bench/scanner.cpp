@@ -0,0 +1,145 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <algorithm>
+#include "buildmodel.h"
+#include "charscanner.h"
+#include "cmakeparser.h"
+#include "corpusgenerator.h"
+#include "qmakeparser.h"
+
+class ScannerKernel
+{
+    public:
+        ScannerKernel(QString name, const char *stops, bool whitespace) : Name(name), Scanner(stops, whitespace) {}
+        QString Name;
+        CharScanner Scanner;
+};
+
+static qint64 CountStops(const CharScanner &scanner, QStringView text)
+{
+    qint64 stops = 0;
+    for (int i = scanner.Next(text, 0); i < text.size(); i = scanner.Next(text, i + 1))
+        stops++;
+    return stops;
+}
+
+static double GigabytesPerSecond(qint64 characters, qint64 nanoseconds)
+{
+    if (nanoseconds <= 0)
+        return 0;
+    return static_cast<double>(characters) * static_cast<double>(sizeof(QChar)) / static_cast<double>(nanoseconds);
+}
+
+static qint64 Median(QList<qint64> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples.at(samples.size() / 2);
+}
+
+static bool Parse(CorpusFormat format, const QString &text)
+{
+    BuildProject project;
+    if (format == CorpusFormat_CMake)
+        return CMakeParser().Parse(text, &project, "CMakeLists.txt");
+    return QMakeParser().Parse(text, &project, "corpus.pro", "VERSION 3.16");
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    Q_UNUSED(app);
+
+    int sources = 50000;
+    int runs = 5;
+    QStringList args = QCoreApplication::arguments();
+    for (int i = 1; i < args.size(); i++)
+    {
+        bool has_value = i + 1 < args.size();
+        if (args.at(i) == "--sources" && has_value)
+            sources = args.at(++i).toInt();
+        else if (args.at(i) == "--runs" && has_value)
+            runs = args.at(++i).toInt();
+        else
+            sources = -1;
+        if (sources <= 0 || runs <= 0)
+        {
+            QTextStream(stderr) << "Usage: q2c_scanner [--sources N] [--runs N]\n";
+            return 2;
+        }
+    }
+
+    QList<ScannerKernel> kernels;
+    kernels << ScannerKernel("comments", "#\"'", false)
+            << ScannerKernel("parentheses", "()\"'", false)
+            << ScannerKernel("tokens", "\"'#$>", true);
+
+    QTextStream out(stdout);
+    out << "Best supported level: " << CharScanner::LevelName(CharScanner::SupportedLevel()) << "\n";
+    CharScannerLevel supported = CharScanner::SupportedLevel();
+    bool success = true;
+    QList<CorpusFormat> formats;
+    formats << CorpusFormat_QMake << CorpusFormat_CMake;
+    foreach (CorpusFormat format, formats)
+    {
+        CorpusParameters parameters;
+        parameters.Sources = sources;
+        parameters.Scopes = sources / 100;
+        QString text = CorpusGenerator(parameters).Generate(format).first().Text;
+        out << (format == CorpusFormat_CMake ? "cmake" : "qmake") << " corpus, "
+            << QString::number(static_cast<double>(text.size()) * sizeof(QChar) / (1024 * 1024), 'f', 1) << " MiB\n";
+        out << QString("level").leftJustified(10);
+        foreach (const ScannerKernel &kernel, kernels)
+            out << QString(kernel.Name + " GB/s").rightJustified(18);
+        out << QString("parse GB/s").rightJustified(14) << "\n";
+
+        QList<qint64> expected;
+        for (int level = CharScanner_Scalar; level <= supported; level++)
+        {
+            CharScanner::SetLevel(static_cast<CharScannerLevel>(level));
+            out << CharScanner::LevelName(static_cast<CharScannerLevel>(level)).leftJustified(10);
+            for (int k = 0; k < kernels.size(); k++)
+            {
+                QList<qint64> samples;
+                qint64 stops = 0;
+                for (int run = 0; run < runs; run++)
+                {
+                    QElapsedTimer timer;
+                    timer.start();
+                    stops = CountStops(kernels.at(k).Scanner, text);
+                    samples.append(timer.nsecsElapsed());
+                }
+                if (level == CharScanner_Scalar)
+                    expected.append(stops);
+                else if (expected.at(k) != stops)
+                    success = false;
+                out << QString::number(GigabytesPerSecond(text.size(), Median(samples)), 'f', 2).rightJustified(18);
+            }
+
+            QList<qint64> samples;
+            for (int run = 0; run < runs; run++)
+            {
+                QElapsedTimer timer;
+                timer.start();
+                success = Parse(format, text) && success;
+                samples.append(timer.nsecsElapsed());
+            }
+            out << QString::number(GigabytesPerSecond(text.size(), Median(samples)), 'f', 3).rightJustified(14) << "\n";
+        }
+    }
+    CharScanner::SetLevel(supported);
+
+    if (!success)
+        QTextStream(stderr) << "FAIL: vector scanners do not agree with the scalar scanner\n";
+    return success ? 0 : 1;
+}
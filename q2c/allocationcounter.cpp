@@ -0,0 +1,126 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+// Counting allocator hook for the test and benchmark builds. Linking this file
+// into an executable replaces the process allocator, so it is never part of
+// q2c_core and release builds of q2c only get it with Q2C_COUNT_ALLOCATIONS.
+
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+#include "memoryreport.h"
+
+#if defined(__GLIBC__)
+// Qt containers allocate with malloc() directly, so on glibc the C allocator is
+// interposed; operator new ends up in malloc() and is counted there as well, the
+// aligned operator new in aligned_alloc(). glibc has no __libc_ entry point for
+// aligned_alloc() and posix_memalign(), they are served by __libc_memalign().
+extern "C"
+{
+    void *__libc_malloc(std::size_t size);
+    void *__libc_calloc(std::size_t count, std::size_t size);
+    void *__libc_realloc(void *pointer, std::size_t size);
+    void *__libc_memalign(std::size_t alignment, std::size_t size);
+
+    void *malloc(std::size_t size)
+    {
+        MemoryReport::RecordAllocation(size);
+        return __libc_malloc(size);
+    }
+
+    void *calloc(std::size_t count, std::size_t size)
+    {
+        MemoryReport::RecordAllocation(count * size);
+        return __libc_calloc(count, size);
+    }
+
+    void *realloc(void *pointer, std::size_t size)
+    {
+        MemoryReport::RecordAllocation(size);
+        return __libc_realloc(pointer, size);
+    }
+
+    void *memalign(std::size_t alignment, std::size_t size)
+    {
+        MemoryReport::RecordAllocation(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    void *aligned_alloc(std::size_t alignment, std::size_t size)
+    {
+        MemoryReport::RecordAllocation(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void **pointer, std::size_t alignment, std::size_t size)
+    {
+        if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0)
+            return EINVAL;
+        MemoryReport::RecordAllocation(size);
+        void *result = __libc_memalign(alignment, size);
+        if (result == nullptr)
+            return ENOMEM;
+        *pointer = result;
+        return 0;
+    }
+}
+#else
+// Elsewhere only C++ allocations can be replaced portably, Qt containers and the
+// aligned operator new are not counted, so budgets are only meaningful on glibc
+void *operator new(std::size_t size)
+{
+    MemoryReport::RecordAllocation(size);
+    if (size == 0)
+        size = 1;
+    while (true)
+    {
+        void *pointer = std::malloc(size);
+        if (pointer != nullptr)
+            return pointer;
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void *operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+#endif
+
+static bool EnableCounting()
+{
+    MemoryReport::Counting = true;
+    return true;
+}
+
+static bool CountingEnabled = EnableCounting();
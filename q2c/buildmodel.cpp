@@ -9,6 +9,10 @@
 //GNU General Public License for more details.
 
 #include "buildmodel.h"
+#include <QStringList>
+
+const QString BuildConfig::Release = "$<OR:$<CONFIG:Release>,$<CONFIG:RelWithDebInfo>>";
+const QString BuildConfig::Debug = "$<CONFIG:Debug>";
 
 BuildSourceLocation::BuildSourceLocation()
 {
@@ -26,8 +30,59 @@ bool BuildSourceLocation::IsValid() const
     return !this->FileName.isEmpty() && this->LineNumber > 0;
 }
 
+BuildWarning::BuildWarning()
+{
+    this->Code = BuildWarning_UnsupportedQMakeStatement;
+    this->Severity = BuildWarningSeverity_Warning;
+    this->Column = 0;
+}
+
+BuildWarning::BuildWarning(BuildWarningCode code, BuildSourceLocation location, QString message, QString suggestion)
+{
+    this->Code = code;
+    this->Severity = BuildWarning::DefaultSeverity(code);
+    this->Location = location;
+    this->Column = 0;
+    this->Message = message;
+    this->Suggestion = suggestion;
+}
+
+BuildWarningSeverity BuildWarning::DefaultSeverity(BuildWarningCode code)
+{
+    // Conversion continues after all of these, only input that is cut off is an error
+    if (code == BuildWarning_UnterminatedCMakeCommand)
+        return BuildWarningSeverity_Error;
+    return BuildWarningSeverity_Warning;
+}
+
+QString BuildWarning::CodeName() const
+{
+    return "Q2C" + QString::number(static_cast<int>(this->Code));
+}
+
+QString BuildWarning::SeverityName() const
+{
+    switch (this->Severity)
+    {
+        case BuildWarningSeverity_Note:
+            return "note";
+        case BuildWarningSeverity_Error:
+            return "error";
+        case BuildWarningSeverity_Warning:
+        default:
+            return "warning";
+    }
+}
+
+QString BuildWarning::Key() const
+{
+    return this->CodeName() + "\n" + this->Location.FileName + "\n" + QString::number(this->Location.LineNumber)
+           + "\n" + QString::number(this->Column) + "\n" + this->Message;
+}
+
 BuildConditionalScope::BuildConditionalScope()
 {
+    this->Parent = -1;
 }
 
 BuildTarget::BuildTarget()
@@ -55,6 +110,19 @@ QString BuildTarget::TypeName() const
     }
 }
 
+QString BuildTarget::ScopeCondition(int index) const
+{
+    QStringList conditions;
+    for (int i = index; i >= 0 && i < this->ConditionalScopes.size(); i = this->ConditionalScopes.at(i).Parent)
+    {
+        conditions.prepend(this->ConditionalScopes.at(i).Condition);
+        // Parents come before their children, anything else is a broken model
+        if (this->ConditionalScopes.at(i).Parent >= i)
+            break;
+    }
+    return conditions.join(" AND ");
+}
+
 BuildProject::BuildProject()
 {
     this->Clear();
@@ -67,6 +135,7 @@ void BuildProject::Clear()
     this->GlobalConfig.clear();
     this->GlobalQtModules.clear();
     this->Warnings.clear();
+    this->WarningKeys.clear();
     this->Targets.clear();
 }
 
@@ -91,8 +160,11 @@ const BuildTarget *BuildProject::PrimaryTarget() const
     return &this->Targets[0];
 }
 
-void BuildProject::AddWarning(QString warning)
+void BuildProject::AddWarning(const BuildWarning &warning)
 {
-    if (!this->Warnings.contains(warning))
-        this->Warnings.append(warning);
+    QString key = warning.Key();
+    if (this->WarningKeys.contains(key))
+        return;
+    this->WarningKeys.insert(key);
+    this->Warnings.append(warning);
 }
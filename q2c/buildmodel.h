@@ -12,6 +12,7 @@
 #define BUILDMODEL_H
 
 #include <QList>
+#include <QSet>
 #include <QString>
 
 enum BuildTargetType
@@ -24,6 +25,16 @@ enum BuildTargetType
     BuildTarget_Subdirs
 };
 
+// Generator expression conditions of the qmake build configurations, values of one
+// configuration are kept as $<condition:value>. Release covers RelWithDebInfo as well,
+// it is the optimized build that ltcg and optimize_full apply to
+class BuildConfig
+{
+    public:
+        static const QString Release;
+        static const QString Debug;
+};
+
 class BuildSourceLocation
 {
     public:
@@ -35,15 +46,66 @@ class BuildSourceLocation
         int LineNumber;
 };
 
+// Stable identifiers of conversion warnings, printed as Q2C<number>
+enum BuildWarningCode
+{
+    BuildWarning_UnsupportedQMakeStatement = 1001,
+    BuildWarning_UnreadableInclude = 1002,
+    BuildWarning_UnsupportedRegexReplace = 1003,
+    BuildWarning_UnsupportedScopedStatement = 1004,
+    BuildWarning_UnsupportedScopedVariable = 1005,
+    BuildWarning_RawCondition = 1006,
+    BuildWarning_UnusedBuildConfigValues = 1007,
+    BuildWarning_UnterminatedCMakeCommand = 2001,
+    BuildWarning_QtHelperCommand = 2002,
+    BuildWarning_PartialTargetProperties = 2003,
+    BuildWarning_UnsupportedCMakeCommand = 2004,
+    BuildWarning_PartialQmlModule = 2005,
+    BuildWarning_SourceFileProperties = 2006,
+    BuildWarning_PartialPrecompiledHeaders = 2007,
+    BuildWarning_UnknownTarget = 2008
+};
+
+enum BuildWarningSeverity
+{
+    BuildWarningSeverity_Note,
+    BuildWarningSeverity_Warning,
+    BuildWarningSeverity_Error
+};
+
+class BuildWarning
+{
+    public:
+        BuildWarning();
+        BuildWarning(BuildWarningCode code, BuildSourceLocation location, QString message, QString suggestion = "");
+        static BuildWarningSeverity DefaultSeverity(BuildWarningCode code);
+        QString CodeName() const;
+        QString SeverityName() const;
+        //! Identity used to drop repeated warnings, two records with the same key are the same warning
+        QString Key() const;
+
+        BuildWarningCode Code;
+        BuildWarningSeverity Severity;
+        BuildSourceLocation Location;
+        int Column;         // 1-based, 0 when the parser does not know the column
+        QString Message;
+        QString Suggestion; // Optional hint on how to resolve the warning by hand
+};
+
 class BuildConditionalScope
 {
     public:
         BuildConditionalScope();
 
+        //! Condition of this scope alone, a nested scope also needs the conditions of its parents
         QString Condition;
+        //! Index of the enclosing scope in the same target, -1 when the scope is not nested
+        int Parent;
         BuildSourceLocation Location;
         QList<QString> Sources;
         QList<QString> Headers;
+        QList<QString> UiFiles;
+        QList<QString> ResourceFiles;
         QList<QString> Defines;
         QList<QString> IncludePaths;
         QList<QString> Libraries;
@@ -59,6 +121,8 @@ class BuildTarget
     public:
         BuildTarget();
         QString TypeName() const;
+        //! Condition of the scope at index joined with the conditions of the scopes it is nested in
+        QString ScopeCondition(int index) const;
 
         QString Name;
         BuildTargetType Type;
@@ -75,11 +139,52 @@ class BuildTarget
         QList<QString> Libraries;
         QList<QString> CompileOptions;
         QList<QString> LinkOptions;
+        QList<QString> PrecompiledHeaders;
         QList<QString> InstallRules;
         QList<QString> Subdirectories;
         QList<BuildConditionalScope> ConditionalScopes;
 };
 
+//! A string list of BuildTarget with its field name
+class BuildTargetList
+{
+    public:
+        const char *Name;
+        QList<QString> BuildTarget::*List;
+};
+
+//! A string list of BuildConditionalScope with its field name
+class BuildScopeList
+{
+    public:
+        const char *Name;
+        QList<QString> BuildConditionalScope::*List;
+};
+
+//! Every string list of a target, for code that handles all of them alike. The
+//! model cache stores them in this order, changing it needs a new cache format
+inline constexpr BuildTargetList BuildTargetLists[] =
+{
+    { "Sources", &BuildTarget::Sources }, { "Headers", &BuildTarget::Headers }, { "UiFiles", &BuildTarget::UiFiles },
+    { "ResourceFiles", &BuildTarget::ResourceFiles }, { "TranslationFiles", &BuildTarget::TranslationFiles },
+    { "QtModules", &BuildTarget::QtModules }, { "Config", &BuildTarget::Config }, { "Defines", &BuildTarget::Defines },
+    { "IncludePaths", &BuildTarget::IncludePaths }, { "Libraries", &BuildTarget::Libraries },
+    { "CompileOptions", &BuildTarget::CompileOptions }, { "LinkOptions", &BuildTarget::LinkOptions },
+    { "PrecompiledHeaders", &BuildTarget::PrecompiledHeaders }, { "InstallRules", &BuildTarget::InstallRules },
+    { "Subdirectories", &BuildTarget::Subdirectories }
+};
+
+//! Every string list of a scope, in the order the model cache stores them
+inline constexpr BuildScopeList BuildScopeLists[] =
+{
+    { "Sources", &BuildConditionalScope::Sources }, { "Headers", &BuildConditionalScope::Headers },
+    { "UiFiles", &BuildConditionalScope::UiFiles }, { "ResourceFiles", &BuildConditionalScope::ResourceFiles },
+    { "Defines", &BuildConditionalScope::Defines }, { "IncludePaths", &BuildConditionalScope::IncludePaths },
+    { "Libraries", &BuildConditionalScope::Libraries }, { "TranslationFiles", &BuildConditionalScope::TranslationFiles },
+    { "CompileOptions", &BuildConditionalScope::CompileOptions }, { "LinkOptions", &BuildConditionalScope::LinkOptions },
+    { "InstallRules", &BuildConditionalScope::InstallRules }, { "Config", &BuildConditionalScope::Config }
+};
+
 class BuildProject
 {
     public:
@@ -88,13 +193,14 @@ class BuildProject
         BuildTarget *EnsurePrimaryTarget();
         BuildTarget *PrimaryTarget();
         const BuildTarget *PrimaryTarget() const;
-        void AddWarning(QString warning);
+        void AddWarning(const BuildWarning &warning);
 
         QString Name;
         QString CMakeMinimumVersion;
         QList<QString> GlobalConfig;
         QList<QString> GlobalQtModules;
-        QList<QString> Warnings;
+        QList<BuildWarning> Warnings;
+        QSet<QString> WarningKeys; // Keys of Warnings, kept in sync by AddWarning
         QList<BuildTarget> Targets;
 };
 
@@ -0,0 +1,196 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "charscanner.h"
+#include <algorithm>
+#include <atomic>
+
+// Vector paths rely on GCC/Clang function targets, other compilers use the scalar loop
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define Q2C_SCANNER_X86
+#include <immintrin.h>
+#endif
+
+typedef int (*ScanFunction)(const char16_t *text, int size, int from, const char16_t *stops, int stop_count, bool whitespace);
+
+static inline bool IsStop(char16_t ch, const char16_t *stops, int stop_count, bool whitespace)
+{
+    if (whitespace && (ch <= 0x20 || ch == 0xA0))
+        return true;
+    for (int i = 0; i < stop_count; i++)
+    {
+        if (ch == stops[i])
+            return true;
+    }
+    return false;
+}
+
+static int ScanScalar(const char16_t *text, int size, int from, const char16_t *stops, int stop_count, bool whitespace)
+{
+    for (int i = from; i < size; i++)
+    {
+        if (IsStop(text[i], stops, stop_count, whitespace))
+            return i;
+    }
+    return size;
+}
+
+#ifdef Q2C_SCANNER_X86
+__attribute__((target("sse2")))
+static int ScanSSE2(const char16_t *text, int size, int from, const char16_t *stops, int stop_count, bool whitespace)
+{
+    // Stops are often only a few characters apart, those are found before the vectors are set up
+    int i = from;
+    for (int end = std::min(size, from + 8); i < end; i++)
+    {
+        if (IsStop(text[i], stops, stop_count, whitespace))
+            return i;
+    }
+
+    __m128i stop_vectors[8];
+    for (int k = 0; k < stop_count; k++)
+        stop_vectors[k] = _mm_set1_epi16(static_cast<short>(stops[k]));
+    // There is no unsigned 16-bit compare in SSE2, flipping the sign bit turns
+    // ch <= 0x20 into a signed compare against 0x8021
+    const __m128i sign = _mm_set1_epi16(static_cast<short>(0x8000));
+    const __m128i space_limit = _mm_set1_epi16(static_cast<short>(0x8021));
+    const __m128i nbsp = _mm_set1_epi16(0xA0);
+
+    for (; i + 8 <= size; i += 8)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i));
+        __m128i hits = _mm_setzero_si128();
+        for (int k = 0; k < stop_count; k++)
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi16(chunk, stop_vectors[k]));
+        if (whitespace)
+        {
+            hits = _mm_or_si128(hits, _mm_cmplt_epi16(_mm_xor_si128(chunk, sign), space_limit));
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi16(chunk, nbsp));
+        }
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hits));
+        if (mask != 0)
+            return i + __builtin_ctz(mask) / 2;
+    }
+    return ScanScalar(text, size, i, stops, stop_count, whitespace);
+}
+
+__attribute__((target("avx2")))
+static int ScanAVX2(const char16_t *text, int size, int from, const char16_t *stops, int stop_count, bool whitespace)
+{
+    int i = from;
+    for (int end = std::min(size, from + 8); i < end; i++)
+    {
+        if (IsStop(text[i], stops, stop_count, whitespace))
+            return i;
+    }
+
+    __m256i stop_vectors[8];
+    for (int k = 0; k < stop_count; k++)
+        stop_vectors[k] = _mm256_set1_epi16(static_cast<short>(stops[k]));
+    const __m256i sign = _mm256_set1_epi16(static_cast<short>(0x8000));
+    const __m256i space_limit = _mm256_set1_epi16(static_cast<short>(0x8021));
+    const __m256i nbsp = _mm256_set1_epi16(0xA0);
+
+    for (; i + 16 <= size; i += 16)
+    {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + i));
+        __m256i hits = _mm256_setzero_si256();
+        for (int k = 0; k < stop_count; k++)
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi16(chunk, stop_vectors[k]));
+        if (whitespace)
+        {
+            hits = _mm256_or_si256(hits, _mm256_cmpgt_epi16(space_limit, _mm256_xor_si256(chunk, sign)));
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi16(chunk, nbsp));
+        }
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hits));
+        if (mask != 0)
+            return i + __builtin_ctz(mask) / 2;
+    }
+    // The tail still gets one SSE2 step before the scalar loop
+    return ScanSSE2(text, size, i, stops, stop_count, whitespace);
+}
+#endif
+
+static ScanFunction ScanFunctionFor(CharScannerLevel level)
+{
+#ifdef Q2C_SCANNER_X86
+    if (level == CharScanner_AVX2)
+        return ScanAVX2;
+    if (level == CharScanner_SSE2)
+        return ScanSSE2;
+#else
+    Q_UNUSED(level);
+#endif
+    return ScanScalar;
+}
+
+static std::atomic<int> CurrentLevel(-1);
+static std::atomic<ScanFunction> CurrentScan(nullptr);
+
+CharScanner::CharScanner(const char *stops, bool whitespace)
+{
+    this->StopCount = 0;
+    this->Whitespace = whitespace;
+    for (const char *stop = stops; *stop != '\0' && this->StopCount < 8; stop++)
+        this->Stops[this->StopCount++] = static_cast<char16_t>(static_cast<unsigned char>(*stop));
+    for (int i = this->StopCount; i < 8; i++)
+        this->Stops[i] = 0;
+}
+
+int CharScanner::Next(QStringView text, int from) const
+{
+    ScanFunction scan = CurrentScan.load(std::memory_order_relaxed);
+    if (scan == nullptr)
+    {
+        CharScanner::SetLevel(CharScanner::SupportedLevel());
+        scan = CurrentScan.load(std::memory_order_relaxed);
+    }
+    return scan(text.utf16(), static_cast<int>(text.size()), from, this->Stops, this->StopCount, this->Whitespace);
+}
+
+CharScannerLevel CharScanner::SupportedLevel()
+{
+#ifdef Q2C_SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return CharScanner_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return CharScanner_SSE2;
+#endif
+    return CharScanner_Scalar;
+}
+
+void CharScanner::SetLevel(CharScannerLevel level)
+{
+    if (level > CharScanner::SupportedLevel())
+        level = CharScanner::SupportedLevel();
+    CurrentLevel.store(level, std::memory_order_relaxed);
+    CurrentScan.store(ScanFunctionFor(level), std::memory_order_relaxed);
+}
+
+CharScannerLevel CharScanner::Level()
+{
+    if (CurrentLevel.load(std::memory_order_relaxed) < 0)
+        CharScanner::SetLevel(CharScanner::SupportedLevel());
+    return static_cast<CharScannerLevel>(CurrentLevel.load(std::memory_order_relaxed));
+}
+
+QString CharScanner::LevelName(CharScannerLevel level)
+{
+    switch (level)
+    {
+        case CharScanner_AVX2:
+            return "avx2";
+        case CharScanner_SSE2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
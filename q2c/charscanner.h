@@ -0,0 +1,49 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef CHARSCANNER_H
+#define CHARSCANNER_H
+
+#include <QString>
+#include <QStringView>
+
+enum CharScannerLevel
+{
+    CharScanner_Scalar,
+    CharScanner_SSE2,  // 8 characters per step
+    CharScanner_AVX2   // 16 characters per step
+};
+
+//! Finds the next structurally significant character (quotes, comments, parentheses
+//! and so on) so that the lexers only look at those, the rest of a line is skipped
+//! in blocks using the widest instruction set the CPU supports
+class CharScanner
+{
+    public:
+        //! Stops at every ASCII character of stops (at most 8) and, when whitespace is set,
+        //! at every character up to a space and at U+00A0. Callers classify the character
+        //! at the returned position themselves, a control character is not whitespace
+        CharScanner(const char *stops, bool whitespace = false);
+        //! Position of the first stop at or after from, or the size of text if there is none
+        int Next(QStringView text, int from) const;
+        //! Best level the running CPU supports
+        static CharScannerLevel SupportedLevel();
+        //! Level used by Next(), it starts at SupportedLevel() and can not be raised above it
+        static void SetLevel(CharScannerLevel level);
+        static CharScannerLevel Level();
+        static QString LevelName(CharScannerLevel level);
+
+    private:
+        char16_t Stops[8];
+        int StopCount;
+        bool Whitespace;
+};
+
+#endif // CHARSCANNER_H
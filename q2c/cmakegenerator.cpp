@@ -12,18 +12,100 @@
 #include "generic.h"
 #include <QDateTime>
 
-static QString CMakeQuote(QString value)
+static void AppendCMakeQuoted(QString *result, const QString &value)
 {
-    if (value.contains(" ") || value.contains(";"))
-        return "\"" + value + "\"";
-    return value;
+    if (value.contains(' ') || value.contains(';'))
+    {
+        *result += '"';
+        *result += value;
+        *result += '"';
+    } else
+    {
+        *result += value;
+    }
+}
+
+static const QString ProfileGuidedOptimizationOption = "PGO";
+static const QString CompilerLauncherOption = "USE_COMPILER_LAUNCHER";
+static const QString FastLinkerOption = "USE_FAST_LINKER";
+static const QString SplitDwarfOption = "USE_SPLIT_DWARF";
+static const QString LinkJobsOption = "LIMIT_LINK_JOBS";
+
+static bool HasOption(const QList<CMakeOption> &options, const QString &name)
+{
+    foreach (const CMakeOption &option, options)
+    {
+        if (option.Name == name)
+            return true;
+    }
+    return false;
+}
+
+// Splits the files wrapped in a build configuration off to config_files, the others go to plain
+// only when there was something to split so the common case does not copy the list
+static bool SplitBuildConfigFiles(const QList<QString> &files, QList<QString> *plain, QList<QString> *config_files)
+{
+    static const QString prefix = "$<";
+    bool has_config = false;
+    for (const QString &file : files)
+        has_config = has_config || file.startsWith(prefix);
+    if (!has_config)
+        return false;
+    for (const QString &file : files)
+    {
+        if (file.startsWith(prefix))
+            config_files->append(file);
+        else
+            plain->append(file);
+    }
+    return true;
+}
+
+static QString CMakeQuote(const QString &value)
+{
+    QString result;
+    AppendCMakeQuoted(&result, value);
+    return result;
+}
+
+static void AppendCMakeIndentedList(QString *result, const QList<QString> &values, const QString &indent)
+{
+    foreach (const QString &value, values)
+    {
+        *result += indent;
+        AppendCMakeQuoted(result, value);
+        *result += '\n';
+    }
 }
 
 static QString CMakeIndentedList(const QList<QString> &values)
 {
     QString result;
-    foreach (QString value, values)
-        result += "    " + CMakeQuote(value) + "\n";
+    AppendCMakeIndentedList(&result, values, "    ");
+    return result;
+}
+
+//! Wraps commands that need a newer CMake than the project asks for in a version check
+static QString CMakeRequireVersion(const QString &cmake_minimum, int major, int minor, const QString &commands)
+{
+    QStringList version = cmake_minimum.mid(cmake_minimum.indexOf(' ') + 1).split('.');
+    int minimum_major = version.value(0).toInt();
+    int minimum_minor = version.value(1).toInt();
+    if (minimum_major > major || (minimum_major == major && minimum_minor >= minor))
+        return commands;
+    QString result = QString("if(NOT CMAKE_VERSION VERSION_LESS %1.%2)\n").arg(major).arg(minor);
+    result += Generic::Indent(commands);
+    result += "endif()\n";
+    return result;
+}
+
+static QString CMakeScopedTargetSources(const QString &target_name, const QList<QString> &files)
+{
+    if (files.isEmpty())
+        return "";
+    QString result = "    target_sources(" + target_name + " PRIVATE\n";
+    AppendCMakeIndentedList(&result, files, "        ");
+    result += "    )\n";
     return result;
 }
 
@@ -32,21 +114,54 @@ CMakeGenerator::CMakeGenerator(CMakeQtVersion version)
     this->Version = version;
 }
 
+void CMakeGenerator::SetMinimumVersion(const QString &version)
+{
+    this->MinimumVersion = version;
+}
+
+void CMakeGenerator::SetUnityPlan(const UnityPlan &plan)
+{
+    this->Unity = plan;
+}
+
+QList<CMakeOption> CMakeGenerator::ProfileGuidedOptimizationOptions()
+{
+    QList<CMakeOption> options;
+    options << CMakeOption(ProfileGuidedOptimizationOption, "Profile guided optimization: OFF, instrument or use", "OFF",
+                           "STRING", QStringList() << "OFF" << "instrument" << "use");
+    // Empty falls back to a directory in the build tree, see GenerateProfileGuidedOptimization()
+    options << CMakeOption("PGO_PROFILE_DIR", "Directory the instrumented build writes its profiles to", "", "PATH");
+    return options;
+}
+
+QList<CMakeOption> CMakeGenerator::BuildAccelerationOptions()
+{
+    QList<CMakeOption> options;
+    options << CMakeOption(CompilerLauncherOption, "Compile through ccache or sccache when one is installed", "ON");
+    options << CMakeOption(FastLinkerOption, "Link with mold, or lld when building with Clang, if the compiler accepts it", "ON");
+    options << CMakeOption(SplitDwarfOption, "Write the debug info of Debug and RelWithDebInfo builds to .dwo files", "ON");
+    options << CMakeOption(LinkJobsOption, "Let Ninja run one link per 2 GB of memory at once", "ON");
+    return options;
+}
+
 QString CMakeGenerator::Generate(const BuildProject &project, const QList<CMakeOption> &options)
 {
     const BuildTarget *target = project.PrimaryTarget();
     QString target_name = target != nullptr ? target->Name : project.Name;
-    QString cmake_minimum = project.CMakeMinimumVersion.isEmpty() ? "VERSION 3.1.0" : project.CMakeMinimumVersion;
+    QString cmake_minimum = !this->MinimumVersion.isEmpty() ? this->MinimumVersion : project.CMakeMinimumVersion;
+    if (cmake_minimum.isEmpty())
+        cmake_minimum = "VERSION 3.1.0";
 
     QString source = "#-----------------------------------------------------------------\n";
     source += "# Project converted from qmake file using q2c\n";
     source += "# https://github.com/benapetr/q2c at " + QDateTime::currentDateTime().toString() + "\n";
     source += "#-----------------------------------------------------------------\n";
-    foreach (QString warning, project.Warnings)
-        source += "# q2c warning: " + warning + "\n";
+    foreach (const BuildWarning &warning, project.Warnings)
+        source += "# q2c warning: " + warning.Message + "\n";
     source += "cmake_minimum_required (" + cmake_minimum + ")\n";
     source += "project(" + target_name + ")\n";
     source += this->GenerateOptions(options);
+    source += this->GenerateBuildAcceleration(options, cmake_minimum);
 
     if (target != nullptr && target->Type == BuildTarget_Subdirs)
     {
@@ -59,14 +174,22 @@ QString CMakeGenerator::Generate(const BuildProject &project, const QList<CMakeO
 
     source += this->GenerateConfigOptions(*target);
 
-    if (!target->Sources.isEmpty())
-        source += this->GenerateFileSet(target_name + "_SOURCES", target->Sources);
-    if (!target->Headers.isEmpty())
-        source += this->GenerateFileSet(target_name + "_HEADERS", target->Headers);
-    if (!target->UiFiles.isEmpty())
-        source += this->GenerateFileSet(target_name + "_UI_FILES", target->UiFiles);
-    if (!target->ResourceFiles.isEmpty())
-        source += this->GenerateFileSet(target_name + "_RESOURCE_FILES", target->ResourceFiles);
+    // Files of one build configuration are added with target_sources() on their own, the
+    // file sets are also given to the Qt 4 wrapping commands that take plain paths only
+    QList<QString> config_files, plain_sources, plain_headers, plain_ui_files, plain_resource_files;
+    const QList<QString> &sources = SplitBuildConfigFiles(target->Sources, &plain_sources, &config_files) ? plain_sources : target->Sources;
+    const QList<QString> &headers = SplitBuildConfigFiles(target->Headers, &plain_headers, &config_files) ? plain_headers : target->Headers;
+    const QList<QString> &ui_files = SplitBuildConfigFiles(target->UiFiles, &plain_ui_files, &config_files) ? plain_ui_files : target->UiFiles;
+    const QList<QString> &resource_files = SplitBuildConfigFiles(target->ResourceFiles, &plain_resource_files, &config_files)
+                                           ? plain_resource_files : target->ResourceFiles;
+    if (!sources.isEmpty())
+        source += this->GenerateFileSet(target_name + "_SOURCES", sources);
+    if (!headers.isEmpty())
+        source += this->GenerateFileSet(target_name + "_HEADERS", headers);
+    if (!ui_files.isEmpty())
+        source += this->GenerateFileSet(target_name + "_UI_FILES", ui_files);
+    if (!resource_files.isEmpty())
+        source += this->GenerateFileSet(target_name + "_RESOURCE_FILES", resource_files);
 
     source += this->GenerateDefaultQtLibs(*target);
     source += this->GenerateQtAutomation(*target);
@@ -78,15 +201,21 @@ QString CMakeGenerator::Generate(const BuildProject &project, const QList<CMakeO
     else
         source += "add_executable(" + target_name;
 
-    if (!target->Sources.isEmpty())
+    if (!sources.isEmpty())
         source += " ${" + target_name + "_SOURCES}";
-    if (!target->Headers.isEmpty())
+    if (!headers.isEmpty())
         source += " ${" + target_name + "_HEADERS}";
-    if (!target->UiFiles.isEmpty())
+    if (!ui_files.isEmpty())
         source += " ${" + target_name + "_UI_FILES}";
-    if (!target->ResourceFiles.isEmpty())
+    if (!resource_files.isEmpty())
         source += " ${" + target_name + "_RESOURCE_FILES}";
     source += ")\n";
+    if (!config_files.isEmpty())
+    {
+        source += "target_sources(" + target_name + " PRIVATE\n";
+        source += CMakeIndentedList(config_files);
+        source += ")\n";
+    }
 
     if (!target->Headers.isEmpty() && this->Version == CMakeQtVersion_Qt4)
         source += "target_sources(" + target_name + " PRIVATE ${" + target_name + "_HEADERS_MOC})\n";
@@ -100,13 +229,18 @@ QString CMakeGenerator::Generate(const BuildProject &project, const QList<CMakeO
 
     source += this->GenerateDefines(*target);
     source += this->GenerateIncludePaths(*target);
+    source += this->GeneratePrecompiledHeaders(*target, cmake_minimum);
+    source += this->GenerateUnityBuild(*target, cmake_minimum);
     source += this->GenerateConditionalScopes(*target);
     source += this->GenerateUIFiles(*target);
     source += this->GenerateResources(*target);
     source += this->GenerateTranslations(*target);
     source += this->GenerateLibraries(*target);
+    source += this->GenerateOptimization(*target);
     source += this->GenerateCompileOptions(*target);
     source += this->GenerateLinkOptions(*target);
+    if (HasOption(options, ProfileGuidedOptimizationOption))
+        source += this->GenerateProfileGuidedOptimization(*target);
     source += this->GenerateInstallRules(*target);
     source += this->GenerateQtModules(*target);
 
@@ -117,15 +251,87 @@ QString CMakeGenerator::GenerateOptions(const QList<CMakeOption> &options)
 {
     QString result;
     foreach (CMakeOption option, options)
-        result += "option(" + option.Name + " \"" + option.Description + "\" " + option.Default + ")\n";
+    {
+        if (option.Type.isEmpty())
+        {
+            result += "option(" + option.Name + " \"" + option.Description + "\" " + option.Default + ")\n";
+            continue;
+        }
+        result += "set(" + option.Name + " \"" + option.Default + "\" CACHE " + option.Type + " \"" + option.Description + "\")\n";
+        if (!option.Values.isEmpty())
+            result += "set_property(CACHE " + option.Name + " PROPERTY STRINGS " + option.Values.join(" ") + ")\n";
+    }
     return result;
 }
 
-QString CMakeGenerator::GenerateFileSet(QString variable, const QList<QString> &files)
+QString CMakeGenerator::GenerateBuildAcceleration(const QList<CMakeOption> &options, const QString &cmake_minimum)
+{
+    // Everything here sets defaults that targets pick up when they are created, so it comes before
+    // any target and reaches the targets of subdirectories as well
+    QString result;
+    if (HasOption(options, CompilerLauncherOption))
+    {
+        // CMAKE_<LANG>_COMPILER_LAUNCHER is new in CMake 3.4, a launcher given on the command line wins
+        QString launcher = "if(" + CompilerLauncherOption + " AND NOT CMAKE_CXX_COMPILER_LAUNCHER)\n";
+        launcher += "    find_program(COMPILER_LAUNCHER NAMES ccache sccache)\n";
+        launcher += "    if(COMPILER_LAUNCHER)\n";
+        launcher += "        set(CMAKE_C_COMPILER_LAUNCHER \"${COMPILER_LAUNCHER}\")\n";
+        launcher += "        set(CMAKE_CXX_COMPILER_LAUNCHER \"${COMPILER_LAUNCHER}\")\n";
+        launcher += "    endif()\n";
+        launcher += "endif()\n";
+        result += CMakeRequireVersion(cmake_minimum, 3, 4, launcher);
+    }
+    if (HasOption(options, FastLinkerOption))
+    {
+        // lld can not link the LTO objects of GCC, so GCC only switches to mold. LINKER_TYPE
+        // is new in CMake 3.29, older versions pass -fuse-ld themselves
+        QString linker = "if(" + FastLinkerOption + " AND CMAKE_CXX_COMPILER_ID MATCHES \"GNU|Clang\" AND NOT APPLE AND NOT WIN32)\n";
+        linker += "    include(CheckLinkerFlag)\n";
+        linker += "    check_linker_flag(CXX -fuse-ld=mold HAVE_LINKER_MOLD)\n";
+        linker += "    if(HAVE_LINKER_MOLD)\n";
+        linker += "        set(FAST_LINKER mold)\n";
+        linker += "    elseif(CMAKE_CXX_COMPILER_ID MATCHES \"Clang\")\n";
+        linker += "        check_linker_flag(CXX -fuse-ld=lld HAVE_LINKER_LLD)\n";
+        linker += "        if(HAVE_LINKER_LLD)\n";
+        linker += "            set(FAST_LINKER lld)\n";
+        linker += "        endif()\n";
+        linker += "    endif()\n";
+        linker += "    if(FAST_LINKER AND CMAKE_VERSION VERSION_LESS 3.29)\n";
+        linker += "        add_link_options(-fuse-ld=${FAST_LINKER})\n";
+        linker += "    elseif(FAST_LINKER)\n";
+        linker += "        string(TOUPPER ${FAST_LINKER} CMAKE_LINKER_TYPE)\n";
+        linker += "    endif()\n";
+        linker += "endif()\n";
+        // check_linker_flag() is new in CMake 3.18
+        result += CMakeRequireVersion(cmake_minimum, 3, 18, linker);
+    }
+    if (HasOption(options, SplitDwarfOption))
+    {
+        result += "if(" + SplitDwarfOption + " AND CMAKE_CXX_COMPILER_ID MATCHES \"GNU|Clang\" AND NOT APPLE AND NOT WIN32)\n";
+        result += "    add_compile_options($<$<OR:$<CONFIG:Debug>,$<CONFIG:RelWithDebInfo>>:-gsplit-dwarf>)\n";
+        result += "endif()\n";
+    }
+    if (HasOption(options, LinkJobsOption))
+    {
+        // Links need far more memory than compiles, running as many of them as compiles swaps
+        result += "if(" + LinkJobsOption + " AND CMAKE_GENERATOR MATCHES \"Ninja\")\n";
+        result += "    cmake_host_system_information(RESULT HOST_MEMORY QUERY TOTAL_PHYSICAL_MEMORY)\n";
+        result += "    math(EXPR LINK_JOBS \"${HOST_MEMORY} / 2048\")\n";
+        result += "    if(LINK_JOBS LESS 1)\n";
+        result += "        set(LINK_JOBS 1)\n";
+        result += "    endif()\n";
+        result += "    set_property(GLOBAL APPEND PROPERTY JOB_POOLS link_jobs=${LINK_JOBS})\n";
+        result += "    set(CMAKE_JOB_POOL_LINK link_jobs)\n";
+        result += "endif()\n";
+    }
+    return result;
+}
+
+QString CMakeGenerator::GenerateFileSet(const QString &variable, const QList<QString> &files)
 {
     QString result;
     result += "set(" + variable + "\n";
-    result += CMakeIndentedList(files);
+    AppendCMakeIndentedList(&result, files, "    ");
     result += ")\n";
     return result;
 }
@@ -144,7 +350,7 @@ QString CMakeGenerator::GenerateSubdirs(const BuildProject &project, const Build
     }
 
     result += "# Add all subprojects\n";
-    foreach (QString subdir, target.Subdirectories)
+    foreach (const QString &subdir, target.Subdirectories)
         result += "add_subdirectory(" + subdir + ")\n";
     return result;
 }
@@ -152,26 +358,23 @@ QString CMakeGenerator::GenerateSubdirs(const BuildProject &project, const Build
 QString CMakeGenerator::GenerateConditionalScopes(const BuildTarget &target)
 {
     QString result;
-    foreach (const BuildConditionalScope &block, target.ConditionalScopes)
+    for (int index = 0; index < target.ConditionalScopes.size(); index++)
     {
+        const BuildConditionalScope &block = target.ConditionalScopes.at(index);
         if (block.Condition.isEmpty())
             continue;
 
-        result += "\nif(" + block.Condition + ")\n";
-        if (!block.Sources.isEmpty())
-        {
-            result += "    target_sources(" + target.Name + " PRIVATE\n";
-            foreach (const QString &source, block.Sources)
-                result += "        " + CMakeQuote(source) + "\n";
-            result += "    )\n";
-        }
-        if (!block.Headers.isEmpty())
-        {
-            result += "    target_sources(" + target.Name + " PRIVATE\n";
-            foreach (const QString &header, block.Headers)
-                result += "        " + CMakeQuote(header) + "\n";
-            result += "    )\n";
-        }
+        // Nested scopes of a CMake input are written with the conditions of their parents
+        QString nested_condition;
+        if (block.Parent >= 0)
+            nested_condition = target.ScopeCondition(index);
+        const QString &condition = block.Parent >= 0 ? nested_condition : block.Condition;
+        result += "\nif(" + condition + ")\n";
+        result += CMakeScopedTargetSources(target.Name, block.Sources);
+        result += CMakeScopedTargetSources(target.Name, block.Headers);
+        // AUTOUIC and AUTORCC pick scoped forms and resources up from the target sources
+        result += CMakeScopedTargetSources(target.Name, block.UiFiles);
+        result += CMakeScopedTargetSources(target.Name, block.ResourceFiles);
         foreach (const QString &define, block.Defines)
             result += "    target_compile_definitions(" + target.Name + " PRIVATE " + define + ")\n";
         foreach (const QString &include, block.IncludePaths)
@@ -257,7 +460,7 @@ QString CMakeGenerator::GenerateTranslations(const BuildTarget &target)
 
     result += "\n# Translation files\n";
     result += "set(" + target.Name + "_TRANSLATIONS";
-    foreach (QString translation, target.TranslationFiles)
+    foreach (const QString &translation, target.TranslationFiles)
         result += " \"" + translation + "\"";
     result += ")\n";
     if (this->Version == CMakeQtVersion_Qt6 || this->Version == CMakeQtVersion_Qt5)
@@ -268,7 +471,7 @@ QString CMakeGenerator::GenerateTranslations(const BuildTarget &target)
 QString CMakeGenerator::GenerateConfigOptions(const BuildTarget &target)
 {
     QString result;
-    foreach (QString config, target.Config)
+    foreach (const QString &config, target.Config)
     {
         if (config == "c++11")
             result += "set(CMAKE_CXX_STANDARD 11)\n";
@@ -276,10 +479,47 @@ QString CMakeGenerator::GenerateConfigOptions(const BuildTarget &target)
             result += "set(CMAKE_CXX_STANDARD 14)\n";
         else if (config == "c++17")
             result += "set(CMAKE_CXX_STANDARD 17)\n";
+        else if (config == "c++20")
+            result += "set(CMAKE_CXX_STANDARD 20)\n";
+        else if (config == "c++2b")
+            result += "set(CMAKE_CXX_STANDARD 23)\n";
+        else if (config == "strict_c++")
+            result += "set(CMAKE_CXX_EXTENSIONS OFF)\n";
         else if (config == "debug")
             result += "set(CMAKE_BUILD_TYPE Debug)\n";
         else if (config == "release")
             result += "set(CMAKE_BUILD_TYPE Release)\n";
+        else if (config == "ltcg")
+        {
+            // qmake only enables link time code generation for release builds. The policy has to be set
+            // before the target is created, otherwise older minimum versions only use it with Intel compilers
+            result += "if(POLICY CMP0069)\n";
+            result += "    cmake_policy(SET CMP0069 NEW)\n";
+            result += "    include(CheckIPOSupported)\n";
+            result += "    check_ipo_supported(RESULT IPO_SUPPORTED)\n";
+            result += "    if(IPO_SUPPORTED)\n";
+            result += "        set(CMAKE_INTERPROCEDURAL_OPTIMIZATION_RELEASE ON)\n";
+            result += "        set(CMAKE_INTERPROCEDURAL_OPTIMIZATION_RELWITHDEBINFO ON)\n";
+            result += "    endif()\n";
+            result += "endif()\n";
+        }
+    }
+    return result;
+}
+
+QString CMakeGenerator::GenerateOptimization(const BuildTarget &target)
+{
+    // optimize_full and optimize_size replace the optimization level of release builds,
+    // MSVC already builds them with /O2 so only optimize_size changes it there
+    const QString &release = BuildConfig::Release;
+    static const QString msvc = "$<CXX_COMPILER_ID:MSVC>";
+    QString result;
+    if (target.Config.contains("optimize_full"))
+        result += "target_compile_options(" + target.Name + " PRIVATE $<$<AND:" + release + ",$<NOT:" + msvc + ">>:-O3>)\n";
+    if (target.Config.contains("optimize_size"))
+    {
+        result += "target_compile_options(" + target.Name + " PRIVATE $<$<AND:" + release + ",$<NOT:" + msvc + ">>:-Os>)\n";
+        result += "target_compile_options(" + target.Name + " PRIVATE $<$<AND:" + release + "," + msvc + ">:/O1>)\n";
     }
     return result;
 }
@@ -308,6 +548,41 @@ QString CMakeGenerator::GenerateIncludePaths(const BuildTarget &target)
     return result;
 }
 
+QString CMakeGenerator::GeneratePrecompiledHeaders(const BuildTarget &target, const QString &cmake_minimum)
+{
+    if (target.PrecompiledHeaders.isEmpty())
+        return "";
+
+    QString headers = "target_precompile_headers(" + target.Name + " PRIVATE\n";
+    headers += CMakeIndentedList(target.PrecompiledHeaders);
+    headers += ")\n";
+    // target_precompile_headers() is new in CMake 3.16, older versions build without the header
+    return CMakeRequireVersion(cmake_minimum, 3, 16, headers);
+}
+
+QString CMakeGenerator::GenerateUnityBuild(const BuildTarget &target, const QString &cmake_minimum)
+{
+    if (this->Unity.IsEmpty() || this->Unity.Target != target.Name)
+        return "";
+
+    QString commands = "set_target_properties(" + target.Name + " PROPERTIES UNITY_BUILD ON UNITY_BUILD_MODE GROUP)\n";
+    foreach (const UnityBatch &batch, this->Unity.Batches)
+    {
+        commands += "set_source_files_properties(\n";
+        commands += CMakeIndentedList(batch.Sources);
+        commands += "    PROPERTIES UNITY_GROUP " + batch.Name + "\n)\n";
+    }
+    if (!this->Unity.Excluded.isEmpty())
+    {
+        commands += "set_source_files_properties(\n";
+        commands += CMakeIndentedList(this->Unity.Excluded);
+        commands += "    PROPERTIES SKIP_UNITY_BUILD_INCLUSION ON\n)\n";
+    }
+    // UNITY_BUILD_MODE GROUP is new in CMake 3.18, older versions build every source on its own
+    return "\n# Unity build batches of sources that do not share file local names\n"
+           + CMakeRequireVersion(cmake_minimum, 3, 18, commands);
+}
+
 QString CMakeGenerator::GenerateLibraries(const BuildTarget &target)
 {
     QString result;
@@ -333,7 +608,7 @@ QString CMakeGenerator::GenerateLibraries(const BuildTarget &target)
 QString CMakeGenerator::GenerateCompileOptions(const BuildTarget &target)
 {
     QString result;
-    foreach (QString option, target.CompileOptions)
+    foreach (const QString &option, target.CompileOptions)
         result += "target_compile_options(" + target.Name + " PRIVATE " + option + ")\n";
     return result;
 }
@@ -341,15 +616,53 @@ QString CMakeGenerator::GenerateCompileOptions(const BuildTarget &target)
 QString CMakeGenerator::GenerateLinkOptions(const BuildTarget &target)
 {
     QString result;
-    foreach (QString option, target.LinkOptions)
+    foreach (const QString &option, target.LinkOptions)
         result += "target_link_options(" + target.Name + " PRIVATE " + option + ")\n";
     return result;
 }
 
+QString CMakeGenerator::GenerateProfileGuidedOptimization(const BuildTarget &target)
+{
+    // GCC reads the .gcda files straight from the profile directory, Clang writes .profraw
+    // files there that llvm-profdata has to merge into one .profdata file before use
+    QString name = target.Name;
+    QString result;
+    result += "# Profile guided optimization: build with -DPGO=instrument and run a representative workload,\n";
+    result += "# with Clang build the " + name + "_pgo_merge target, then rebuild with -DPGO=use\n";
+    result += "if(NOT PGO_PROFILE_DIR)\n";
+    result += "    set(PGO_PROFILE_DIR \"${CMAKE_BINARY_DIR}/pgo\")\n";
+    result += "endif()\n";
+    result += "if(NOT PGO STREQUAL \"OFF\" AND NOT CMAKE_CXX_COMPILER_ID MATCHES \"GNU|Clang\")\n";
+    result += "    message(WARNING \"PGO=${PGO} needs GCC or Clang, " + name + " is built without profiles\")\n";
+    result += "elseif(PGO STREQUAL \"instrument\")\n";
+    // Counters of threads that run at the same time are lost without atomic updates in GCC
+    result += "    target_compile_options(" + name + " PRIVATE -fprofile-generate=${PGO_PROFILE_DIR} $<$<CXX_COMPILER_ID:GNU>:-fprofile-update=atomic>)\n";
+    result += "    target_link_options(" + name + " PRIVATE -fprofile-generate=${PGO_PROFILE_DIR})\n";
+    result += "elseif(PGO STREQUAL \"use\" AND CMAKE_CXX_COMPILER_ID MATCHES \"Clang\")\n";
+    result += "    target_compile_options(" + name + " PRIVATE -fprofile-use=${PGO_PROFILE_DIR}.profdata)\n";
+    result += "    target_link_options(" + name + " PRIVATE -fprofile-use=${PGO_PROFILE_DIR}.profdata)\n";
+    result += "elseif(PGO STREQUAL \"use\")\n";
+    // Code the workload did not reach keeps the regular optimization instead of being optimized for size
+    result += "    target_compile_options(" + name + " PRIVATE -fprofile-use=${PGO_PROFILE_DIR} -fprofile-partial-training -Wno-missing-profile)\n";
+    result += "    target_link_options(" + name + " PRIVATE -fprofile-use=${PGO_PROFILE_DIR})\n";
+    result += "endif()\n";
+    result += "if(CMAKE_CXX_COMPILER_ID MATCHES \"Clang\")\n";
+    result += "    get_filename_component(PGO_COMPILER_DIR \"${CMAKE_CXX_COMPILER}\" DIRECTORY)\n";
+    result += "    find_program(LLVM_PROFDATA NAMES llvm-profdata HINTS \"${PGO_COMPILER_DIR}\")\n";
+    result += "    if(LLVM_PROFDATA)\n";
+    result += "        add_custom_target(" + name + "_pgo_merge\n";
+    result += "            COMMAND \"${LLVM_PROFDATA}\" merge -output=${PGO_PROFILE_DIR}.profdata ${PGO_PROFILE_DIR}\n";
+    result += "            COMMENT \"Merging the profiles in ${PGO_PROFILE_DIR}\"\n";
+    result += "            VERBATIM)\n";
+    result += "    endif()\n";
+    result += "endif()\n";
+    return result;
+}
+
 QString CMakeGenerator::GenerateInstallRules(const BuildTarget &target)
 {
     QString result;
-    foreach (QString rule, target.InstallRules)
+    foreach (const QString &rule, target.InstallRules)
         result += "# qmake INSTALLS entry: " + rule + "\n";
     return result;
 }
@@ -359,7 +672,9 @@ QString CMakeGenerator::GenerateDefaultQtLibs(const BuildTarget &target)
     QString result;
     bool has_cxx_standard = target.Config.contains("c++11") ||
                             target.Config.contains("c++14") ||
-                            target.Config.contains("c++17");
+                            target.Config.contains("c++17") ||
+                            target.Config.contains("c++20") ||
+                            target.Config.contains("c++2b");
     if (!has_cxx_standard)
     {
         if (this->Version == CMakeQtVersion_Qt6)
@@ -438,7 +753,7 @@ QString CMakeGenerator::GenerateQt5Libs(const BuildTarget &target)
     if (modules.isEmpty())
         modules << "core";
 
-    foreach (QString module, modules)
+    foreach (const QString &module, modules)
         components += " " + this->QtComponentName(module);
     return "find_package(Qt5 " + components + " REQUIRED)\n\n";
 }
@@ -450,7 +765,7 @@ QString CMakeGenerator::GenerateQt6Libs(const BuildTarget &target)
     if (modules.isEmpty())
         modules << "core";
 
-    foreach (QString module, modules)
+    foreach (const QString &module, modules)
         components += " " + this->QtComponentName(module);
     return "find_package(Qt6 " + components + " REQUIRED)\n\n";
 }
@@ -464,14 +779,14 @@ QString CMakeGenerator::GenerateQtModules(const BuildTarget &target)
     if (this->Version == CMakeQtVersion_Qt6)
     {
         result += "target_link_libraries(" + target.Name + " PRIVATE";
-        foreach (QString module, target.QtModules)
+        foreach (const QString &module, target.QtModules)
             result += " Qt6::" + this->QtTargetName(module);
         result += ")\n";
     }
     else if (this->Version == CMakeQtVersion_Qt5)
     {
         result += "target_link_libraries(" + target.Name + " PRIVATE";
-        foreach (QString module, target.QtModules)
+        foreach (const QString &module, target.QtModules)
             result += " Qt5::" + this->QtTargetName(module);
         result += ")\n";
     }
@@ -479,7 +794,7 @@ QString CMakeGenerator::GenerateQtModules(const BuildTarget &target)
     {
         result += "IF (QT5BUILD)\n";
         result += Generic::Indent("target_link_libraries(" + target.Name + " PRIVATE");
-        foreach (QString module, target.QtModules)
+        foreach (const QString &module, target.QtModules)
             result += " Qt5::" + this->QtTargetName(module);
         result += ")\n";
         result += "ELSE()\n";
@@ -489,7 +804,7 @@ QString CMakeGenerator::GenerateQtModules(const BuildTarget &target)
     return result;
 }
 
-QString CMakeGenerator::QtComponentName(QString module) const
+QString CMakeGenerator::QtComponentName(const QString &module) const
 {
     if (this->Version == CMakeQtVersion_Qt6 && module == "webkit")
         return "WebEngineCore";
@@ -502,7 +817,7 @@ QString CMakeGenerator::QtComponentName(QString module) const
     return Generic::CapitalFirst(module);
 }
 
-QString CMakeGenerator::QtTargetName(QString module) const
+QString CMakeGenerator::QtTargetName(const QString &module) const
 {
     return this->QtComponentName(module);
 }
@@ -513,3 +828,12 @@ CMakeOption::CMakeOption(QString name, QString description, QString __default)
     this->Description = description;
     this->Default = __default;
 }
+
+CMakeOption::CMakeOption(QString name, QString description, QString __default, QString type, QStringList values)
+{
+    this->Name = name;
+    this->Description = description;
+    this->Default = __default;
+    this->Type = type;
+    this->Values = values;
+}
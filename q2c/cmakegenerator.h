@@ -13,7 +13,9 @@
 
 #include <QList>
 #include <QString>
+#include <QStringList>
 #include "buildmodel.h"
+#include "unityplanner.h"
 
 enum CMakeQtVersion
 {
@@ -27,9 +29,13 @@ class CMakeOption
 {
     public:
         CMakeOption(QString name, QString description, QString __default);
+        //! Cache variable of the given type instead of a boolean option(), values become its STRINGS property
+        CMakeOption(QString name, QString description, QString __default, QString type, QStringList values = QStringList());
         QString Name;
         QString Description;
         QString Default;
+        QString Type;        // Empty for option(), otherwise the cache type such as STRING or PATH
+        QStringList Values;  // Choices offered by cmake-gui and ccmake
 };
 
 class CMakeGenerator
@@ -37,10 +43,19 @@ class CMakeGenerator
     public:
         CMakeGenerator(CMakeQtVersion version);
         QString Generate(const BuildProject &project, const QList<CMakeOption> &options);
+        //! Uses this cmake_minimum_required() argument instead of the one stored in the project
+        void SetMinimumVersion(const QString &version);
+        //! Puts the sources of the planned target into these unity batches
+        void SetUnityPlan(const UnityPlan &plan);
+        //! Options that select profile guided optimization, Generate() instruments or optimizes the target when given them
+        static QList<CMakeOption> ProfileGuidedOptimizationOptions();
+        //! Options of the build acceleration block, Generate() emits the part of every option it is given
+        static QList<CMakeOption> BuildAccelerationOptions();
 
     private:
         QString GenerateOptions(const QList<CMakeOption> &options);
-        QString GenerateFileSet(QString variable, const QList<QString> &files);
+        QString GenerateBuildAcceleration(const QList<CMakeOption> &options, const QString &cmake_minimum);
+        QString GenerateFileSet(const QString &variable, const QList<QString> &files);
         QString GenerateDefaultQtLibs(const BuildTarget &target);
         QString GenerateQt4Libs();
         QString GenerateQt5Libs(const BuildTarget &target);
@@ -48,21 +63,27 @@ class CMakeGenerator
         QString GenerateQtAutomation(const BuildTarget &target);
         QString GenerateQtModules(const BuildTarget &target);
         QString GenerateConfigOptions(const BuildTarget &target);
+        QString GenerateOptimization(const BuildTarget &target);
         QString GenerateDefines(const BuildTarget &target);
         QString GenerateIncludePaths(const BuildTarget &target);
+        QString GeneratePrecompiledHeaders(const BuildTarget &target, const QString &cmake_minimum);
+        QString GenerateUnityBuild(const BuildTarget &target, const QString &cmake_minimum);
         QString GenerateLibraries(const BuildTarget &target);
         QString GenerateCompileOptions(const BuildTarget &target);
         QString GenerateLinkOptions(const BuildTarget &target);
+        QString GenerateProfileGuidedOptimization(const BuildTarget &target);
         QString GenerateUIFiles(const BuildTarget &target);
         QString GenerateResources(const BuildTarget &target);
         QString GenerateTranslations(const BuildTarget &target);
         QString GenerateInstallRules(const BuildTarget &target);
         QString GenerateSubdirs(const BuildProject &project, const BuildTarget &target);
         QString GenerateConditionalScopes(const BuildTarget &target);
-        QString QtComponentName(QString module) const;
-        QString QtTargetName(QString module) const;
+        QString QtComponentName(const QString &module) const;
+        QString QtTargetName(const QString &module) const;
 
         CMakeQtVersion Version;
+        QString MinimumVersion;
+        UnityPlan Unity;
 };
 
 #endif // CMAKEGENERATOR_H
@@ -9,27 +9,90 @@
 //GNU General Public License for more details.
 
 #include "cmakeparser.h"
+#include "charscanner.h"
 #include "logs.h"
 #include <QFileInfo>
 #include <QRegularExpression>
+#include <QSet>
+#include <algorithm>
+
+CMakeCommand::CMakeCommand()
+{
+    this->FirstToken = 0;
+    this->TokenCount = 0;
+    this->Line = 0;
+}
+
+CMakeCommandHandler::CMakeCommandHandler()
+{
+    this->Builtin = nullptr;
+    this->Callback = nullptr;
+    this->Hits = 0;
+}
+
+// File inside $<condition:file> when the condition is a build configuration, empty otherwise
+static QString BuildConfigFile(const QString &item)
+{
+    static const QStringList prefixes = { "$<" + BuildConfig::Release + ":", "$<" + BuildConfig::Debug + ":", "$<$<CONFIG:Release>:" };
+    if (!item.endsWith('>'))
+        return "";
+    foreach (const QString &prefix, prefixes)
+    {
+        if (item.startsWith(prefix, Qt::CaseInsensitive))
+            return item.mid(prefix.size(), item.size() - prefix.size() - 1);
+    }
+    return "";
+}
 
 CMakeParser::CMakeParser()
 {
     this->Model = nullptr;
+    const QHash<QString, CMakeBuiltinHandler> &builtins = CMakeParser::BuiltinHandlers();
+    for (QHash<QString, CMakeBuiltinHandler>::const_iterator it = builtins.constBegin(); it != builtins.constEnd(); ++it)
+    {
+        CMakeCommandHandler handler;
+        handler.Builtin = it.value();
+        this->Handlers.insert(it.key(), handler);
+    }
 }
 
-bool CMakeParser::Parse(QString text, BuildProject *model, QString source_file)
+bool CMakeParser::Parse(const QString &text, BuildProject *model, const QString &source_file)
 {
     this->Model = model;
     this->SourceFile = source_file;
     this->Variables.clear();
+    this->ExternalTargets.clear();
     this->ConditionStack.clear();
+    this->ScopeStack.clear();
+    this->UnsupportedCommands.clear();
+    this->UnsupportedLines.clear();
+    for (QHash<QString, CMakeCommandHandler>::iterator it = this->Handlers.begin(); it != this->Handlers.end(); ++it)
+        it->Hits = 0;
     this->Model->Clear();
     this->Model->CMakeMinimumVersion = "VERSION 3.1.0";
 
     QList<CMakeCommand> commands = this->ParseCommands(text);
-    foreach (const CMakeCommand &command, commands)
-        this->ProcessCommand(command);
+    for (int i = 0; i < commands.size(); i++)
+        this->ProcessCommand(commands[i]);
+    this->Tokens.clear();
+    this->FlushUnsupportedCommands();
+    for (int i = 0; i < this->Model->Targets.size(); i++)
+    {
+        BuildTarget *target = &this->Model->Targets[i];
+        this->RemoveDuplicates(target);
+        if (target->PrecompiledHeaders.size() > 1)
+        {
+            int line_number = target->Location.LineNumber;
+            this->AddWarning(BuildWarning_PartialPrecompiledHeaders, line_number, "qmake supports one precompiled header, " + target->Name
+                             + " defined at line " + QString::number(line_number) + " also lists: " + target->PrecompiledHeaders.mid(1).join(" "),
+                             "Include the other headers from " + target->PrecompiledHeaders.first() + " to precompile them with qmake");
+        }
+    }
+    if (Logs::DebugEnabled(2))
+    {
+        foreach (const CMakeCommandStat &stat, this->GetCommandStats())
+            Q2C_DEBUG_LOG(2, "cmake", this->SourceFile, 0, stat.Name + ": " + QString::number(stat.Hits) + (stat.Supported ? "" : " (unsupported)"));
+    }
 
     if (this->Model->Name.isEmpty())
     {
@@ -40,29 +103,49 @@ bool CMakeParser::Parse(QString text, BuildProject *model, QString source_file)
     return true;
 }
 
-QList<CMakeCommand> CMakeParser::ParseCommands(QString text)
+QList<CMakeCommand> CMakeParser::ParseCommands(const QString &text)
 {
+    // Commands and their arguments are kept as offsets into text, the arguments
+    // are copied out only when ProcessCommand() finds a handler for the command
+    static const CharScanner paren_scanner("()\"'");
     QList<CMakeCommand> commands;
-    QString buffer;
+    QStringView source(text);
+    this->Tokens.clear();
     int paren_depth = 0;
     int start_line = 0;
-    QStringList lines = text.split("\n");
+    int start = -1;
+    int open = -1;
+    int close = -1;
+    int line_number = 0;
+    int line_start = 0;
 
-    for (int i = 0; i < lines.size(); i++)
+    while (line_start <= source.size())
     {
-        QString line = this->StripComment(lines[i]).trimmed();
+        int line_end = source.indexOf('\n', line_start);
+        if (line_end < 0)
+            line_end = source.size();
+        QStringView line = this->StripComment(source.mid(line_start, line_end - line_start)).trimmed();
+        line_start = line_end + 1;
+        line_number++;
         if (line.isEmpty())
             continue;
 
-        if (buffer.isEmpty())
-            start_line = i + 1;
-        buffer += line + "\n";
+        int offset = static_cast<int>(line.data() - source.data());
+        if (start < 0)
+        {
+            start = offset;
+            start_line = line_number;
+        }
 
         bool in_quote = false;
         QChar quote_char;
-        for (int j = 0; j < line.length(); j++)
+        for (int j = paren_scanner.Next(line, 0); j < line.length(); j = paren_scanner.Next(line, j + 1))
         {
             QChar ch = line[j];
+            if (ch == '(' && open < 0)
+                open = offset + j;
+            else if (ch == ')')
+                close = offset + j;
             if ((ch == '"' || ch == '\'') && (j == 0 || line[j - 1] != '\\'))
             {
                 if (in_quote && ch == quote_char)
@@ -82,32 +165,36 @@ QList<CMakeCommand> CMakeParser::ParseCommands(QString text)
                 paren_depth--;
         }
 
-        if (paren_depth == 0 && buffer.contains("("))
+        if (paren_depth == 0 && open >= 0)
         {
-            int open = buffer.indexOf("(");
-            int close = buffer.lastIndexOf(")");
-            if (open > 0 && close > open)
+            if (open > start && close > open)
             {
                 CMakeCommand command;
-                command.Name = buffer.left(open).trimmed().toLower();
-                command.Arguments = this->TokenizeArguments(buffer.mid(open + 1, close - open - 1));
+                command.Name = source.mid(start, open - start).trimmed().toString().toLower();
+                command.FirstToken = this->Tokens.size();
+                this->TokenizeArguments(source.mid(open + 1, close - open - 1), &this->Tokens);
+                command.TokenCount = this->Tokens.size() - command.FirstToken;
                 command.Line = start_line;
-                commands.append(command);
+                commands.append(std::move(command));
             }
-            buffer.clear();
+            start = -1;
+            open = -1;
+            close = -1;
         }
     }
 
-    if (!buffer.trimmed().isEmpty())
-        this->AddWarning("Unterminated CMake command near line " + QString::number(start_line));
+    if (start >= 0)
+        this->AddWarning(BuildWarning_UnterminatedCMakeCommand, start_line, "Unterminated CMake command near line " + QString::number(start_line),
+                         "Close the command with a matching ')'");
     return commands;
 }
 
-QString CMakeParser::StripComment(QString line)
+QStringView CMakeParser::StripComment(QStringView line) const
 {
+    static const CharScanner scanner("#\"'");
     bool in_quote = false;
     QChar quote_char;
-    for (int i = 0; i < line.length(); i++)
+    for (int i = scanner.Next(line, 0); i < line.length(); i = scanner.Next(line, i + 1))
     {
         QChar ch = line[i];
         if ((ch == '"' || ch == '\'') && (i == 0 || line[i - 1] != '\\'))
@@ -128,16 +215,28 @@ QString CMakeParser::StripComment(QString line)
     return line;
 }
 
-QStringList CMakeParser::TokenizeArguments(QString text)
+void CMakeParser::TokenizeArguments(QStringView text, QList<TokenView> *tokens) const
 {
-    QStringList tokens;
-    QString current;
+    static const CharScanner scanner("\"'#$>", true);
     bool in_quote = false;
+    bool quoted = false;
+    bool has_value = false;
     QChar quote_char;
     int bracket_depth = 0;
+    int start = -1;
 
     for (int i = 0; i < text.length(); i++)
     {
+        int next = scanner.Next(text, i);
+        if (next > i)
+        {
+            if (start < 0)
+                start = i;
+            has_value = true;
+            i = next;
+            if (i == text.length())
+                break;
+        }
         QChar ch = text[i];
         if ((ch == '"' || ch == '\'') && (i == 0 || text[i - 1] != '\\'))
         {
@@ -148,8 +247,18 @@ QStringList CMakeParser::TokenizeArguments(QString text)
                 in_quote = true;
                 quote_char = ch;
             }
+            if (start < 0)
+                start = i;
+            quoted = true;
             continue;
         }
+        // Arguments of a command spanning several lines still carry the comments
+        if (ch == '#' && !in_quote && bracket_depth == 0)
+        {
+            int line_end = text.indexOf('\n', i);
+            i = line_end < 0 ? text.length() : line_end;
+            ch = '\n';
+        }
         if (!in_quote && ch == '$' && i + 1 < text.length() && text[i + 1] == '<')
             bracket_depth++;
         else if (!in_quote && ch == '>' && bracket_depth > 0)
@@ -157,23 +266,24 @@ QStringList CMakeParser::TokenizeArguments(QString text)
 
         if (ch.isSpace() && !in_quote && bracket_depth == 0)
         {
-            if (!current.isEmpty())
-            {
-                tokens.append(current);
-                current.clear();
-            }
+            if (has_value)
+                tokens->append(TokenView(text.mid(start, i - start), quoted));
+            start = -1;
+            quoted = false;
+            has_value = false;
             continue;
         }
-        current += ch;
+        if (start < 0)
+            start = i;
+        has_value = true;
     }
-    if (!current.isEmpty())
-        tokens.append(current);
-    return tokens;
+    if (has_value)
+        tokens->append(TokenView(text.mid(start), quoted));
 }
 
 QString CMakeParser::ExpandVariables(QString text)
 {
-    QRegularExpression variable("\\$\\{([^}]+)\\}");
+    static const QRegularExpression variable("\\$\\{([^}]+)\\}");
     QRegularExpressionMatchIterator it = variable.globalMatch(text);
     while (it.hasNext())
     {
@@ -185,236 +295,577 @@ QString CMakeParser::ExpandVariables(QString text)
     return text;
 }
 
-void CMakeParser::ProcessCommand(const CMakeCommand &command)
+const QHash<QString, CMakeBuiltinHandler> &CMakeParser::BuiltinHandlers()
 {
-    QString name = command.Name;
-    QStringList args = command.Arguments;
-    if (name == "if")
+    static const QHash<QString, CMakeBuiltinHandler> handlers =
     {
-        this->ConditionStack.append(this->NormalizeCondition(args));
-        return;
+        { "if", &CMakeParser::CommandIf },
+        { "else", &CMakeParser::CommandElse },
+        { "endif", &CMakeParser::CommandEndif },
+        { "cmake_minimum_required", &CMakeParser::CommandMinimumRequired },
+        { "project", &CMakeParser::CommandProject },
+        { "set", &CMakeParser::CommandSet },
+        { "find_package", &CMakeParser::CommandFindPackage },
+        { "add_executable", &CMakeParser::CommandAddExecutable },
+        { "qt_add_executable", &CMakeParser::CommandAddExecutable },
+        { "add_library", &CMakeParser::CommandAddLibrary },
+        { "qt_add_library", &CMakeParser::CommandAddLibrary },
+        { "add_subdirectory", &CMakeParser::CommandAddSubdirectory },
+        { "target_sources", &CMakeParser::CommandTargetSources },
+        { "target_link_libraries", &CMakeParser::CommandTargetLinkLibraries },
+        { "target_include_directories", &CMakeParser::CommandTargetIncludeDirectories },
+        { "target_compile_definitions", &CMakeParser::CommandTargetCompileDefinitions },
+        { "target_compile_options", &CMakeParser::CommandTargetCompileOptions },
+        { "target_link_options", &CMakeParser::CommandTargetLinkOptions },
+        { "target_link_directories", &CMakeParser::CommandTargetLinkDirectories },
+        { "target_precompile_headers", &CMakeParser::CommandTargetPrecompileHeaders },
+        { "qt_wrap_cpp", &CMakeParser::CommandQtHelper },
+        { "qt5_wrap_cpp", &CMakeParser::CommandQtHelper },
+        { "qt6_wrap_cpp", &CMakeParser::CommandQtHelper },
+        { "qt_add_resources", &CMakeParser::CommandQtHelper },
+        { "qt5_add_resources", &CMakeParser::CommandQtHelper },
+        { "qt6_add_resources", &CMakeParser::CommandQtHelper },
+        { "qt_add_translations", &CMakeParser::CommandQtAddTranslations },
+        { "qt_add_qml_module", &CMakeParser::CommandQtAddQmlModule },
+        { "set_target_properties", &CMakeParser::CommandSetTargetProperties },
+        { "set_property", &CMakeParser::CommandSetProperty },
+        { "set_source_files_properties", &CMakeParser::CommandSetSourceFilesProperties }
+    };
+    return handlers;
+}
+
+void CMakeParser::RegisterCommand(const QString &name, CMakeCommandCallback callback)
+{
+    CMakeCommandHandler handler;
+    handler.Callback = callback;
+    this->Handlers.insert(name.toLower(), handler);
+}
+
+QList<CMakeCommandStat> CMakeParser::GetCommandStats() const
+{
+    QList<CMakeCommandStat> stats;
+    for (QHash<QString, CMakeCommandHandler>::const_iterator it = this->Handlers.constBegin(); it != this->Handlers.constEnd(); ++it)
+    {
+        if (it.value().Hits == 0)
+            continue;
+        CMakeCommandStat stat;
+        stat.Name = it.key();
+        stat.Hits = it.value().Hits;
+        stat.Supported = true;
+        stats.append(stat);
     }
-    if (name == "else")
+    foreach (const QString &name, this->UnsupportedCommands)
     {
-        QString previous = this->ConditionStack.isEmpty() ? QString("FALSE") : this->ConditionStack.takeLast();
-        this->ConditionStack.append("NOT " + previous);
-        return;
+        CMakeCommandStat stat;
+        stat.Name = name;
+        stat.Hits = this->UnsupportedLines.value(name).size();
+        stat.Supported = false;
+        stats.append(stat);
     }
-    if (name == "endif")
+    std::sort(stats.begin(), stats.end(), [](const CMakeCommandStat &a, const CMakeCommandStat &b) { return a.Name < b.Name; });
+    return stats;
+}
+
+void CMakeParser::ProcessCommand(CMakeCommand &command)
+{
+    QHash<QString, CMakeCommandHandler>::iterator handler = this->Handlers.find(command.Name);
+    if (handler == this->Handlers.end())
     {
-        if (!this->ConditionStack.isEmpty())
-            this->ConditionStack.removeLast();
+        if (!this->UnsupportedLines.contains(command.Name))
+            this->UnsupportedCommands.append(command.Name);
+        this->UnsupportedLines[command.Name].append(command.Line);
         return;
     }
-    if (name == "cmake_minimum_required")
+
+    handler->Hits++;
+    command.Arguments.reserve(command.TokenCount);
+    for (int i = command.FirstToken; i < command.FirstToken + command.TokenCount; i++)
+        command.Arguments.append(this->Tokens.at(i).ToString());
+    if (handler->Callback != nullptr)
     {
-        if (!args.isEmpty())
-            this->Model->CMakeMinimumVersion = args.join(" ");
+        handler->Callback(command, this->Model);
         return;
     }
-    if (name == "project")
+    QStringList args = std::move(command.Arguments);
+    (this->*handler->Builtin)(command, args);
+}
+
+void CMakeParser::FlushUnsupportedCommands()
+{
+    // One warning per command name, a project that uses add_custom_command fifty
+    // times needs the same manual port as one that uses it once
+    foreach (const QString &name, this->UnsupportedCommands)
     {
-        if (!args.isEmpty())
-            this->Model->Name = args.first();
+        const QList<int> &lines = this->UnsupportedLines[name];
+        QString message = "Unsupported CMake command at line " + QString::number(lines.first()) + ": " + name;
+        if (lines.size() > 1)
+        {
+            QStringList other_lines;
+            for (int i = 1; i < lines.size(); i++)
+                other_lines << QString::number(lines.at(i));
+            message += " (" + QString::number(lines.size()) + " uses, also at lines " + other_lines.join(", ") + ")";
+        }
+        this->AddWarning(BuildWarning_UnsupportedCMakeCommand, lines.first(), message, "Port " + name + " to the generated project by hand");
+    }
+}
+
+void CMakeParser::CommandIf(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    this->ConditionStack.append(this->NormalizeCondition(args));
+    this->ScopeStack.append(QHash<QString, int>());
+}
+
+void CMakeParser::CommandElse(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    Q_UNUSED(args);
+    QString previous = this->ConditionStack.isEmpty() ? QString("FALSE") : this->ConditionStack.takeLast();
+    this->ConditionStack.append("NOT " + previous);
+    // Scopes of the if() branch do not hold in the else() branch
+    if (this->ScopeStack.isEmpty())
+        this->ScopeStack.append(QHash<QString, int>());
+    else
+        this->ScopeStack.last().clear();
+}
+
+void CMakeParser::CommandEndif(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    Q_UNUSED(args);
+    if (!this->ConditionStack.isEmpty())
+        this->ConditionStack.removeLast();
+    if (!this->ScopeStack.isEmpty())
+        this->ScopeStack.removeLast();
+}
+
+void CMakeParser::CommandMinimumRequired(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    if (!args.isEmpty())
+        this->Model->CMakeMinimumVersion = args.join(" ");
+}
+
+void CMakeParser::CommandProject(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    if (!args.isEmpty())
+        this->Model->Name = args.first();
+}
+
+void CMakeParser::CommandSet(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    if (args.isEmpty())
+        return;
+    QString variable = args.takeFirst();
+    this->Variables.insert(variable, args);
+}
+
+void CMakeParser::CommandFindPackage(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    if (args.isEmpty())
+        return;
+    QString package = args.first();
+    if (package != "Qt4" && package != "Qt5" && package != "Qt6" && package != "Qt")
+        return;
+    int components = args.indexOf("COMPONENTS");
+    if (components < 0)
         return;
+    for (int i = components + 1; i < args.size(); i++)
+    {
+        if (args[i] == "REQUIRED" || args[i] == "OPTIONAL_COMPONENTS")
+            break;
+        this->AddUnique(&this->Model->GlobalQtModules, args[i].toLower());
     }
-    if (name == "set")
+}
+
+void CMakeParser::CommandAddExecutable(const CMakeCommand &command, QStringList &args)
+{
+    if (args.isEmpty())
+        return;
+    QString target_name = args.takeFirst();
+    // Imported and alias targets name something built elsewhere, there is nothing to convert
+    if (args.contains("IMPORTED") || args.contains("ALIAS"))
     {
-        if (args.isEmpty())
-            return;
-        QString variable = args.takeFirst();
-        this->Variables.insert(variable, args);
+        this->ExternalTargets.insert(target_name);
         return;
     }
-    if (name == "find_package")
+    BuildTarget *target = this->FindOrCreateTarget(target_name, BuildTarget_Application);
+    target->Location = BuildSourceLocation(this->SourceFile, command.Line);
+    this->ProcessTargetFiles(target, args);
+}
+
+void CMakeParser::CommandAddLibrary(const CMakeCommand &command, QStringList &args)
+{
+    static const QSet<QString> library_kinds = { "STATIC", "SHARED", "MODULE", "OBJECT", "INTERFACE" };
+    if (args.isEmpty())
+        return;
+    QString target_name = args.takeFirst();
+    // Imported and alias targets name something built elsewhere, there is nothing to convert
+    if (args.contains("IMPORTED") || args.contains("ALIAS"))
     {
-        if (args.isEmpty())
-            return;
-        QString package = args.first();
-        if (package == "Qt4" || package == "Qt5" || package == "Qt6" || package == "Qt")
-        {
-            int components = args.indexOf("COMPONENTS");
-            if (components >= 0)
-            {
-                for (int i = components + 1; i < args.size(); i++)
-                {
-                    if (args[i] == "REQUIRED" || args[i] == "OPTIONAL_COMPONENTS")
-                        break;
-                    this->AddUnique(&this->Model->GlobalQtModules, args[i].toLower());
-                }
-            }
-        }
+        this->ExternalTargets.insert(target_name);
         return;
     }
-    if (name == "add_executable" || name == "qt_add_executable")
+    BuildTargetType target_type = args.contains("MODULE") ? BuildTarget_Plugin : BuildTarget_Library;
+    BuildTarget *target = this->FindOrCreateTarget(target_name, target_type);
+    target->Location = BuildSourceLocation(this->SourceFile, command.Line);
+    // The kind keyword comes before the sources, e.g. add_library(foo STATIC foo.cpp)
+    while (!args.isEmpty() && library_kinds.contains(args.first()))
+        args.removeFirst();
+    this->ProcessTargetFiles(target, args);
+}
+
+void CMakeParser::CommandAddSubdirectory(const CMakeCommand &command, QStringList &args)
+{
+    if (args.isEmpty())
+        return;
+    BuildTarget *target = this->Model->EnsurePrimaryTarget();
+    if (target->Name.isEmpty())
     {
-        if (args.isEmpty())
-            return;
-        QString target_name = args.takeFirst();
-        BuildTarget *target = this->FindOrCreateTarget(target_name, BuildTarget_Application);
-        target->Location = BuildSourceLocation(this->SourceFile, command.Line);
-        this->ProcessTargetFiles(target, args);
+        target->Name = this->Model->Name.isEmpty() ? QString("MainProject") : this->Model->Name;
+        target->Type = BuildTarget_Subdirs;
+    }
+    this->AddUnique(&target->Subdirectories, args.first());
+    BuildTarget subdir;
+    subdir.Name = args.first();
+    subdir.Type = BuildTarget_Subdirs;
+    subdir.Location = BuildSourceLocation(this->SourceFile, command.Line);
+    this->Model->Targets.append(subdir);
+}
+
+void CMakeParser::CommandTargetSources(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    if (args.isEmpty() || this->ExternalTargets.contains(args.first()))
         return;
+    BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
+    this->ProcessTargetFiles(target, args);
+}
+
+void CMakeParser::CommandTargetLinkLibraries(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    if (args.isEmpty() || this->ExternalTargets.contains(args.first()))
+        return;
+    BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
+    QStringList libs;
+    foreach (const QString &arg, this->WithoutVisibilityKeywords(args))
+    {
+        if (this->IsQtImportedTarget(arg))
+            this->AddUnique(&target->QtModules, this->QtModuleFromImportedTarget(arg));
+        else
+            libs << arg;
     }
-    if (name == "add_library" || name == "qt_add_library")
+    this->ProcessTargetList(target, &target->Libraries, libs);
+}
+
+void CMakeParser::CommandTargetIncludeDirectories(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    if (args.isEmpty() || this->ExternalTargets.contains(args.first()))
+        return;
+    BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
+    this->ProcessTargetList(target, &target->IncludePaths, args);
+}
+
+void CMakeParser::CommandTargetCompileDefinitions(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    if (args.isEmpty() || this->ExternalTargets.contains(args.first()))
+        return;
+    BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
+    this->ProcessTargetList(target, &target->Defines, args);
+}
+
+void CMakeParser::CommandTargetCompileOptions(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    if (args.isEmpty() || this->ExternalTargets.contains(args.first()))
+        return;
+    BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
+    this->ProcessTargetList(target, &target->CompileOptions, args);
+    if (this->ConditionStack.isEmpty())
+        this->TakeOptimizationOptions(target);
+}
+
+void CMakeParser::CommandTargetLinkOptions(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    if (args.isEmpty() || this->ExternalTargets.contains(args.first()))
+        return;
+    BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
+    this->ProcessTargetList(target, &target->LinkOptions, args);
+}
+
+void CMakeParser::CommandTargetLinkDirectories(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    if (args.isEmpty() || this->ExternalTargets.contains(args.first()))
+        return;
+    BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
+    QStringList libraries;
+    foreach (const QString &arg, this->WithoutVisibilityKeywords(args))
+        libraries << "-L" + arg;
+    this->ProcessTargetList(target, &target->Libraries, libraries);
+}
+
+void CMakeParser::CommandTargetPrecompileHeaders(const CMakeCommand &command, QStringList &args)
+{
+    if (args.isEmpty() || this->ExternalTargets.contains(args.first()))
+        return;
+    BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
+    int reuse = args.indexOf("REUSE_FROM");
+    if (reuse >= 0)
     {
-        if (args.isEmpty())
+        if (this->ReusePrecompiledHeaders(target, args.value(reuse + 1)))
             return;
-        QString target_name = args.takeFirst();
-        BuildTargetType target_type = args.contains("MODULE") ? BuildTarget_Plugin : BuildTarget_Library;
-        BuildTarget *target = this->FindOrCreateTarget(target_name, target_type);
-        target->Location = BuildSourceLocation(this->SourceFile, command.Line);
-        if (!args.isEmpty() && (args.first() == "STATIC" || args.first() == "SHARED" || args.first() == "MODULE" || args.first() == "OBJECT" || args.first() == "INTERFACE"))
-            args.removeFirst();
-        if (!args.isEmpty() && (args.first() == "STATIC" || args.first() == "SHARED" || args.first() == "MODULE" || args.first() == "OBJECT" || args.first() == "INTERFACE"))
-            args.removeFirst();
-        this->ProcessTargetFiles(target, args);
+        this->AddWarning(BuildWarning_PartialPrecompiledHeaders, command.Line, "target_precompile_headers REUSE_FROM is not represented at line " + QString::number(command.Line),
+                         "Set PRECOMPILED_HEADER to the header of the reused target");
         return;
     }
-    if (name == "add_subdirectory")
+    if (!this->ConditionStack.isEmpty())
     {
-        if (args.isEmpty())
-            return;
-        BuildTarget *target = this->Model->EnsurePrimaryTarget();
-        if (target->Name.isEmpty())
-        {
-            target->Name = this->Model->Name.isEmpty() ? QString("MainProject") : this->Model->Name;
-            target->Type = BuildTarget_Subdirs;
-        }
-        this->AddUnique(&target->Subdirectories, args.first());
-        BuildTarget subdir;
-        subdir.Name = args.first();
-        subdir.Type = BuildTarget_Subdirs;
-        subdir.Location = BuildSourceLocation(this->SourceFile, command.Line);
-        this->Model->Targets.append(subdir);
+        this->AddWarning(BuildWarning_PartialPrecompiledHeaders, command.Line, "Conditional target_precompile_headers is not represented at line " + QString::number(command.Line),
+                         "Move the precompiled header out of the condition or add it to the generated project by hand");
         return;
     }
-    if (name == "target_sources")
+    QStringList expanded;
+    this->AppendValues(&target->PrecompiledHeaders, this->WithoutVisibilityKeywords(this->ExpandArguments(args, &expanded)));
+}
+
+void CMakeParser::CommandQtHelper(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(args);
+    this->AddWarning(BuildWarning_QtHelperCommand, command.Line, "Qt helper command parsed as generated-output hint at line " + QString::number(command.Line) + ": " + command.Name);
+}
+
+void CMakeParser::CommandQtAddTranslations(const CMakeCommand &command, QStringList &args)
+{
+    Q_UNUSED(command);
+    if (args.isEmpty() || this->ExternalTargets.contains(args.first()))
+        return;
+    BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
+    int ts_index = args.indexOf("TS_FILES");
+    if (ts_index < 0)
     {
-        if (args.isEmpty())
-            return;
-        BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
-        this->ProcessTargetFiles(target, args);
+        this->ProcessTargetList(target, &target->TranslationFiles, args);
         return;
     }
-    if (name == "target_link_libraries")
+    QStringList expanded;
+    this->AppendValues(&target->TranslationFiles, this->ExpandArguments(args.mid(ts_index + 1), &expanded));
+}
+
+void CMakeParser::CommandQtAddQmlModule(const CMakeCommand &command, QStringList &args)
+{
+    static const QSet<QString> keywords = { "URI", "VERSION", "QML_FILES", "SOURCES", "RESOURCES", "IMPORTS", "DEPENDENCIES",
+                                            "OPTIONAL_IMPORTS", "DEFAULT_IMPORTS", "RESOURCE_PREFIX", "OUTPUT_DIRECTORY",
+                                            "CLASS_NAME", "PLUGIN_TARGET", "TYPEINFO", "IMPORT_PATH", "NO_PLUGIN", "STATIC", "SHARED" };
+    if (args.isEmpty())
+        return;
+    BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Library);
+    this->AddUnique(&target->QtModules, QString("qml"));
+
+    QStringList sources;
+    QStringList resources;
+    QString section;
+    foreach (const QString &arg, args)
     {
-        if (args.isEmpty())
-            return;
-        BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
-        QStringList libs;
-        foreach (QString arg, args)
+        if (keywords.contains(arg))
         {
-            if (this->IsVisibilityKeyword(arg))
-                continue;
-            if (this->IsQtImportedTarget(arg))
-                this->AddUnique(&target->QtModules, this->QtModuleFromImportedTarget(arg));
-            else
-                libs << arg;
+            section = arg;
+            continue;
         }
-        this->ProcessTargetList(target, &target->Libraries, libs);
-        return;
+        if (section == "SOURCES")
+            sources << arg;
+        else if (section == "QML_FILES" || section == "RESOURCES")
+            resources << arg;
     }
-    if (name == "target_include_directories")
+    this->ProcessTargetFiles(target, sources);
+    // qmake generates a resource file for plain files listed in RESOURCES
+    QStringList expanded;
+    this->AppendValues(&target->ResourceFiles, this->ExpandArguments(resources, &expanded));
+    this->AddWarning(BuildWarning_PartialQmlModule, command.Line, "qt_add_qml_module is only partially represented at line " + QString::number(command.Line),
+                     "The module URI, version and plugin are not converted, register the QML types by hand");
+}
+
+bool CMakeParser::ReusePrecompiledHeaders(BuildTarget *target, const QString &donor_name)
+{
+    // qmake has no shared precompiled headers, every project compiles the header of the reused target itself
+    const BuildTarget *donor = this->FindTarget(donor_name);
+    if (donor == nullptr || donor->PrecompiledHeaders.isEmpty() || !this->ConditionStack.isEmpty())
+        return false;
+    QList<QString> headers = donor->PrecompiledHeaders;
+    this->AppendValues(&target->PrecompiledHeaders, headers);
+    return true;
+}
+
+bool CMakeParser::ApplyTargetProperty(BuildTarget *target, const QString &name, const QStringList &values, bool append)
+{
+    // Conditional properties would need a scope with a CONFIG list the generators do not emit
+    if (!this->ConditionStack.isEmpty())
+        return false;
+    static const QStringList truthy = QStringList() << "ON" << "TRUE" << "YES" << "Y" << "1";
+    bool enabled = !values.isEmpty() && truthy.contains(values.first().toUpper());
+    if (name == "INTERPROCEDURAL_OPTIMIZATION" || name == "INTERPROCEDURAL_OPTIMIZATION_RELEASE")
     {
-        if (args.isEmpty())
-            return;
-        BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
-        this->ProcessTargetList(target, &target->IncludePaths, args);
-        return;
+        // qmake only does link time code generation in release builds
+        if (enabled)
+            this->AddUnique(&target->Config, "ltcg");
+        else
+            target->Config.removeAll("ltcg");
+        return true;
     }
-    if (name == "target_compile_definitions")
+    if (name == "CXX_STANDARD")
     {
-        if (args.isEmpty())
-            return;
-        BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
-        this->ProcessTargetList(target, &target->Defines, args);
-        return;
+        static const QStringList standards = QStringList() << "c++11" << "c++14" << "c++17" << "c++20" << "c++2b";
+        QString standard = values.value(0) == "23" ? QString("c++2b") : "c++" + values.value(0);
+        if (!standards.contains(standard))
+            return false;
+        foreach (const QString &other, standards)
+            target->Config.removeAll(other);
+        target->Config.append(standard);
+        return true;
     }
-    if (name == "target_compile_options")
+    if (name == "CXX_EXTENSIONS")
     {
-        if (args.isEmpty())
-            return;
-        BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
-        this->ProcessTargetList(target, &target->CompileOptions, args);
-        return;
+        if (enabled)
+            target->Config.removeAll("strict_c++");
+        else
+            this->AddUnique(&target->Config, "strict_c++");
+        return true;
     }
-    if (name == "target_link_options")
+    if (name == "PRECOMPILE_HEADERS")
     {
-        if (args.isEmpty())
-            return;
-        BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
-        this->ProcessTargetList(target, &target->LinkOptions, args);
-        return;
+        if (!append)
+            target->PrecompiledHeaders.clear();
+        this->AppendValues(&target->PrecompiledHeaders, values);
+        return true;
     }
-    if (name == "target_link_directories")
+    if (name == "PRECOMPILE_HEADERS_REUSE_FROM")
+        return this->ReusePrecompiledHeaders(target, values.value(0));
+    // qmake already requires the standard and runs moc, uic and rcc on its own
+    return name == "CXX_STANDARD_REQUIRED" || name == "AUTOMOC" || name == "AUTOUIC" || name == "AUTORCC";
+}
+
+void CMakeParser::ApplyPropertyDefaults(BuildTarget *target)
+{
+    // CMAKE_<PROPERTY> variables initialize the property of every target created after them
+    static const QString properties[] = { "INTERPROCEDURAL_OPTIMIZATION", "INTERPROCEDURAL_OPTIMIZATION_RELEASE", "CXX_STANDARD", "CXX_EXTENSIONS" };
+    for (const QString &property : properties)
     {
-        if (args.isEmpty())
-            return;
-        BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
-        QStringList libraries;
-        foreach (QString arg, args)
+        QHash<QString, QStringList>::const_iterator value = this->Variables.constFind("CMAKE_" + property);
+        if (value != this->Variables.constEnd())
+            this->ApplyTargetProperty(target, property, value.value(), false);
+    }
+}
+
+void CMakeParser::AddPropertyWarning(int line_number, const QString &command_name, const QStringList &properties)
+{
+    if (properties.isEmpty())
+        return;
+    QString suggestion = "qmake has no equivalent for these properties, review them in the generated project";
+    if (properties.contains("UNITY_BUILD"))
+        suggestion = "qmake has no unity builds, every source is compiled on its own; " + suggestion;
+    this->AddWarning(BuildWarning_PartialTargetProperties, line_number, command_name + " is not fully represented at line " + QString::number(line_number)
+                     + ": " + properties.join(", "), suggestion);
+}
+
+BuildTarget *CMakeParser::FindPropertyTarget(int line_number, const QString &command_name, const QString &name)
+{
+    BuildTarget *target = this->FindTarget(name);
+    if (target == nullptr)
+        this->AddWarning(BuildWarning_UnknownTarget, line_number, command_name + " on the unknown target " + name + " is not represented at line " + QString::number(line_number),
+                         "Define the target before setting its properties");
+    return target;
+}
+
+void CMakeParser::CommandSetTargetProperties(const CMakeCommand &command, QStringList &args)
+{
+    int properties_index = args.indexOf("PROPERTIES");
+    if (properties_index < 0)
+        return;
+    QStringList pairs = args.mid(properties_index + 1);
+    QStringList expanded;
+    const QStringList &values = this->ExpandArguments(pairs, &expanded);
+    QStringList dropped;
+    for (int i = 0; i < properties_index; i++)
+    {
+        if (this->ExternalTargets.contains(args.at(i)))
+            continue;
+        BuildTarget *target = this->FindPropertyTarget(command.Line, "set_target_properties", args.at(i));
+        if (target == nullptr)
+            continue;
+        for (int j = 0; j + 1 < values.size(); j += 2)
         {
-            if (this->IsVisibilityKeyword(arg))
-                continue;
-            libraries << "-L" + arg;
+            if (!this->ApplyTargetProperty(target, values.at(j), QStringList() << values.at(j + 1), false) && !dropped.contains(values.at(j)))
+                dropped << values.at(j);
         }
-        this->ProcessTargetList(target, &target->Libraries, libraries);
-        return;
     }
-    if (name == "qt_wrap_cpp" || name == "qt5_wrap_cpp" || name == "qt6_wrap_cpp" ||
-        name == "qt_add_resources" || name == "qt5_add_resources" || name == "qt6_add_resources")
+    this->AddPropertyWarning(command.Line, "set_target_properties", dropped);
+}
+
+void CMakeParser::CommandSetProperty(const CMakeCommand &command, QStringList &args)
+{
+    if (args.isEmpty() || args.first() != "TARGET")
     {
-        this->AddWarning("Qt helper command parsed as generated-output hint at line " + QString::number(command.Line) + ": " + name);
+        this->AddWarning(BuildWarning_PartialTargetProperties, command.Line, "set_property on " + args.value(0) + " is not represented at line " + QString::number(command.Line),
+                         "Only target properties are converted, review the property in the generated project");
         return;
     }
-    if (name == "qt_add_translations")
-    {
-        if (args.isEmpty())
-            return;
-        BuildTarget *target = this->FindOrCreateTarget(args.takeFirst(), BuildTarget_Application);
-        int ts_index = args.indexOf("TS_FILES");
-        if (ts_index >= 0)
-        {
-            for (int i = ts_index + 1; i < args.size(); i++)
-            {
-                QStringList expanded_args;
-                if (args[i].contains("${"))
-                    expanded_args = this->ExpandVariables(args[i]).split(" ", Qt::SkipEmptyParts);
-                else
-                    expanded_args << args[i];
-                foreach (QString arg, expanded_args)
-                    this->AddUnique(&target->TranslationFiles, arg);
-            }
-        }
-        else
-        {
-            this->ProcessTargetList(target, &target->TranslationFiles, args);
-        }
+    int property_index = args.indexOf("PROPERTY");
+    if (property_index < 0 || property_index + 1 >= args.size())
         return;
+    bool append = false;
+    QStringList targets;
+    for (int i = 1; i < property_index; i++)
+    {
+        if (args.at(i) == "APPEND" || args.at(i) == "APPEND_STRING")
+            append = true;
+        else if (!this->ExternalTargets.contains(args.at(i)))
+            targets << args.at(i);
     }
-    if (name == "set_target_properties")
+    QString name = args.at(property_index + 1);
+    QStringList expanded;
+    QStringList values = this->ExpandArguments(args.mid(property_index + 2), &expanded);
+    bool represented = true;
+    foreach (const QString &target_name, targets)
     {
-        this->AddWarning("set_target_properties is not fully represented at line " + QString::number(command.Line));
-        return;
+        BuildTarget *target = this->FindPropertyTarget(command.Line, "set_property", target_name);
+        if (target != nullptr)
+            represented = this->ApplyTargetProperty(target, name, values, append) && represented;
     }
+    if (!represented)
+        this->AddPropertyWarning(command.Line, "set_property", QStringList() << name);
+}
 
-    this->AddWarning("Unsupported CMake command at line " + QString::number(command.Line) + ": " + name);
+void CMakeParser::CommandSetSourceFilesProperties(const CMakeCommand &command, QStringList &args)
+{
+    // qmake has no per-file properties, the warning names the ones that were dropped
+    int properties_index = args.indexOf("PROPERTIES");
+    QStringList properties;
+    for (int i = properties_index + 1; properties_index >= 0 && i < args.size(); i += 2)
+        properties << args.at(i);
+    this->AddWarning(BuildWarning_SourceFileProperties, command.Line, "set_source_files_properties is not represented at line " + QString::number(command.Line)
+                     + (properties.isEmpty() ? QString() : ": " + properties.join(", ")),
+                     "qmake has no per-file properties, review the affected sources by hand");
 }
 
-QString CMakeParser::NormalizeCondition(QStringList args) const
+QString CMakeParser::NormalizeCondition(const QStringList &args) const
 {
     return args.join(" ");
 }
 
-BuildTarget *CMakeParser::FindOrCreateTarget(QString name, BuildTargetType type)
+BuildTarget *CMakeParser::FindOrCreateTarget(const QString &name, BuildTargetType type)
 {
     BuildTarget *target = this->FindTarget(name);
     if (target != nullptr)
     {
         if (target->Type == BuildTarget_Unknown || target->Type == BuildTarget_Subdirs)
             target->Type = type;
-        foreach (QString module, this->Model->GlobalQtModules)
+        foreach (const QString &module, this->Model->GlobalQtModules)
             this->AddUnique(&target->QtModules, module);
         return target;
     }
@@ -424,10 +875,11 @@ BuildTarget *CMakeParser::FindOrCreateTarget(QString name, BuildTargetType type)
     {
         primary->Name = name;
         primary->Type = type;
-        foreach (QString module, this->Model->GlobalQtModules)
+        foreach (const QString &module, this->Model->GlobalQtModules)
             this->AddUnique(&primary->QtModules, module);
         if (this->Model->Name.isEmpty())
             this->Model->Name = name;
+        this->ApplyPropertyDefaults(primary);
         return primary;
     }
 
@@ -438,10 +890,12 @@ BuildTarget *CMakeParser::FindOrCreateTarget(QString name, BuildTargetType type)
     this->Model->Targets.append(new_target);
     if (this->Model->Name.isEmpty())
         this->Model->Name = name;
-    return &this->Model->Targets[this->Model->Targets.size() - 1];
+    BuildTarget *created = &this->Model->Targets[this->Model->Targets.size() - 1];
+    this->ApplyPropertyDefaults(created);
+    return created;
 }
 
-BuildTarget *CMakeParser::FindTarget(QString name)
+BuildTarget *CMakeParser::FindTarget(const QString &name)
 {
     for (int i = 0; i < this->Model->Targets.size(); i++)
     {
@@ -456,112 +910,231 @@ BuildTarget *CMakeParser::PrimaryTarget()
     return this->Model->EnsurePrimaryTarget();
 }
 
-void CMakeParser::ProcessTargetFiles(BuildTarget *target, QStringList args)
+void CMakeParser::ProcessTargetFiles(BuildTarget *target, const QStringList &args)
 {
+    // Files go straight into the lists they end up in, scoped ones into a new scope
     bool scoped = !this->ConditionStack.isEmpty();
     BuildConditionalScope scope;
-    if (scoped)
-        scope.Condition = this->ConditionStack.join(" AND ");
+    QList<QString> *sources = scoped ? &scope.Sources : &target->Sources;
+    QList<QString> *headers = scoped ? &scope.Headers : &target->Headers;
+    QList<QString> *ui_files = scoped ? &scope.UiFiles : &target->UiFiles;
+    QList<QString> *resource_files = scoped ? &scope.ResourceFiles : &target->ResourceFiles;
+    QList<QString> *translation_files = scoped ? &scope.TranslationFiles : &target->TranslationFiles;
 
-    foreach (QString raw_arg, args)
+    QStringList expanded;
+    foreach (const QString &arg, this->ExpandArguments(args, &expanded))
     {
-        QStringList expanded_args;
-        if (raw_arg.contains("${"))
-            expanded_args = this->ExpandVariables(raw_arg).split(" ", Qt::SkipEmptyParts);
-        else
-            expanded_args << raw_arg;
-
-        foreach (QString arg, expanded_args)
-        {
         if (this->IsVisibilityKeyword(arg) || arg == "WIN32" || arg == "MACOSX_BUNDLE" || arg == "EXCLUDE_FROM_ALL")
             continue;
-        if (scoped)
+        // A file of one build configuration is kept wrapped and sorted by the file it names
+        QString config_file;
+        if (arg.size() > 1 && arg.at(0) == '$' && arg.at(1) == '<')
         {
-            if (arg.endsWith(".h") || arg.endsWith(".hpp") || arg.endsWith(".hh"))
-                this->AddUnique(&scope.Headers, arg);
-            else if (!arg.endsWith(".ui") && !arg.endsWith(".qrc") && !arg.endsWith(".ts") && !arg.startsWith("$<"))
-                this->AddUnique(&scope.Sources, arg);
-            continue;
-        }
-        else if (arg.endsWith(".h") || arg.endsWith(".hpp") || arg.endsWith(".hh"))
-            this->AddUnique(&target->Headers, arg);
-        else if (arg.endsWith(".ui"))
-            this->AddUnique(&target->UiFiles, arg);
-        else if (arg.endsWith(".qrc"))
-            this->AddUnique(&target->ResourceFiles, arg);
-        else if (arg.endsWith(".ts"))
-            this->AddUnique(&target->TranslationFiles, arg);
-        else if (!arg.startsWith("$<"))
-            this->AddUnique(&target->Sources, arg);
+            config_file = BuildConfigFile(arg);
+            if (config_file.isEmpty())
+                continue;
         }
+        const QString &file = config_file.isEmpty() ? arg : config_file;
+        if (file.endsWith(".h") || file.endsWith(".hpp") || file.endsWith(".hh"))
+            headers->append(arg);
+        else if (file.endsWith(".ui"))
+            ui_files->append(arg);
+        else if (file.endsWith(".qrc"))
+            resource_files->append(arg);
+        else if (file.endsWith(".ts"))
+            translation_files->append(arg);
+        else
+            sources->append(arg);
     }
 
     if (scoped)
-        target->ConditionalScopes.append(scope);
+        this->AddScope(target, std::move(scope));
 }
 
-void CMakeParser::ProcessTargetList(BuildTarget *target, QList<QString> *list, QStringList args)
+void CMakeParser::ProcessTargetList(BuildTarget *target, QList<QString> *list, const QStringList &args)
 {
-    bool scoped = !this->ConditionStack.isEmpty();
     BuildConditionalScope scope;
-    if (scoped)
-        scope.Condition = this->ConditionStack.join(" AND ");
-
-    foreach (QString raw_arg, args)
+    QList<QString> *destination = list;
+    if (!this->ConditionStack.isEmpty())
     {
-        QStringList expanded_args;
-        if (raw_arg.contains("${"))
-            expanded_args = this->ExpandVariables(raw_arg).split(" ", Qt::SkipEmptyParts);
-        else
-            expanded_args << raw_arg;
-
-        foreach (QString arg, expanded_args)
-        {
-        if (this->IsVisibilityKeyword(arg))
-            continue;
-        if (!scoped)
-            this->AddUnique(list, arg);
-        else if (list == &target->Defines)
-            this->AddUnique(&scope.Defines, arg);
+        if (list == &target->Defines)
+            destination = &scope.Defines;
         else if (list == &target->IncludePaths)
-            this->AddUnique(&scope.IncludePaths, arg);
+            destination = &scope.IncludePaths;
         else if (list == &target->Libraries)
-            this->AddUnique(&scope.Libraries, arg);
+            destination = &scope.Libraries;
         else if (list == &target->CompileOptions)
-            this->AddUnique(&scope.CompileOptions, arg);
+            destination = &scope.CompileOptions;
         else if (list == &target->LinkOptions)
-            this->AddUnique(&scope.LinkOptions, arg);
+            destination = &scope.LinkOptions;
+        else
+            destination = nullptr;
+    }
+
+    QStringList expanded;
+    foreach (const QString &value, this->ExpandArguments(args, &expanded))
+    {
+        if (destination != nullptr && !value.isEmpty() && !this->IsVisibilityKeyword(value))
+            destination->append(value);
+    }
+
+    if (destination != list)
+        this->AddScope(target, std::move(scope));
+}
+
+void CMakeParser::AddScope(BuildTarget *target, BuildConditionalScope &&scope)
+{
+    // Only the conditions below the closest level the target already has a scope in are
+    // kept, so a deeply nested block does not copy the whole chain into every scope
+    int level = this->ConditionStack.size() - 1;
+    int first = 0;
+    for (int i = level - 1; i >= 0 && scope.Parent < 0; i--)
+    {
+        QHash<QString, int>::const_iterator it = this->ScopeStack.at(i).constFind(target->Name);
+        if (it != this->ScopeStack.at(i).constEnd())
+        {
+            scope.Parent = it.value();
+            first = i + 1;
         }
     }
+    if (first == level)
+        scope.Condition = this->ConditionStack.at(level);
+    else
+        scope.Condition = this->ConditionStack.mid(first).join(" AND ");
 
-    if (scoped)
-        target->ConditionalScopes.append(scope);
+    if (!this->ScopeStack.at(level).contains(target->Name))
+        this->ScopeStack[level].insert(target->Name, target->ConditionalScopes.size());
+    target->ConditionalScopes.append(std::move(scope));
+}
+
+void CMakeParser::TakeOptimizationOptions(BuildTarget *target)
+{
+    // These are the options CMakeGenerator::GenerateOptimization writes
+    static const QString not_msvc = "$<$<AND:" + BuildConfig::Release + ",$<NOT:$<CXX_COMPILER_ID:MSVC>>>:";
+    static const QString full = not_msvc + "-O3>";
+    static const QString size = not_msvc + "-Os>";
+    static const QString size_msvc = "$<$<AND:" + BuildConfig::Release + ",$<CXX_COMPILER_ID:MSVC>>:/O1>";
+    if (target->CompileOptions.removeAll(full) > 0)
+        this->AddUnique(&target->Config, "optimize_full");
+    if (target->CompileOptions.contains(size) && target->CompileOptions.contains(size_msvc))
+    {
+        target->CompileOptions.removeAll(size);
+        target->CompileOptions.removeAll(size_msvc);
+        this->AddUnique(&target->Config, "optimize_size");
+    }
+}
+
+const QStringList &CMakeParser::ExpandArguments(const QStringList &args, QStringList *expanded)
+{
+    // Arguments without variables are returned as they are, without a copy
+    int first = 0;
+    while (first < args.size() && !args.at(first).contains("${"))
+        first++;
+    if (first == args.size())
+        return args;
+
+    *expanded = args.mid(0, first);
+    for (int i = first; i < args.size(); i++)
+    {
+        if (args.at(i).contains("${"))
+            expanded->append(this->ExpandVariables(args.at(i)).split(" ", Qt::SkipEmptyParts));
+        else
+            expanded->append(args.at(i));
+    }
+    return *expanded;
 }
 
-void CMakeParser::AddUnique(QList<QString> *list, QString value)
+QStringList CMakeParser::WithoutVisibilityKeywords(const QStringList &args) const
+{
+    QStringList values;
+    foreach (const QString &arg, args)
+    {
+        if (!this->IsVisibilityKeyword(arg))
+            values << arg;
+    }
+    return values;
+}
+
+void CMakeParser::AddUnique(QList<QString> *list, const QString &value)
 {
     if (!value.isEmpty() && !list->contains(value))
         list->append(value);
 }
 
-void CMakeParser::AddWarning(QString warning)
+void CMakeParser::AppendValues(QList<QString> *list, const QList<QString> &values)
+{
+    // Duplicates are dropped once at the end of Parse(), checking here would
+    // make every command cost as much as the list it appends to
+    foreach (const QString &value, values)
+    {
+        if (!value.isEmpty())
+            list->append(value);
+    }
+}
+
+void CMakeParser::RemoveDuplicates(QList<QString> *list)
+{
+    if (list->size() < 2)
+        return;
+    QSet<QString> present;
+    present.reserve(list->size());
+    int kept = 0;
+    for (int i = 0; i < list->size(); i++)
+    {
+        if (present.contains(list->at(i)))
+            continue;
+        present.insert(list->at(i));
+        if (kept != i)
+            (*list)[kept] = std::move((*list)[i]);
+        kept++;
+    }
+    list->erase(list->begin() + kept, list->end());
+}
+
+void CMakeParser::RemoveDuplicates(BuildTarget *target)
+{
+    static QList<QString> BuildTarget::* const target_lists[] =
+    {
+        &BuildTarget::Sources, &BuildTarget::Headers, &BuildTarget::UiFiles, &BuildTarget::ResourceFiles,
+        &BuildTarget::TranslationFiles, &BuildTarget::QtModules, &BuildTarget::Defines, &BuildTarget::IncludePaths,
+        &BuildTarget::Libraries, &BuildTarget::CompileOptions, &BuildTarget::LinkOptions, &BuildTarget::PrecompiledHeaders,
+        &BuildTarget::Subdirectories
+    };
+    static QList<QString> BuildConditionalScope::* const scope_lists[] =
+    {
+        &BuildConditionalScope::Sources, &BuildConditionalScope::Headers, &BuildConditionalScope::UiFiles,
+        &BuildConditionalScope::ResourceFiles, &BuildConditionalScope::TranslationFiles, &BuildConditionalScope::Defines,
+        &BuildConditionalScope::IncludePaths, &BuildConditionalScope::Libraries, &BuildConditionalScope::CompileOptions,
+        &BuildConditionalScope::LinkOptions
+    };
+    for (QList<QString> BuildTarget::*list : target_lists)
+        this->RemoveDuplicates(&(target->*list));
+    for (int i = 0; i < target->ConditionalScopes.size(); i++)
+    {
+        for (QList<QString> BuildConditionalScope::*list : scope_lists)
+            this->RemoveDuplicates(&(target->ConditionalScopes[i].*list));
+    }
+}
+
+void CMakeParser::AddWarning(BuildWarningCode code, int line_number, QString message, QString suggestion)
 {
     if (this->Model != nullptr)
-        this->Model->AddWarning(warning);
-    Logs::DebugLog(warning);
+        this->Model->AddWarning(BuildWarning(code, BuildSourceLocation(this->SourceFile, line_number), message, suggestion));
+    Q2C_DEBUG_LOG(1, "cmake", this->SourceFile, line_number, message);
 }
 
-bool CMakeParser::IsVisibilityKeyword(QString value) const
+bool CMakeParser::IsVisibilityKeyword(const QString &value) const
 {
-    return value == "PRIVATE" || value == "PUBLIC" || value == "INTERFACE";
+    static const QString keywords[] = { "PRIVATE", "PUBLIC", "INTERFACE" };
+    return value == keywords[0] || value == keywords[1] || value == keywords[2];
 }
 
-bool CMakeParser::IsQtImportedTarget(QString value) const
+bool CMakeParser::IsQtImportedTarget(const QString &value) const
 {
     return value.startsWith("Qt4::") || value.startsWith("Qt5::") || value.startsWith("Qt6::") || value.startsWith("Qt::");
 }
 
-QString CMakeParser::QtModuleFromImportedTarget(QString value) const
+QString CMakeParser::QtModuleFromImportedTarget(const QString &value) const
 {
     QString module = value.mid(value.indexOf("::") + 2);
     return module.toLower();
@@ -13,46 +13,128 @@
 
 #include <QHash>
 #include <QList>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include "buildmodel.h"
+#include "tokenview.h"
 
 class CMakeCommand
 {
     public:
+        CMakeCommand();
         QString Name;
+        //! Filled from the tokens when a handler takes the command, unsupported commands are never copied
         QStringList Arguments;
+        int FirstToken; // Range of the command in CMakeParser::Tokens
+        int TokenCount;
         int Line;
 };
 
+class CMakeParser;
+
+//! Built-in handlers receive the arguments moved out of the command, command.Arguments is empty
+typedef void (CMakeParser::*CMakeBuiltinHandler)(const CMakeCommand &command, QStringList &args);
+//! Handlers registered from outside the parser, they update the model directly
+typedef void (*CMakeCommandCallback)(const CMakeCommand &command, BuildProject *model);
+
+class CMakeCommandHandler
+{
+    public:
+        CMakeCommandHandler();
+        CMakeBuiltinHandler Builtin;
+        CMakeCommandCallback Callback;
+        int Hits;
+};
+
+class CMakeCommandStat
+{
+    public:
+        QString Name;
+        int Hits;
+        bool Supported;
+};
+
 class CMakeParser
 {
     public:
         CMakeParser();
-        bool Parse(QString text, BuildProject *model, QString source_file);
+        bool Parse(const QString &text, BuildProject *model, const QString &source_file);
+        //! Adds or replaces the handler of a command, names are matched in lower case
+        void RegisterCommand(const QString &name, CMakeCommandCallback callback);
+        //! Hit counts of the last Parse(), sorted by name, including unsupported commands
+        QList<CMakeCommandStat> GetCommandStats() const;
 
     private:
-        QList<CMakeCommand> ParseCommands(QString text);
-        QString StripComment(QString line);
-        QStringList TokenizeArguments(QString text);
+        static const QHash<QString, CMakeBuiltinHandler> &BuiltinHandlers();
+        QList<CMakeCommand> ParseCommands(const QString &text);
+        QStringView StripComment(QStringView line) const;
+        void TokenizeArguments(QStringView text, QList<TokenView> *tokens) const;
         QString ExpandVariables(QString text);
-        QString NormalizeCondition(QStringList args) const;
-        BuildTarget *FindOrCreateTarget(QString name, BuildTargetType type);
-        BuildTarget *FindTarget(QString name);
+        QString NormalizeCondition(const QStringList &args) const;
+        BuildTarget *FindOrCreateTarget(const QString &name, BuildTargetType type);
+        BuildTarget *FindTarget(const QString &name);
         BuildTarget *PrimaryTarget();
-        void ProcessCommand(const CMakeCommand &command);
-        void ProcessTargetFiles(BuildTarget *target, QStringList args);
-        void ProcessTargetList(BuildTarget *target, QList<QString> *list, QStringList args);
-        void AddUnique(QList<QString> *list, QString value);
-        void AddWarning(QString warning);
-        bool IsVisibilityKeyword(QString value) const;
-        bool IsQtImportedTarget(QString value) const;
-        QString QtModuleFromImportedTarget(QString value) const;
+        void ProcessCommand(CMakeCommand &command);
+        void FlushUnsupportedCommands();
+        void CommandIf(const CMakeCommand &command, QStringList &args);
+        void CommandElse(const CMakeCommand &command, QStringList &args);
+        void CommandEndif(const CMakeCommand &command, QStringList &args);
+        void CommandMinimumRequired(const CMakeCommand &command, QStringList &args);
+        void CommandProject(const CMakeCommand &command, QStringList &args);
+        void CommandSet(const CMakeCommand &command, QStringList &args);
+        void CommandFindPackage(const CMakeCommand &command, QStringList &args);
+        void CommandAddExecutable(const CMakeCommand &command, QStringList &args);
+        void CommandAddLibrary(const CMakeCommand &command, QStringList &args);
+        void CommandAddSubdirectory(const CMakeCommand &command, QStringList &args);
+        void CommandTargetSources(const CMakeCommand &command, QStringList &args);
+        void CommandTargetLinkLibraries(const CMakeCommand &command, QStringList &args);
+        void CommandTargetIncludeDirectories(const CMakeCommand &command, QStringList &args);
+        void CommandTargetCompileDefinitions(const CMakeCommand &command, QStringList &args);
+        void CommandTargetCompileOptions(const CMakeCommand &command, QStringList &args);
+        void CommandTargetLinkOptions(const CMakeCommand &command, QStringList &args);
+        void CommandTargetLinkDirectories(const CMakeCommand &command, QStringList &args);
+        void CommandTargetPrecompileHeaders(const CMakeCommand &command, QStringList &args);
+        void CommandQtHelper(const CMakeCommand &command, QStringList &args);
+        void CommandQtAddTranslations(const CMakeCommand &command, QStringList &args);
+        void CommandQtAddQmlModule(const CMakeCommand &command, QStringList &args);
+        void CommandSetTargetProperties(const CMakeCommand &command, QStringList &args);
+        void CommandSetProperty(const CMakeCommand &command, QStringList &args);
+        void CommandSetSourceFilesProperties(const CMakeCommand &command, QStringList &args);
+        bool ReusePrecompiledHeaders(BuildTarget *target, const QString &donor_name);
+        //! Maps a target property onto the model, returns false when qmake has no equivalent
+        bool ApplyTargetProperty(BuildTarget *target, const QString &name, const QStringList &values, bool append);
+        void ApplyPropertyDefaults(BuildTarget *target);
+        void AddPropertyWarning(int line_number, const QString &command_name, const QStringList &properties);
+        //! Target the properties of a command apply to, nullptr with a warning when it was never defined
+        BuildTarget *FindPropertyTarget(int line_number, const QString &command_name, const QString &name);
+        const QStringList &ExpandArguments(const QStringList &args, QStringList *expanded);
+        QStringList WithoutVisibilityKeywords(const QStringList &args) const;
+        void ProcessTargetFiles(BuildTarget *target, const QStringList &args);
+        void ProcessTargetList(BuildTarget *target, QList<QString> *list, const QStringList &args);
+        //! Adds a scope for the current if() level, nested scopes are linked to the scope of the enclosing level
+        void AddScope(BuildTarget *target, BuildConditionalScope &&scope);
+        //! Turns the compile options written for optimize_full and optimize_size back into CONFIG
+        void TakeOptimizationOptions(BuildTarget *target);
+        void AddUnique(QList<QString> *list, const QString &value);
+        void AppendValues(QList<QString> *list, const QList<QString> &values);
+        void RemoveDuplicates(QList<QString> *list);
+        void RemoveDuplicates(BuildTarget *target);
+        void AddWarning(BuildWarningCode code, int line_number, QString message, QString suggestion = "");
+        bool IsVisibilityKeyword(const QString &value) const;
+        bool IsQtImportedTarget(const QString &value) const;
+        QString QtModuleFromImportedTarget(const QString &value) const;
 
         BuildProject *Model;
         QString SourceFile;
         QHash<QString, QStringList> Variables;
+        QSet<QString> ExternalTargets;                  // IMPORTED and ALIAS targets, commands on them are skipped
         QList<QString> ConditionStack;
+        QList<QHash<QString, int>> ScopeStack;          // First scope of each target inside every level of ConditionStack
+        QHash<QString, CMakeCommandHandler> Handlers;
+        QList<QString> UnsupportedCommands;             // In order of first use
+        QHash<QString, QList<int>> UnsupportedLines;    // Lines of every use, keyed by command name
+        QList<TokenView> Tokens;                        // Arguments of all commands, point into the text given to Parse()
 };
 
 #endif // CMAKEPARSER_H
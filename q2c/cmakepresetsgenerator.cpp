@@ -0,0 +1,86 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include <QDir>
+#include <QStringList>
+#include "cmakepresetsgenerator.h"
+#include "warningreport.h"
+
+CMakePresetsGenerator::CMakePresetsGenerator(CMakeQtVersion version, const QString &qt_prefix)
+{
+    this->Version = version;
+    this->QtPrefix = qt_prefix;
+}
+
+QString CMakePresetsGenerator::CacheVariable(const QString &name, const QString &value) const
+{
+    return WarningReport::JsonString(name) + ": " + WarningReport::JsonString(value);
+}
+
+QString CMakePresetsGenerator::Generate(const BuildProject &project, const QList<CMakeOption> &options)
+{
+    bool precompiled_headers = false;
+    foreach (const BuildTarget &target, project.Targets)
+        precompiled_headers = precompiled_headers || !target.PrecompiledHeaders.isEmpty();
+
+    QStringList cache;
+    cache << this->CacheVariable("CMAKE_EXPORT_COMPILE_COMMANDS", "ON");
+    if (!this->QtPrefix.isEmpty())
+        cache << this->CacheVariable("CMAKE_PREFIX_PATH", QDir::cleanPath(QDir(this->QtPrefix).absolutePath()));
+    if (precompiled_headers)
+        cache << this->CacheVariable("CMAKE_DISABLE_PRECOMPILE_HEADERS", "OFF");
+    // The generated CMakeLists.txt picks between Qt 5 and Qt 6 with this option
+    if (this->Version == CMakeQtVersion_All)
+        cache << this->CacheVariable("QT5BUILD", "TRUE");
+    foreach (const CMakeOption &option, options)
+        cache << this->CacheVariable(option.Name, option.Default);
+
+    QString name = project.Name.isEmpty() ? "project" : project.Name;
+    QString source = "{\n";
+    source += "  \"version\": 3,\n";
+    source += "  \"cmakeMinimumRequired\": {\"major\": 3, \"minor\": 21, \"patch\": 0},\n";
+    source += "  \"configurePresets\": [\n";
+    source += "    {\n";
+    source += "      \"name\": \"base\",\n";
+    source += "      \"hidden\": true,\n";
+    source += "      \"generator\": \"Ninja\",\n";
+    source += "      \"binaryDir\": \"${sourceDir}/build/${presetName}\",\n";
+    source += "      \"cacheVariables\": {\n        " + cache.join(",\n        ") + "\n      }\n";
+    source += "    },\n";
+
+    // Unity builds are left to the UNITY_BUILD property --unity sets on the target it planned,
+    // CMAKE_UNITY_BUILD would also batch sources nobody checked for clashing names
+    source += "    {\n";
+    source += "      \"name\": \"release\",\n";
+    source += "      \"displayName\": " + WarningReport::JsonString("Release build of " + name) + ",\n";
+    source += "      \"inherits\": \"base\",\n";
+    source += "      \"cacheVariables\": {\n        " + this->CacheVariable("CMAKE_BUILD_TYPE", "Release") + "\n      }\n";
+    source += "    },\n";
+    source += "    {\n";
+    source += "      \"name\": \"relwithdebinfo\",\n";
+    source += "      \"displayName\": " + WarningReport::JsonString("Optimized build of " + name + " with debug information") + ",\n";
+    source += "      \"inherits\": \"base\",\n";
+    source += "      \"cacheVariables\": {\n        " + this->CacheVariable("CMAKE_BUILD_TYPE", "RelWithDebInfo") + "\n      }\n";
+    source += "    },\n";
+    source += "    {\n";
+    source += "      \"name\": \"fast\",\n";
+    source += "      \"displayName\": " + WarningReport::JsonString("Debug build of " + name + " for quick incremental rebuilds") + ",\n";
+    source += "      \"inherits\": \"base\",\n";
+    source += "      \"cacheVariables\": {\n        " + this->CacheVariable("CMAKE_BUILD_TYPE", "Debug") + "\n      }\n";
+    source += "    }\n";
+    source += "  ],\n";
+    source += "  \"buildPresets\": [\n";
+    source += "    {\"name\": \"release\", \"configurePreset\": \"release\"},\n";
+    source += "    {\"name\": \"relwithdebinfo\", \"configurePreset\": \"relwithdebinfo\"},\n";
+    source += "    {\"name\": \"fast\", \"configurePreset\": \"fast\"}\n";
+    source += "  ]\n";
+    source += "}\n";
+    return source;
+}
@@ -0,0 +1,35 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef CMAKEPRESETSGENERATOR_H
+#define CMAKEPRESETSGENERATOR_H
+
+#include <QList>
+#include <QString>
+#include "buildmodel.h"
+#include "cmakegenerator.h"
+
+//! Writes a CMakePresets.json with release, relwithdebinfo and fast presets that go next to
+//! the generated CMakeLists.txt, all of them configure a Ninja build
+class CMakePresetsGenerator
+{
+    public:
+        //! qt_prefix ends up in CMAKE_PREFIX_PATH when it is set
+        CMakePresetsGenerator(CMakeQtVersion version, const QString &qt_prefix);
+        QString Generate(const BuildProject &project, const QList<CMakeOption> &options);
+
+    private:
+        QString CacheVariable(const QString &name, const QString &value) const;
+
+        CMakeQtVersion Version;
+        QString QtPrefix;
+};
+
+#endif // CMAKEPRESETSGENERATOR_H
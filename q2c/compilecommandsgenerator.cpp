@@ -0,0 +1,51 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include <QDir>
+#include "compilecommandsgenerator.h"
+#include "warningreport.h"
+
+CompileCommandsGenerator::CompileCommandsGenerator(const QString &directory, const QString &qt_prefix) : Flags(qt_prefix)
+{
+    this->Directory = QDir::cleanPath(QDir(directory).absolutePath());
+}
+
+QString CompileCommandsGenerator::Generate(const BuildProject &project)
+{
+    QString directory = WarningReport::JsonString(this->Directory);
+    QString source = "[";
+    bool first = true;
+    foreach (const BuildTarget &target, project.Targets)
+    {
+        if (target.Type == BuildTarget_Subdirs)
+            continue;
+
+        // Every source of a target shares its arguments, they are only quoted once per language
+        QString cxx_arguments;
+        QString c_arguments;
+        foreach (const QString &argument, this->Flags.Arguments(target, false))
+            cxx_arguments += "," + WarningReport::JsonString(argument);
+        foreach (const QString &argument, this->Flags.Arguments(target, true))
+            c_arguments += "," + WarningReport::JsonString(argument);
+
+        foreach (const QString &file, this->Flags.Sources(target))
+        {
+            bool c_source = CompileFlags::IsCSource(file);
+            QString path = WarningReport::JsonString(QDir::cleanPath(QDir(this->Directory).absoluteFilePath(file)));
+            source += first ? "\n" : ",\n";
+            first = false;
+            source += "  {\"directory\":" + directory + ",\"file\":" + path + ",\"arguments\":[";
+            source += c_source ? "\"cc\"" + c_arguments : "\"c++\"" + cxx_arguments;
+            source += ",\"-c\"," + path + "]}";
+        }
+    }
+    source += first ? "]\n" : "\n]\n";
+    return source;
+}
@@ -0,0 +1,31 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef COMPILECOMMANDSGENERATOR_H
+#define COMPILECOMMANDSGENERATOR_H
+
+#include <QString>
+#include "buildmodel.h"
+#include "compileflags.h"
+
+//! Writes a clang compilation database (compile_commands.json) straight from the model
+class CompileCommandsGenerator
+{
+    public:
+        //! directory is where the project file is, sources and include paths are relative to it
+        CompileCommandsGenerator(const QString &directory, const QString &qt_prefix);
+        QString Generate(const BuildProject &project);
+
+    private:
+        QString Directory;
+        CompileFlags Flags;
+};
+
+#endif // COMPILECOMMANDSGENERATOR_H
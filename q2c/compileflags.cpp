@@ -0,0 +1,251 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include <QDir>
+#include <QRegularExpression>
+#include "compileflags.h"
+#include "generic.h"
+
+static bool IsHostPlatform(const QString &name, bool *known)
+{
+    *known = true;
+#if defined(Q_OS_WIN)
+    if (name == "WIN32")
+        return true;
+#endif
+#if defined(_MSC_VER)
+    if (name == "MSVC")
+        return true;
+#endif
+#if defined(__MINGW32__)
+    if (name == "MINGW")
+        return true;
+#endif
+#if defined(Q_OS_UNIX)
+    if (name == "UNIX")
+        return true;
+#endif
+#if defined(Q_OS_MACOS)
+    if (name == "APPLE" || name == "MACOS" || name == "DARWIN")
+        return true;
+#endif
+#if defined(Q_OS_LINUX)
+    if (name == "LINUX")
+        return true;
+#endif
+    if (name == "TRUE")
+        return true;
+    QStringList platforms = QStringList() << "WIN32" << "MSVC" << "MINGW" << "UNIX" << "APPLE" << "MACOS" << "DARWIN" << "LINUX" << "FALSE";
+    *known = platforms.contains(name);
+    return false;
+}
+
+// Qt module names that are not just the capitalized qmake name
+QString CompileFlags::QtModuleName(const QString &module)
+{
+    static const char *const names[][2] =
+    {
+        { "dbus", "DBus" }, { "opengl", "OpenGL" }, { "openglwidgets", "OpenGLWidgets" },
+        { "printsupport", "PrintSupport" }, { "quickcontrols2", "QuickControls2" }, { "quickwidgets", "QuickWidgets" },
+        { "serialport", "SerialPort" }, { "texttospeech", "TextToSpeech" }, { "webchannel", "WebChannel" },
+        { "webengine", "WebEngine" }, { "webenginecore", "WebEngineCore" }, { "webenginewidgets", "WebEngineWidgets" },
+        { "webkit", "WebKit" }, { "webkitwidgets", "WebKitWidgets" }, { "websockets", "WebSockets" }
+    };
+    for (const auto &name : names)
+    {
+        if (module == name[0])
+            return name[1];
+    }
+    return Generic::CapitalFirst(module);
+}
+
+CompileFlags::CompileFlags(const QString &qt_prefix)
+{
+    if (qt_prefix.isEmpty())
+        return;
+    QDir include(QDir(qt_prefix).filePath("include"));
+    this->QtHeaders = QDir::cleanPath(include.exists() ? include.path() : qt_prefix);
+}
+
+bool CompileFlags::IsHostCondition(const QString &condition, bool *known)
+{
+    QString normalized = condition.trimmed();
+    normalized.remove("(");
+    normalized.remove(")");
+    normalized = normalized.simplified().toUpper();
+
+    // OR binds weaker than AND, so it is split first
+    if (normalized.contains(" OR "))
+    {
+        bool result = false;
+        *known = true;
+        foreach (const QString &part, normalized.split(" OR ", Qt::SkipEmptyParts))
+        {
+            bool part_known = true;
+            result = CompileFlags::IsHostCondition(part, &part_known) || result;
+            *known = *known && part_known;
+        }
+        return result;
+    }
+    if (normalized.contains(" AND "))
+    {
+        bool result = true;
+        *known = true;
+        foreach (const QString &part, normalized.split(" AND ", Qt::SkipEmptyParts))
+        {
+            bool part_known = true;
+            result = CompileFlags::IsHostCondition(part, &part_known) && result;
+            *known = *known && part_known;
+        }
+        return result;
+    }
+    if (normalized.startsWith("NOT "))
+        return !CompileFlags::IsHostCondition(normalized.mid(4), known);
+    return IsHostPlatform(normalized, known);
+}
+
+bool CompileFlags::IsCompiledSource(const QString &file)
+{
+    QString suffix = file.mid(file.lastIndexOf('.') + 1).toLower();
+    return suffix == "cpp" || suffix == "cc" || suffix == "cxx" || suffix == "c++" || suffix == "c"
+           || suffix == "mm" || suffix == "m";
+}
+
+bool CompileFlags::IsCSource(const QString &file)
+{
+    return file.endsWith(".c") || file.endsWith(".m");
+}
+
+QList<const BuildConditionalScope*> CompileFlags::HostScopes(const BuildTarget &target)
+{
+    QList<const BuildConditionalScope*> scopes;
+    for (int i = 0; i < target.ConditionalScopes.size(); i++)
+    {
+        const BuildConditionalScope &scope = target.ConditionalScopes.at(i);
+        bool known = true;
+        if (!CompileFlags::IsHostCondition(scope.Condition, &known) || !known)
+            continue;
+        // A nested scope also needs its parent to hold, parents come first
+        if (scope.Parent < 0 || (scope.Parent < i && scopes.contains(&target.ConditionalScopes.at(scope.Parent))))
+            scopes.append(&scope);
+    }
+    return scopes;
+}
+
+bool CompileFlags::ReleaseValue(const QString &value, QString *resolved)
+{
+    static const QString expression = "$<";
+    if (!value.contains(expression))
+    {
+        *resolved = value;
+        return true;
+    }
+    static const QString release_prefixes[] = { "$<" + BuildConfig::Release + ":", "$<$<CONFIG:Release>:" };
+    for (const QString &prefix : release_prefixes)
+    {
+        if (!value.startsWith(prefix) || !value.endsWith('>'))
+            continue;
+        QString inner = value.mid(prefix.size(), value.size() - prefix.size() - 1);
+        if (inner.contains(expression))
+            return false;
+        *resolved = inner;
+        return true;
+    }
+    return false;
+}
+
+//! Appends the Release values of the target and of its host scopes with a prefix such as -D
+static void AppendReleaseValues(QStringList *arguments, const QString &prefix, const QList<QString> &values)
+{
+    QString resolved;
+    foreach (const QString &value, values)
+    {
+        if (CompileFlags::ReleaseValue(value, &resolved))
+            arguments->append(prefix + resolved);
+    }
+}
+
+QStringList CompileFlags::Sources(const BuildTarget &target) const
+{
+    QStringList sources;
+    QString resolved;
+    foreach (const QString &source, target.Sources)
+    {
+        if (CompileFlags::ReleaseValue(source, &resolved) && CompileFlags::IsCompiledSource(resolved))
+            sources.append(resolved);
+    }
+    foreach (const BuildConditionalScope *scope, CompileFlags::HostScopes(target))
+    {
+        foreach (const QString &source, scope->Sources)
+        {
+            if (CompileFlags::ReleaseValue(source, &resolved) && CompileFlags::IsCompiledSource(resolved) && !sources.contains(resolved))
+                sources.append(resolved);
+        }
+    }
+    return sources;
+}
+
+QStringList CompileFlags::Arguments(const BuildTarget &target, bool c_source) const
+{
+    QStringList arguments;
+    QString standard;
+    static const QRegularExpression standard_config("^c\\+\\+(11|14|17|1z|20|2a|23|2b|latest)$");
+    foreach (const QString &config, target.Config)
+    {
+        QRegularExpressionMatch match = standard_config.match(config);
+        if (match.hasMatch())
+            standard = match.captured(1);
+    }
+    if (standard.isEmpty())
+        standard = this->DefaultStandard;
+    if (standard == "1z")
+        standard = "17";
+    else if (standard == "2a")
+        standard = "20";
+    else if (standard == "2b" || standard == "latest")
+        standard = "23";
+    if (!c_source && !standard.isEmpty())
+        arguments << "-std=c++" + standard;
+#if !defined(Q_OS_WIN)
+    arguments << "-fPIC";
+#endif
+    // Release options qmake takes from CONFIG, the CMake generator writes them as release expressions
+    if (target.Config.contains("optimize_full"))
+        arguments << "-O3";
+    else if (target.Config.contains("optimize_size"))
+        arguments << "-Os";
+    if (target.Config.contains("ltcg"))
+        arguments << "-flto";
+
+    QList<const BuildConditionalScope*> scopes = CompileFlags::HostScopes(target);
+
+    foreach (const QString &module, target.QtModules)
+        arguments << "-DQT_" + module.toUpper() + "_LIB";
+    AppendReleaseValues(&arguments, "-D", target.Defines);
+    foreach (const BuildConditionalScope *scope, scopes)
+        AppendReleaseValues(&arguments, "-D", scope->Defines);
+
+    // uic writes its headers and moc the .moc files of sources next to the build files
+    arguments << "-I.";
+    AppendReleaseValues(&arguments, "-I", target.IncludePaths);
+    foreach (const BuildConditionalScope *scope, scopes)
+        AppendReleaseValues(&arguments, "-I", scope->IncludePaths);
+    if (!this->QtHeaders.isEmpty())
+    {
+        arguments << "-I" + this->QtHeaders;
+        foreach (const QString &module, target.QtModules)
+            arguments << "-I" + this->QtHeaders + "/Qt" + CompileFlags::QtModuleName(module);
+    }
+
+    AppendReleaseValues(&arguments, QString(), target.CompileOptions);
+    foreach (const BuildConditionalScope *scope, scopes)
+        AppendReleaseValues(&arguments, QString(), scope->CompileOptions);
+    return arguments;
+}
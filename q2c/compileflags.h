@@ -0,0 +1,49 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef COMPILEFLAGS_H
+#define COMPILEFLAGS_H
+
+#include <QString>
+#include <QStringList>
+#include "buildmodel.h"
+
+//! What the compiler sees of a BuildTarget on the machine q2c runs on. Used by the
+//! generators that call the compiler themselves instead of leaving it to qmake or CMake
+class CompileFlags
+{
+    public:
+        //! qt_prefix is a Qt installation or its include directory, empty leaves the Qt headers out
+        CompileFlags(const QString &qt_prefix);
+        //! Evaluates a scope condition such as "UNIX AND NOT APPLE" for the host, known is
+        //! false when the condition uses anything but platform names, NOT, AND and OR
+        static bool IsHostCondition(const QString &condition, bool *known);
+        static bool IsCompiledSource(const QString &file);
+        static bool IsCSource(const QString &file);
+        //! Name of a qmake Qt module as used in header directories and libraries, "printsupport" is "PrintSupport"
+        static QString QtModuleName(const QString &module);
+        //! Scopes of the target whose condition holds on the host
+        static QList<const BuildConditionalScope*> HostScopes(const BuildTarget &target);
+        //! Value of a model entry in the Release build the compiler is run for. Values of
+        //! BuildConfig::Release are unwrapped, false for other configurations and any other
+        //! generator expression, those only mean something to CMake
+        static bool ReleaseValue(const QString &value, QString *resolved);
+        //! Compiled sources of the target and of the scopes that hold on the host
+        QStringList Sources(const BuildTarget &target) const;
+        //! Arguments shared by every source of the target, without the compiler and the source file.
+        //! C++ only arguments are left out when c_source is true
+        QStringList Arguments(const BuildTarget &target, bool c_source) const;
+        //! Directory of the Qt headers, empty when no Qt installation was given
+        QString QtHeaders;
+        //! C++ standard such as "17" for targets whose CONFIG does not pick one, empty leaves it to the compiler
+        QString DefaultStandard;
+};
+
+#endif // COMPILEFLAGS_H
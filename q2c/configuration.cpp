@@ -19,6 +19,12 @@ bool Configuration::backup = false;
 bool Configuration::dry_run = false;
 bool Configuration::check_only = false;
 bool Configuration::strict = false;
+bool Configuration::verify_roundtrip = false;
+bool Configuration::suggest_pch = false;
+bool Configuration::pgo = false;
+bool Configuration::build_accel = false;
+bool Configuration::memory_report = false;
+bool Configuration::parser_stats = false;
 bool Configuration::exit_after_parse = false;
 int Configuration::exit_code = 0;
 bool Configuration::direction_explicit = false;
@@ -27,4 +33,11 @@ QString Configuration::InputFile = "";
 QString Configuration::OutputFile = "";
 QString Configuration::OutputDirectory = "";
 QString Configuration::WarningFormat = "text";
+QString Configuration::SaveModelFile = "";
+QString Configuration::LoadModelFile = "";
+QString Configuration::EmitModelFormat = "";
+QString Configuration::ModelQuery = "";
+QStringList Configuration::EmitOutputs;
+QString Configuration::QtPrefix = "";
+int Configuration::UnityBatchSize = 0;
 bool Configuration::q2c = true;
@@ -12,6 +12,7 @@
 #define CONFIGURATION_H
 
 #include <QString>
+#include <QStringList>
 
 class Configuration
 {
@@ -25,11 +26,24 @@ class Configuration
         static QString OutputFile;
         static QString OutputDirectory;
         static QString WarningFormat;
+        static QString SaveModelFile; // Write the parsed model to this cache file
+        static QString LoadModelFile; // Read the model from this cache file instead of parsing input
+        static QString EmitModelFormat; // Print the model in this format to stdout instead of converting it
+        static QString ModelQuery;      // Selector of the model fields to print, empty prints the whole model
+        static QStringList EmitOutputs; // KIND:FILE specs given with --emit, generated from one parse
+        static QString QtPrefix;        // Qt installation whose headers compile commands use, $QTDIR when empty
+        static int UnityBatchSize;      // Largest unity batch of --unity, 0 leaves unity builds off
         static bool force;      // Single flag for force overwrite
         static bool backup;     // Back up an existing output file before overwriting it
         static bool dry_run;    // Print generated output to stdout instead of writing it
         static bool check_only; // Parse and validate input without writing output
         static bool strict;     // Fail when parser warnings are emitted
+        static bool verify_roundtrip; // Convert, parse the result back and report model fields that were lost
+        static bool suggest_pch;   // Generate a precompiled header from the includes the sources share
+        static bool pgo;           // Add the PGO cache variable that instruments or optimizes the CMake target
+        static bool build_accel;   // Add options for compiler launchers, faster linkers, split DWARF and link pools
+        static bool memory_report; // Print allocation and peak memory statistics to stderr
+        static bool parser_stats;  // Print how often every CMake command was seen to stderr
         static bool exit_after_parse;
         static int exit_code;
         static bool direction_explicit;
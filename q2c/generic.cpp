@@ -34,14 +34,14 @@ QString Generic::ExpandedString(QString string, unsigned int minimum_size, unsig
     return string;
 }
 
-QString Generic::Indent(QString input, unsigned int indentation)
+QString Generic::Indent(const QString &input, unsigned int indentation)
 {
     QStringList lines = input.split("\n");
     QString indent = "";
     while (indentation-- > 0)
         indent += " ";
     QString result;
-    foreach (QString line, lines)
+    foreach (const QString &line, lines)
     {
         if (!line.trimmed().isEmpty())
             result += indent + line + "\n";
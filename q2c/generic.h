@@ -19,7 +19,7 @@ class Generic
 {
     public:
         static QString ExpandedString(QString string, unsigned int minimum_size, unsigned int maximum_size = 0);
-        static QString Indent(QString input, unsigned int indentation = 4);
+        static QString Indent(const QString &input, unsigned int indentation = 4);
         static QString CapitalFirst(QString text);
 };
 
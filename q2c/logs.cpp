@@ -10,22 +10,124 @@
 
 #include "logs.h"
 #include "configuration.h"
+#include <QMutex>
 #include <iostream>
+#include <string>
+#include <thread>
 
-void Logs::DebugLog(QString text, int verbosity)
+// Serializes writes of whole buffers, so lines of concurrent conversions never interleave
+static QMutex OutputLock;
+
+// Static initialization runs on the main thread
+static const std::thread::id MainThread = std::this_thread::get_id();
+
+// Every worker thread collects its info and debug lines and writes them in one go when the
+// buffer fills up, before an error is printed, on Logs::Flush() and on thread exit
+class LogSink
+{
+    public:
+        ~LogSink()
+        {
+            this->Flush();
+        }
+
+        void Append(const std::string &line)
+        {
+            this->Buffer += line;
+            if (this->Buffer.size() >= 8192)
+                this->Flush();
+        }
+
+        void Flush()
+        {
+            if (this->Buffer.empty())
+                return;
+            QMutexLocker locker(&OutputLock);
+            std::cout.write(this->Buffer.data(), static_cast<std::streamsize>(this->Buffer.size()));
+            std::cout.flush();
+            this->Buffer.clear();
+        }
+
+    private:
+        std::string Buffer;
+};
+
+static LogSink &ThreadSink()
+{
+    static thread_local LogSink sink;
+    return sink;
+}
+
+static std::string FormatRecord(LogLevel level, const char *category, const QString &file, int line, const QString &text)
 {
-    if (verbosity <= Configuration::verbosity_level)
+    std::string record;
+    switch (level)
     {
-        std::cout << "[DEBUG] " << text.toStdString() << std::endl;
+        case LogLevel_Error:
+            record = "[ERROR] ";
+            break;
+        case LogLevel_Info:
+            record = "[INFO] ";
+            break;
+        case LogLevel_Debug:
+            record = "[DEBUG] ";
+            break;
     }
+    if (category != nullptr)
+        record += std::string(category) + ": ";
+    if (!file.isEmpty())
+    {
+        record += file.toStdString();
+        if (line > 0)
+            record += ":" + std::to_string(line);
+        record += ": ";
+    }
+    record += text.toStdString();
+    record += '\n';
+    return record;
+}
+
+void Logs::Write(LogLevel level, const char *category, const QString &file, int line, const QString &text)
+{
+    std::string record = FormatRecord(level, category, file, line, text);
+    if (level != LogLevel_Error && std::this_thread::get_id() == MainThread)
+    {
+        // The main thread also prints reports and generated files, going through std::cout
+        // keeps its log lines in order with them, std::cerr is tied to it and flushes it first
+        QMutexLocker locker(&OutputLock);
+        std::cout.write(record.data(), static_cast<std::streamsize>(record.size()));
+        return;
+    }
+    LogSink &sink = ThreadSink();
+    if (level != LogLevel_Error)
+    {
+        sink.Append(record);
+        return;
+    }
+    // Keep errors in order with what this thread logged before them
+    sink.Flush();
+    QMutexLocker locker(&OutputLock);
+    std::cerr.write(record.data(), static_cast<std::streamsize>(record.size()));
+    std::cerr.flush();
+}
+
+void Logs::Flush()
+{
+    ThreadSink().Flush();
+}
+
+void Logs::DebugLog(QString text, int verbosity)
+{
+    if (Logs::DebugEnabled(verbosity))
+        Logs::Write(LogLevel_Debug, nullptr, QString(), 0, text);
 }
 
 void Logs::ErrorLog(QString text)
 {
-    std::cerr << "[ERROR] " << text.toStdString() << std::endl;
+    Logs::Write(LogLevel_Error, nullptr, QString(), 0, text);
 }
 
 void Logs::Log(QString text)
 {
-    std::cout << "[INFO] " << text.toStdString() << std::endl;
+    Logs::Write(LogLevel_Info, nullptr, QString(), 0, text);
 }
@@ -14,8 +14,38 @@
 #include <iostream>
 #include "configuration.h"
 
+// Debug messages above this verbosity are compiled out, set it to 0 to drop all of them
+#ifndef Q2C_LOG_MAX_VERBOSITY
+#define Q2C_LOG_MAX_VERBOSITY 3
+#endif
+
+// The message is only formatted when the verbosity is enabled, use this instead
+// of Logs::DebugLog anywhere the text has to be built first
+#define Q2C_DEBUG_LOG(verbosity, category, file, line, message) \
+    do \
+    { \
+        if (Logs::DebugEnabled(verbosity)) \
+            Logs::Write(LogLevel_Debug, category, file, line, message); \
+    } while (false)
+
+enum LogLevel
+{
+    LogLevel_Error,
+    LogLevel_Info,
+    LogLevel_Debug
+};
+
 namespace Logs
 {
+    inline bool DebugEnabled(int verbosity)
+    {
+        return verbosity <= Q2C_LOG_MAX_VERBOSITY && verbosity <= Configuration::verbosity_level;
+    }
+
+    //! Category is a short subsystem name such as "qmake", file and line refer to the converted input
+    void Write(LogLevel level, const char *category, const QString &file, int line, const QString &text);
+    //! Writes out messages buffered by the calling worker thread, the main thread does not buffer
+    void Flush();
     void Log(QString text);
     void ErrorLog(QString text);
     void DebugLog(QString text, int verbosity = 1);
@@ -12,52 +12,48 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
-#include <QRegularExpression>
+#include <QTextStream>
 #include <iostream>
 #include "configuration.h"
+#include "modeljson.h"
 #include "project.h"
 #include "terminalparser.h"
+#include "warningreport.h"
 #include "logs.h"
+#include "memoryreport.h"
 
 using namespace std;
 
-static QString JsonEscape(QString value)
+static void PrintMemoryReport(const QString &input_text)
 {
-    value.replace("\\", "\\\\");
-    value.replace("\"", "\\\"");
-    value.replace("\n", "\\n");
-    value.replace("\r", "\\r");
-    value.replace("\t", "\\t");
-    return value;
+    if (!Configuration::memory_report)
+        return;
+    cerr << MemoryReport::Format(input_text.count('\n') + 1).toStdString() << flush;
 }
 
-static void PrintWarning(QString warning)
+static void PrintParserStats(const Project *project)
 {
-    int line = -1;
-    QRegularExpression line_regex("\\bline\\s+(\\d+)\\b");
-    QRegularExpressionMatch match = line_regex.match(warning);
-    if (match.hasMatch())
-        line = match.captured(1).toInt();
-
-    QString file = Configuration::InputFile;
-    if (Configuration::WarningFormat == "json")
-    {
-        cerr << "{\"type\":\"warning\",\"file\":\"" << JsonEscape(file).toStdString()
-             << "\",\"line\":" << line
-             << ",\"message\":\"" << JsonEscape(warning).toStdString() << "\"}" << endl;
+    if (!Configuration::parser_stats)
         return;
+    if (!Configuration::q2c)
+    {
+        cerr << "CMake command statistics:\n";
+        foreach (const CMakeCommandStat &stat, project->CommandStats)
+        {
+            cerr << "  " << stat.Name.leftJustified(32).toStdString() << QString::number(stat.Hits).rightJustified(8).toStdString()
+                 << (stat.Supported ? "" : "  unsupported") << "\n";
+        }
+    } else
+    {
+        cerr << "Command statistics are only collected for CMake input\n";
     }
-
-    if (line >= 0)
-        cerr << file.toStdString() << ":" << line << ": warning: " << warning.toStdString() << endl;
-    else
-        cerr << file.toStdString() << ": warning: " << warning.toStdString() << endl;
+    cerr << flush;
 }
 
 static bool DetectInput()
 {
     QStringList files;
-    foreach (QString filename, QDir(".").entryList())
+    foreach (const QString &filename, QDir(".").entryList())
     {
         QString lower = filename.toLower();
         if (lower.endsWith(".pro") || lower.endsWith(".pri") || filename == "CMakeLists.txt" || lower.endsWith(".cmake"))
@@ -172,6 +168,105 @@ static bool BackupExistingOutput(QString output_path)
     return true;
 }
 
+static bool WriteOutputFile(const QString &path, const QString &text)
+{
+    QFile output_file(path);
+    if (output_file.exists() && Configuration::backup)
+    {
+        if (!BackupExistingOutput(path))
+            return false;
+    }
+    if ((!Configuration::force) && (!Configuration::backup) && output_file.exists())
+    {
+        Logs::ErrorLog("File " + path + " already exists. Use -f/--force or --backup to overwrite it");
+        return false;
+    }
+    if (!output_file.open(QIODevice::WriteOnly))
+    {
+        Logs::ErrorLog("Unable to open for writing: " + path);
+        return false;
+    }
+
+    output_file.write(text.toUtf8());
+    output_file.close();
+    return true;
+}
+
+//! Writes the header --suggest-pch picked next to the project file, the model already refers to it
+static bool SuggestPrecompiledHeader(Project *project)
+{
+    const BuildTarget *target = project->GetModel().PrimaryTarget();
+    if (target == nullptr || target->Type == BuildTarget_Subdirs)
+    {
+        Logs::Log("No target with sources, skipping --suggest-pch for " + Configuration::InputFile);
+        return true;
+    }
+    if (!target->PrecompiledHeaders.isEmpty())
+    {
+        Logs::Log("Target " + target->Name + " already has a precompiled header, skipping --suggest-pch");
+        return true;
+    }
+
+    PchSuggestion suggestion = project->SuggestPrecompiledHeader();
+    cerr << suggestion.Report().toStdString() << flush;
+    if (suggestion.Headers.isEmpty() || Configuration::dry_run)
+        return true;
+    QString path = QFileInfo(Configuration::InputFile).absoluteDir().filePath(suggestion.FileName);
+    if (!WriteOutputFile(path, suggestion.HeaderText()))
+        return false;
+    Logs::DebugLog("Wrote " + path);
+    return true;
+}
+
+//! Plans the unity batches of --unity and reports how the sources were grouped
+static void PlanUnityBuild(Project *project)
+{
+    const BuildTarget *target = project->GetModel().PrimaryTarget();
+    if (target == nullptr || target->Type == BuildTarget_Subdirs)
+    {
+        Logs::Log("No target with sources, skipping --unity for " + Configuration::InputFile);
+        return;
+    }
+    UnityPlan plan = project->PlanUnityBuild(Configuration::UnityBatchSize);
+    cerr << plan.Report().toStdString() << flush;
+}
+
+//! Generates every --emit output from the one parsed model and writes them, or prints them on --dry-run
+static bool EmitOutputs(Project *project)
+{
+    QList<ProjectOutput> outputs;
+    foreach (const QString &spec, Configuration::EmitOutputs)
+    {
+        ProjectOutput output;
+        QString error;
+        ProjectOutput::Parse(spec, &output, &error);
+        if (!Configuration::OutputDirectory.isEmpty() && QFileInfo(output.FileName).isRelative())
+            output.FileName = QDir(Configuration::OutputDirectory).filePath(output.FileName);
+        outputs.append(output);
+    }
+    project->GenerateOutputs(&outputs);
+
+    if (Configuration::dry_run)
+    {
+        foreach (const ProjectOutput &output, outputs)
+            cout << output.Text.toStdString();
+        return true;
+    }
+
+    if (!Configuration::OutputDirectory.isEmpty() && !QDir(Configuration::OutputDirectory).mkpath("."))
+    {
+        Logs::ErrorLog("Unable to create output directory: " + Configuration::OutputDirectory);
+        return false;
+    }
+    foreach (const ProjectOutput &output, outputs)
+    {
+        if (!WriteOutputFile(output.FileName, output.Text))
+            return false;
+        Logs::DebugLog("Wrote " + output.FileName);
+    }
+    return true;
+}
+
 int main(int argc, char *argv[])
 {
     QCoreApplication a(argc, argv);
@@ -193,60 +288,150 @@ int main(int argc, char *argv[])
     // Verbosity
     Logs::DebugLog("Verbosity: " + QString::number(Configuration::verbosity_level));
 
-    if (Configuration::InputFile == "")
+    QString input_text;
+    Project *project = new Project();
+    if (!Configuration::LoadModelFile.isEmpty())
     {
-        if (!DetectInput())
+        if (!project->LoadModel(Configuration::LoadModelFile))
         {
-            Logs::ErrorLog("No input file was provided");
-            return TP_RESULT_SHUT;
+            delete project;
+            return TP_RESULT_FAIL;
         }
-        Logs::DebugLog("Resolved input name to " + Configuration::InputFile);
-    }
-
-    if (!DetectDirection())
+        Logs::DebugLog("Loaded model of " + Configuration::InputFile + " from " + Configuration::LoadModelFile);
+    } else
     {
-        Logs::ErrorLog("Unable to detect conversion direction from input file: " + Configuration::InputFile);
-        return TP_RESULT_FAIL;
+        if (Configuration::InputFile == "")
+        {
+            if (!DetectInput())
+            {
+                Logs::ErrorLog("No input file was provided");
+                delete project;
+                return TP_RESULT_SHUT;
+            }
+            Logs::DebugLog("Resolved input name to " + Configuration::InputFile);
+        }
+
+        if (!DetectDirection())
+        {
+            Logs::ErrorLog("Unable to detect conversion direction from input file: " + Configuration::InputFile);
+            delete project;
+            return TP_RESULT_FAIL;
+        }
+        Logs::DebugLog("Input file: " + Configuration::InputFile, 2);
+
+        // Load the file
+        QFile file(Configuration::InputFile);
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            Logs::ErrorLog("Unable to read: " + Configuration::InputFile);
+            delete project;
+            return TP_RESULT_FAIL;
+        }
+        input_text = QString(file.readAll());
+        file.close();
+
+        if (!project->Load(input_text))
+        {
+            Logs::ErrorLog("Unable to parse: " + Configuration::InputFile);
+            delete project;
+            return TP_RESULT_FAIL;
+        }
     }
     Logs::DebugLog(QString("Conversion direction: ") + (Configuration::q2c ? "qmake to CMake" : "CMake to qmake"));
-    Logs::DebugLog("Input file: " + Configuration::InputFile, 2);
     if (!Configuration::OutputDirectory.isEmpty())
         Logs::DebugLog("Output directory: " + Configuration::OutputDirectory, 2);
 
-    // Load the file
-    QFile file(Configuration::InputFile);
-    if (!file.open(QIODevice::ReadOnly))
+    if (!Configuration::SaveModelFile.isEmpty())
     {
-        Logs::ErrorLog("Unable to read: " + Configuration::InputFile);
-        return TP_RESULT_FAIL;
+        if (!project->SaveModel(Configuration::SaveModelFile))
+        {
+            delete project;
+            return TP_RESULT_FAIL;
+        }
+        Logs::DebugLog("Saved model to " + Configuration::SaveModelFile);
     }
-    QString input_text = QString(file.readAll());
-    file.close();
+    PrintParserStats(project);
+    if (!project->GetModel().Warnings.isEmpty())
+        cerr << WarningReport::Format(project->GetModel().Warnings, Configuration::WarningFormat).toStdString() << flush;
 
-    Project *project = new Project();
-    if (!project->Load(input_text))
+    if (Configuration::strict && !project->GetModel().Warnings.isEmpty())
     {
-        Logs::ErrorLog("Unable to parse: " + Configuration::InputFile);
+        Logs::ErrorLog("Strict mode failed because conversion warnings were emitted");
         delete project;
         return TP_RESULT_FAIL;
     }
-    foreach (QString warning, project->GetModel().Warnings)
-        PrintWarning(warning);
 
-    if (Configuration::strict && !project->GetModel().Warnings.isEmpty())
+    if (Configuration::verify_roundtrip)
     {
-        Logs::ErrorLog("Strict mode failed because conversion warnings were emitted");
+        QList<RoundTripDifference> differences;
+        bool parsed = project->VerifyRoundTrip(&differences);
         delete project;
-        return TP_RESULT_FAIL;
+        PrintMemoryReport(input_text);
+        if (!parsed)
+        {
+            Logs::ErrorLog("Round trip failed, generated output of " + Configuration::InputFile + " does not parse");
+            return TP_RESULT_FAIL;
+        }
+        cout << RoundTrip::Format(differences).toStdString() << flush;
+        if (RoundTrip::HasLostValues(differences))
+        {
+            Logs::ErrorLog("Round trip of " + Configuration::InputFile + " lost model fields");
+            return TP_RESULT_FAIL;
+        }
+        Logs::Log("Round trip kept every field: " + Configuration::InputFile);
+        return TP_RESULT_OK;
+    }
+
+    if (!Configuration::EmitModelFormat.isEmpty())
+    {
+        cout << flush;
+        QTextStream out(stdout);
+        QString error;
+        if (Configuration::ModelQuery.isEmpty())
+        {
+            ModelJson::Write(project->GetModel(), &out);
+        } else if (!ModelJson::Query(project->GetModel(), Configuration::ModelQuery, &out, &error))
+        {
+            Logs::ErrorLog("Invalid query: " + error);
+            delete project;
+            return TP_RESULT_FAIL;
+        }
+        delete project;
+        PrintMemoryReport(input_text);
+        return TP_RESULT_OK;
     }
 
     if (Configuration::check_only)
     {
         Logs::Log("Input parsed successfully: " + Configuration::InputFile);
         delete project;
+        PrintMemoryReport(input_text);
         return TP_RESULT_OK;
     }
 
+    if (Configuration::UnityBatchSize > 0)
+        PlanUnityBuild(project);
+
+    // Added after the round trip check, the PGO and build acceleration blocks are build logic and not part of the model
+    if (Configuration::pgo)
+        project->CMakeOptions.append(CMakeGenerator::ProfileGuidedOptimizationOptions());
+    if (Configuration::build_accel)
+        project->CMakeOptions.append(CMakeGenerator::BuildAccelerationOptions());
+
+    if (Configuration::suggest_pch && !SuggestPrecompiledHeader(project))
+    {
+        delete project;
+        return TP_RESULT_FAIL;
+    }
+
+    if (!Configuration::EmitOutputs.isEmpty())
+    {
+        bool emitted = EmitOutputs(project);
+        delete project;
+        PrintMemoryReport(input_text);
+        return emitted ? TP_RESULT_OK : TP_RESULT_FAIL;
+    }
+
     QString result;
     if (Configuration::q2c)
     {
@@ -260,6 +445,7 @@ int main(int argc, char *argv[])
     {
         cout << result.toStdString();
         delete project;
+        PrintMemoryReport(input_text);
         return TP_RESULT_OK;
     }
 
@@ -269,31 +455,13 @@ int main(int argc, char *argv[])
         return TP_RESULT_FAIL;
     }
 
-    QFile output_file(Configuration::OutputFile);
-    if (output_file.exists() && Configuration::backup)
+    if (!WriteOutputFile(Configuration::OutputFile, result))
     {
-        if (!BackupExistingOutput(Configuration::OutputFile))
-        {
-            delete project;
-            return TP_RESULT_FAIL;
-        }
-    }
-    if ((!Configuration::force) && (!Configuration::backup) && output_file.exists())
-    {
-        Logs::ErrorLog("File " + Configuration::OutputFile + " already exists. Use -f/--force or --backup to overwrite it");
-        delete project;
-        return TP_RESULT_FAIL;
-    }
-    if (!output_file.open(QIODevice::WriteOnly))
-    {
-        Logs::ErrorLog("Unable to open for writing: " + Configuration::OutputFile);
         delete project;
         return TP_RESULT_FAIL;
     }
-
-    output_file.write(result.toUtf8());
-    output_file.close();
     delete project;
+    PrintMemoryReport(input_text);
 
     return 0;
 }
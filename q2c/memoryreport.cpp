@@ -0,0 +1,58 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "memoryreport.h"
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+std::atomic<qint64> MemoryReport::Allocations(0);
+std::atomic<qint64> MemoryReport::AllocatedBytes(0);
+bool MemoryReport::Counting = false;
+
+qint64 MemoryReport::PeakResidentKilobytes()
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef Q_OS_MACOS
+    // macOS reports bytes, everything else kilobytes
+    return static_cast<qint64>(usage.ru_maxrss) / 1024;
+#else
+    return static_cast<qint64>(usage.ru_maxrss);
+#endif
+#else
+    return 0;
+#endif
+}
+
+QString MemoryReport::Format(qint64 input_lines)
+{
+    QString text = "Memory report:\n";
+    if (MemoryReport::Counting)
+    {
+        qint64 allocations = MemoryReport::Allocations.load(std::memory_order_relaxed);
+        qint64 bytes = MemoryReport::AllocatedBytes.load(std::memory_order_relaxed);
+        text += "  allocations:     " + QString::number(allocations);
+        if (input_lines > 0)
+            text += " (" + QString::number(static_cast<double>(allocations) / static_cast<double>(input_lines), 'f', 1) + " per input line)";
+        text += "\n  bytes allocated: " + QString::number(bytes) + "\n";
+    } else
+    {
+        text += "  allocations:     not counted, configure with -DQ2C_COUNT_ALLOCATIONS=ON\n";
+    }
+    qint64 peak = MemoryReport::PeakResidentKilobytes();
+    if (peak > 0)
+        text += "  peak RSS:        " + QString::number(peak) + " KB\n";
+    else
+        text += "  peak RSS:        not available on this platform\n";
+    return text;
+}
@@ -0,0 +1,33 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <QString>
+#include <atomic>
+#include <cstddef>
+
+class MemoryReport
+{
+    public:
+        static void RecordAllocation(std::size_t size)
+        {
+            MemoryReport::Allocations.fetch_add(1, std::memory_order_relaxed);
+            MemoryReport::AllocatedBytes.fetch_add(static_cast<qint64>(size), std::memory_order_relaxed);
+        }
+        static qint64 PeakResidentKilobytes();
+        static QString Format(qint64 input_lines);
+        static std::atomic<qint64> Allocations;    // Heap allocations since start, only moves when Counting is set
+        static std::atomic<qint64> AllocatedBytes; // Bytes requested by those allocations, frees are not subtracted
+        static bool Counting;                      // Set when allocationcounter.cpp is linked into the executable
+};
+
+#endif // MEMORYREPORT_H
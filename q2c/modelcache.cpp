@@ -0,0 +1,372 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "modelcache.h"
+#include <QFile>
+#include <QHash>
+#include <cstring>
+
+// Layout, every number is a little-endian quint32:
+//
+//   header      magic "Q2CM", format version, flags, string count, string index offset,
+//               string data offset, string data size, model offset, model size, source file
+//   index       offset (in UTF-16 code units) and length of every string
+//   data        UTF-16LE text of all strings
+//   model       project, its warnings, targets and scopes, strings are table indexes
+//
+// The order of BuildTargetLists and BuildScopeLists is part of the format, changing it needs a new FormatVersion
+
+static const char CacheMagic[4] = { 'Q', '2', 'C', 'M' };
+static const int HeaderWords = 10;
+static const quint32 Flag_QMakeInput = 1;
+
+static quint32 ReadNumber(const uchar *bytes)
+{
+    return static_cast<quint32>(bytes[0]) | (static_cast<quint32>(bytes[1]) << 8)
+           | (static_cast<quint32>(bytes[2]) << 16) | (static_cast<quint32>(bytes[3]) << 24);
+}
+
+static void WriteNumber(QByteArray *output, quint32 value)
+{
+    char bytes[4] = { static_cast<char>(value & 0xff), static_cast<char>((value >> 8) & 0xff),
+                      static_cast<char>((value >> 16) & 0xff), static_cast<char>((value >> 24) & 0xff) };
+    output->append(bytes, 4);
+}
+
+class CacheWriter
+{
+    public:
+        void Number(quint32 value)
+        {
+            WriteNumber(&this->Model, value);
+        }
+        quint32 Intern(const QString &value)
+        {
+            QHash<QString, quint32>::const_iterator it = this->Index.constFind(value);
+            if (it != this->Index.constEnd())
+                return it.value();
+            quint32 index = static_cast<quint32>(this->Strings.size());
+            this->Index.insert(value, index);
+            this->Strings.append(value);
+            return index;
+        }
+        void String(const QString &value)
+        {
+            this->Number(this->Intern(value));
+        }
+        void List(const QList<QString> &values)
+        {
+            this->Number(static_cast<quint32>(values.size()));
+            foreach (const QString &value, values)
+                this->String(value);
+        }
+        void Location(const BuildSourceLocation &location)
+        {
+            this->String(location.FileName);
+            this->Number(static_cast<quint32>(location.LineNumber));
+        }
+
+        QByteArray Model;
+        QList<QString> Strings;
+        QHash<QString, quint32> Index;
+};
+
+class CacheReader
+{
+    public:
+        CacheReader(const uchar *data, qint64 size)
+        {
+            this->Data = data;
+            this->Size = size;
+            this->Position = 0;
+            this->Failed = false;
+        }
+        quint32 Number()
+        {
+            if (this->Failed || this->Position + 4 > this->Size)
+            {
+                this->Failed = true;
+                return 0;
+            }
+            this->Position += 4;
+            return ReadNumber(this->Data + this->Position - 4);
+        }
+        //! Element count that still has to fit into the rest of the model, guards allocations on corrupted input
+        int Count(int bytes_per_item)
+        {
+            quint32 count = this->Number();
+            if (static_cast<qint64>(count) * bytes_per_item > this->Size - this->Position)
+                this->Failed = true;
+            return this->Failed ? 0 : static_cast<int>(count);
+        }
+        QString String()
+        {
+            quint32 index = this->Number();
+            if (index >= static_cast<quint32>(this->Strings.size()))
+            {
+                this->Failed = true;
+                return QString();
+            }
+            return this->Strings.at(static_cast<int>(index));
+        }
+        void List(QList<QString> *values)
+        {
+            int count = this->Count(4);
+            values->reserve(count);
+            for (int i = 0; i < count; i++)
+                values->append(this->String());
+        }
+        BuildSourceLocation Location()
+        {
+            QString file_name = this->String();
+            int line_number = static_cast<int>(this->Number());
+            return BuildSourceLocation(file_name, line_number);
+        }
+
+        const uchar *Data;
+        qint64 Size;
+        qint64 Position;
+        bool Failed;
+        QList<QString> Strings;
+};
+
+ModelCacheInfo::ModelCacheInfo()
+{
+    this->QMakeInput = true;
+}
+
+QByteArray ModelCache::Serialize(const BuildProject &project, const ModelCacheInfo &info)
+{
+    CacheWriter writer;
+    writer.String(project.Name);
+    writer.String(project.CMakeMinimumVersion);
+    writer.List(project.GlobalConfig);
+    writer.List(project.GlobalQtModules);
+
+    writer.Number(static_cast<quint32>(project.Warnings.size()));
+    foreach (const BuildWarning &warning, project.Warnings)
+    {
+        writer.Number(static_cast<quint32>(warning.Code));
+        writer.Number(static_cast<quint32>(warning.Severity));
+        writer.Location(warning.Location);
+        writer.Number(static_cast<quint32>(warning.Column));
+        writer.String(warning.Message);
+        writer.String(warning.Suggestion);
+    }
+
+    writer.Number(static_cast<quint32>(project.Targets.size()));
+    foreach (const BuildTarget &target, project.Targets)
+    {
+        writer.String(target.Name);
+        writer.Number(static_cast<quint32>(target.Type));
+        writer.Location(target.Location);
+        for (const BuildTargetList &list : BuildTargetLists)
+            writer.List(target.*list.List);
+        writer.Number(static_cast<quint32>(target.ConditionalScopes.size()));
+        foreach (const BuildConditionalScope &scope, target.ConditionalScopes)
+        {
+            writer.String(scope.Condition);
+            writer.Number(static_cast<quint32>(scope.Parent + 1));
+            writer.Location(scope.Location);
+            for (const BuildScopeList &list : BuildScopeLists)
+                writer.List(scope.*list.List);
+        }
+    }
+    quint32 source_file = writer.Intern(info.SourceFile);
+
+    QByteArray index;
+    QByteArray text;
+    quint32 offset = 0;
+    foreach (const QString &value, writer.Strings)
+    {
+        WriteNumber(&index, offset);
+        WriteNumber(&index, static_cast<quint32>(value.size()));
+        const QChar *characters = value.constData();
+        for (int i = 0; i < value.size(); i++)
+        {
+            char16_t unit = characters[i].unicode();
+            text.append(static_cast<char>(unit & 0xff));
+            text.append(static_cast<char>(unit >> 8));
+        }
+        offset += static_cast<quint32>(value.size());
+    }
+
+    quint32 index_offset = HeaderWords * 4;
+    quint32 text_offset = index_offset + static_cast<quint32>(index.size());
+    // The model starts on a 4 byte boundary so that its numbers can be read in place
+    int padding = (4 - text.size() % 4) % 4;
+    quint32 model_offset = text_offset + static_cast<quint32>(text.size() + padding);
+
+    QByteArray output(CacheMagic, 4);
+    WriteNumber(&output, ModelCache::FormatVersion);
+    WriteNumber(&output, info.QMakeInput ? Flag_QMakeInput : 0);
+    WriteNumber(&output, static_cast<quint32>(writer.Strings.size()));
+    WriteNumber(&output, index_offset);
+    WriteNumber(&output, text_offset);
+    WriteNumber(&output, static_cast<quint32>(text.size()));
+    WriteNumber(&output, model_offset);
+    WriteNumber(&output, static_cast<quint32>(writer.Model.size()));
+    WriteNumber(&output, source_file);
+    output.reserve(static_cast<int>(model_offset) + writer.Model.size());
+    output.append(index);
+    output.append(text);
+    output.append(QByteArray(padding, '\0'));
+    output.append(writer.Model);
+    return output;
+}
+
+bool ModelCache::Deserialize(const uchar *data, qint64 size, BuildProject *project, ModelCacheInfo *info, QString *error)
+{
+    project->Clear();
+    if (size < HeaderWords * 4 || memcmp(data, CacheMagic, 4) != 0)
+    {
+        *error = "not a q2c model cache";
+        return false;
+    }
+    quint32 version = ReadNumber(data + 4);
+    if (version != ModelCache::FormatVersion)
+    {
+        *error = "model cache format " + QString::number(version) + " is not supported, expected "
+                 + QString::number(ModelCache::FormatVersion) + "; parse the input again";
+        return false;
+    }
+    quint32 flags = ReadNumber(data + 8);
+    quint32 string_count = ReadNumber(data + 12);
+    qint64 index_offset = ReadNumber(data + 16);
+    qint64 text_offset = ReadNumber(data + 20);
+    qint64 text_size = ReadNumber(data + 24);
+    qint64 model_offset = ReadNumber(data + 28);
+    qint64 model_size = ReadNumber(data + 32);
+    quint32 source_file = ReadNumber(data + 36);
+    if (index_offset + static_cast<qint64>(string_count) * 8 > size || text_offset + text_size > size
+        || model_offset + model_size > size || source_file >= string_count)
+    {
+        *error = "model cache is truncated";
+        return false;
+    }
+
+    CacheReader reader(data + model_offset, model_size);
+    reader.Strings.reserve(static_cast<int>(string_count));
+    const uchar *index = data + index_offset;
+    const uchar *text = data + text_offset;
+    for (quint32 i = 0; i < string_count; i++)
+    {
+        qint64 offset = ReadNumber(index + i * 8);
+        qint64 length = ReadNumber(index + i * 8 + 4);
+        if ((offset + length) * 2 > text_size)
+        {
+            *error = "model cache string table is corrupted";
+            return false;
+        }
+        QString value;
+        value.resize(static_cast<int>(length));
+        QChar *characters = value.data();
+        const uchar *bytes = text + offset * 2;
+        for (qint64 j = 0; j < length; j++)
+            characters[j] = QChar(static_cast<char16_t>(bytes[j * 2] | (bytes[j * 2 + 1] << 8)));
+        reader.Strings.append(value);
+    }
+
+    project->Name = reader.String();
+    project->CMakeMinimumVersion = reader.String();
+    reader.List(&project->GlobalConfig);
+    reader.List(&project->GlobalQtModules);
+
+    int warning_count = reader.Count(28);
+    for (int i = 0; i < warning_count && !reader.Failed; i++)
+    {
+        BuildWarning warning;
+        warning.Code = static_cast<BuildWarningCode>(reader.Number());
+        quint32 severity = reader.Number();
+        warning.Severity = severity <= BuildWarningSeverity_Error ? static_cast<BuildWarningSeverity>(severity) : BuildWarningSeverity_Warning;
+        warning.Location = reader.Location();
+        warning.Column = static_cast<int>(reader.Number());
+        warning.Message = reader.String();
+        warning.Suggestion = reader.String();
+        project->AddWarning(warning);
+    }
+
+    int target_count = reader.Count(4 * (5 + static_cast<int>(sizeof(BuildTargetLists) / sizeof(BuildTargetLists[0]))));
+    project->Targets.reserve(target_count);
+    for (int i = 0; i < target_count && !reader.Failed; i++)
+    {
+        BuildTarget target;
+        target.Name = reader.String();
+        quint32 type = reader.Number();
+        target.Type = type <= BuildTarget_Subdirs ? static_cast<BuildTargetType>(type) : BuildTarget_Unknown;
+        target.Location = reader.Location();
+        for (const BuildTargetList &list : BuildTargetLists)
+            reader.List(&(target.*list.List));
+        int scope_count = reader.Count(4 * (4 + static_cast<int>(sizeof(BuildScopeLists) / sizeof(BuildScopeLists[0]))));
+        for (int j = 0; j < scope_count && !reader.Failed; j++)
+        {
+            BuildConditionalScope scope;
+            scope.Condition = reader.String();
+            // Parents come before the scopes nested in them
+            int parent = static_cast<int>(reader.Number()) - 1;
+            scope.Parent = parent >= 0 && parent < j ? parent : -1;
+            scope.Location = reader.Location();
+            for (const BuildScopeList &list : BuildScopeLists)
+                reader.List(&(scope.*list.List));
+            target.ConditionalScopes.append(std::move(scope));
+        }
+        project->Targets.append(std::move(target));
+    }
+
+    if (reader.Failed || reader.Position != reader.Size)
+    {
+        project->Clear();
+        *error = "model cache is corrupted";
+        return false;
+    }
+    info->QMakeInput = (flags & Flag_QMakeInput) != 0;
+    info->SourceFile = reader.Strings.at(static_cast<int>(source_file));
+    return true;
+}
+
+bool ModelCache::Save(const QString &path, const BuildProject &project, const ModelCacheInfo &info, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        *error = "unable to open for writing: " + path;
+        return false;
+    }
+    QByteArray data = ModelCache::Serialize(project, info);
+    if (file.write(data) != data.size())
+    {
+        *error = "unable to write: " + path;
+        return false;
+    }
+    file.close();
+    return true;
+}
+
+bool ModelCache::Load(const QString &path, BuildProject *project, ModelCacheInfo *info, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        *error = "unable to read: " + path;
+        return false;
+    }
+    // Mapping avoids reading the whole cache into a buffer first, files that can
+    // not be mapped are read instead
+    qint64 size = file.size();
+    uchar *mapped = size > 0 ? file.map(0, size) : nullptr;
+    if (mapped != nullptr)
+    {
+        bool result = ModelCache::Deserialize(mapped, size, project, info, error);
+        file.unmap(mapped);
+        return result;
+    }
+    QByteArray contents = file.readAll();
+    return ModelCache::Deserialize(reinterpret_cast<const uchar *>(contents.constData()), contents.size(), project, info, error);
+}
@@ -0,0 +1,44 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef MODELCACHE_H
+#define MODELCACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include "buildmodel.h"
+
+//! Where a cached model came from, restored together with the model
+class ModelCacheInfo
+{
+    public:
+        ModelCacheInfo();
+        bool QMakeInput;    // Model was parsed from qmake, the default output is CMake
+        QString SourceFile; // Project file the model was parsed from
+};
+
+//! Versioned binary snapshot of a BuildProject, written by --save-model and read back
+//! by --load-model so that output can be generated again without parsing the input.
+//! Every string is stored once in a table of UTF-16 text, the model refers to it by
+//! index, so a cache is loaded by mapping the file and copying the strings out of it
+class ModelCache
+{
+    public:
+        //! Bumped whenever the layout changes, caches of other versions are refused
+        static const quint32 FormatVersion = 2;
+
+        static QByteArray Serialize(const BuildProject &project, const ModelCacheInfo &info);
+        //! On failure project is left empty and error says why
+        static bool Deserialize(const uchar *data, qint64 size, BuildProject *project, ModelCacheInfo *info, QString *error);
+        static bool Save(const QString &path, const BuildProject &project, const ModelCacheInfo &info, QString *error);
+        static bool Load(const QString &path, BuildProject *project, ModelCacheInfo *info, QString *error);
+};
+
+#endif // MODELCACHE_H
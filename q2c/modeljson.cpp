@@ -0,0 +1,475 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "modeljson.h"
+#include "warningreport.h"
+
+enum ModelNodeKind
+{
+    ModelNode_None,
+    ModelNode_Project,
+    ModelNode_Target,
+    ModelNode_Scope,
+    ModelNode_Warning,
+    ModelNode_Location,
+    ModelNode_TargetList,
+    ModelNode_ScopeList,
+    ModelNode_WarningList,
+    ModelNode_StringList,
+    ModelNode_String,
+    ModelNode_Number
+};
+
+//! Reference to one value inside the model, nothing is copied except strings the model computes
+class ModelNode
+{
+    public:
+        ModelNode(ModelNodeKind kind = ModelNode_None, const void *object = nullptr)
+        {
+            this->Kind = kind;
+            this->Object = object;
+            this->Number = 0;
+        }
+        bool IsList() const
+        {
+            return this->Kind == ModelNode_TargetList || this->Kind == ModelNode_ScopeList
+                   || this->Kind == ModelNode_WarningList || this->Kind == ModelNode_StringList;
+        }
+
+        ModelNodeKind Kind;
+        const void *Object;
+        QString Text;   // Value of computed strings such as the target type, Object is null then
+        int Number;
+};
+
+static const char *const ProjectFields[] =
+{
+    "Name", "CMakeMinimumVersion", "GlobalConfig", "GlobalQtModules", "Targets", "Warnings", nullptr
+};
+
+// The string lists of targets and scopes are listed in the order of BuildTargetLists and BuildScopeLists
+static const char *const TargetFields[] =
+{
+    "Name", "Type", "Location", "Sources", "Headers", "UiFiles", "ResourceFiles", "TranslationFiles", "QtModules",
+    "Config", "Defines", "IncludePaths", "Libraries", "CompileOptions", "LinkOptions", "PrecompiledHeaders",
+    "InstallRules", "Subdirectories", "ConditionalScopes", nullptr
+};
+
+static const char *const ScopeFields[] =
+{
+    "Condition", "Location", "Sources", "Headers", "UiFiles", "ResourceFiles", "Defines", "IncludePaths", "Libraries",
+    "TranslationFiles", "CompileOptions", "LinkOptions", "InstallRules", "Config", "Parent", nullptr
+};
+
+static const char *const WarningFields[] =
+{
+    "Code", "Severity", "Location", "Column", "Message", "Suggestion", nullptr
+};
+
+static const char *const LocationFields[] =
+{
+    "FileName", "LineNumber", nullptr
+};
+
+static const char *const *FieldsOf(ModelNodeKind kind)
+{
+    switch (kind)
+    {
+        case ModelNode_Project:
+            return ProjectFields;
+        case ModelNode_Target:
+            return TargetFields;
+        case ModelNode_Scope:
+            return ScopeFields;
+        case ModelNode_Warning:
+            return WarningFields;
+        case ModelNode_Location:
+            return LocationFields;
+        default:
+            return nullptr;
+    }
+}
+
+static int FieldIndex(ModelNodeKind kind, QStringView name)
+{
+    const char *const *fields = FieldsOf(kind);
+    if (fields == nullptr)
+        return -1;
+    for (int i = 0; fields[i] != nullptr; i++)
+    {
+        if (name.compare(QLatin1String(fields[i]), Qt::CaseInsensitive) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static ModelNode StringNode(const QString *value)
+{
+    return ModelNode(ModelNode_String, value);
+}
+
+static ModelNode TextNode(const QString &value)
+{
+    ModelNode node(ModelNode_String);
+    node.Text = value;
+    return node;
+}
+
+static ModelNode NumberNode(int value)
+{
+    ModelNode node(ModelNode_Number);
+    node.Number = value;
+    return node;
+}
+
+//! Returns the field with the given index of an object node, the index comes from FieldIndex
+static ModelNode Field(const ModelNode &node, int field)
+{
+    switch (node.Kind)
+    {
+        case ModelNode_Project:
+        {
+            const BuildProject *project = static_cast<const BuildProject*>(node.Object);
+            switch (field)
+            {
+                case 0:
+                    return StringNode(&project->Name);
+                case 1:
+                    return StringNode(&project->CMakeMinimumVersion);
+                case 2:
+                    return ModelNode(ModelNode_StringList, &project->GlobalConfig);
+                case 3:
+                    return ModelNode(ModelNode_StringList, &project->GlobalQtModules);
+                case 4:
+                    return ModelNode(ModelNode_TargetList, &project->Targets);
+                default:
+                    return ModelNode(ModelNode_WarningList, &project->Warnings);
+            }
+        }
+        case ModelNode_Target:
+        {
+            const BuildTarget *target = static_cast<const BuildTarget*>(node.Object);
+            if (field == 0)
+                return StringNode(&target->Name);
+            if (field == 1)
+                return TextNode(target->TypeName());
+            if (field == 2)
+                return ModelNode(ModelNode_Location, &target->Location);
+            if (field == 18)
+                return ModelNode(ModelNode_ScopeList, &target->ConditionalScopes);
+            return ModelNode(ModelNode_StringList, &(target->*BuildTargetLists[field - 3].List));
+        }
+        case ModelNode_Scope:
+        {
+            const BuildConditionalScope *scope = static_cast<const BuildConditionalScope*>(node.Object);
+            if (field == 0)
+                return StringNode(&scope->Condition);
+            if (field == 1)
+                return ModelNode(ModelNode_Location, &scope->Location);
+            if (field == 14)
+                return NumberNode(scope->Parent);
+            return ModelNode(ModelNode_StringList, &(scope->*BuildScopeLists[field - 2].List));
+        }
+        case ModelNode_Warning:
+        {
+            const BuildWarning *warning = static_cast<const BuildWarning*>(node.Object);
+            switch (field)
+            {
+                case 0:
+                    return TextNode(warning->CodeName());
+                case 1:
+                    return TextNode(warning->SeverityName());
+                case 2:
+                    return ModelNode(ModelNode_Location, &warning->Location);
+                case 3:
+                    return NumberNode(warning->Column);
+                case 4:
+                    return StringNode(&warning->Message);
+                default:
+                    return StringNode(&warning->Suggestion);
+            }
+        }
+        case ModelNode_Location:
+        {
+            const BuildSourceLocation *location = static_cast<const BuildSourceLocation*>(node.Object);
+            if (field == 0)
+                return StringNode(&location->FileName);
+            return NumberNode(location->LineNumber);
+        }
+        default:
+            return ModelNode();
+    }
+}
+
+static int ElementCount(const ModelNode &node)
+{
+    switch (node.Kind)
+    {
+        case ModelNode_TargetList:
+            return static_cast<const QList<BuildTarget>*>(node.Object)->size();
+        case ModelNode_ScopeList:
+            return static_cast<const QList<BuildConditionalScope>*>(node.Object)->size();
+        case ModelNode_WarningList:
+            return static_cast<const QList<BuildWarning>*>(node.Object)->size();
+        case ModelNode_StringList:
+            return static_cast<const QList<QString>*>(node.Object)->size();
+        default:
+            return 0;
+    }
+}
+
+static ModelNode Element(const ModelNode &node, int index)
+{
+    switch (node.Kind)
+    {
+        case ModelNode_TargetList:
+            return ModelNode(ModelNode_Target, &static_cast<const QList<BuildTarget>*>(node.Object)->at(index));
+        case ModelNode_ScopeList:
+            return ModelNode(ModelNode_Scope, &static_cast<const QList<BuildConditionalScope>*>(node.Object)->at(index));
+        case ModelNode_WarningList:
+            return ModelNode(ModelNode_Warning, &static_cast<const QList<BuildWarning>*>(node.Object)->at(index));
+        case ModelNode_StringList:
+            return StringNode(&static_cast<const QList<QString>*>(node.Object)->at(index));
+        default:
+            return ModelNode();
+    }
+}
+
+//! Kind of the elements of a list, used to check selectors without any data
+static ModelNodeKind ElementKind(ModelNodeKind kind)
+{
+    switch (kind)
+    {
+        case ModelNode_TargetList:
+            return ModelNode_Target;
+        case ModelNode_ScopeList:
+            return ModelNode_Scope;
+        case ModelNode_WarningList:
+            return ModelNode_Warning;
+        case ModelNode_StringList:
+            return ModelNode_String;
+        default:
+            return ModelNode_None;
+    }
+}
+
+static void WriteNode(const ModelNode &node, QTextStream *out, bool split_lists)
+{
+    switch (node.Kind)
+    {
+        case ModelNode_String:
+            *out << WarningReport::JsonString(node.Object != nullptr ? *static_cast<const QString*>(node.Object) : node.Text);
+            return;
+        case ModelNode_Number:
+            *out << node.Number;
+            return;
+        case ModelNode_None:
+            *out << "null";
+            return;
+        default:
+            break;
+    }
+
+    if (node.IsList())
+    {
+        int count = ElementCount(node);
+        // Targets of the whole document go on their own lines, so a reader can
+        // process them as they arrive instead of waiting for one huge line
+        bool own_lines = split_lists && node.Kind == ModelNode_TargetList && count > 0;
+        *out << "[";
+        for (int i = 0; i < count; i++)
+        {
+            if (i > 0)
+                *out << ",";
+            if (own_lines)
+                *out << "\n";
+            WriteNode(Element(node, i), out, false);
+            if (own_lines)
+                out->flush();
+        }
+        if (own_lines)
+            *out << "\n";
+        *out << "]";
+        return;
+    }
+
+    const char *const *fields = FieldsOf(node.Kind);
+    *out << "{";
+    for (int i = 0; fields[i] != nullptr; i++)
+    {
+        if (i > 0)
+            *out << ",";
+        *out << "\"" << fields[i] << "\":";
+        WriteNode(Field(node, i), out, split_lists);
+    }
+    *out << "}";
+}
+
+class SelectorSegment
+{
+    public:
+        QStringView Name;
+        bool Iterate;   // name[]
+        int Index;      // name[N], -1 when no index was given
+};
+
+static bool ParseSelector(const QString &selector, QList<SelectorSegment> *segments, QString *error)
+{
+    QStringView text(selector);
+    text = text.trimmed();
+    if (text.startsWith(QChar('.')))
+        text = text.mid(1);
+    if (text.isEmpty())
+        return true;
+
+    int start = 0;
+    while (start <= text.size())
+    {
+        int end = text.indexOf(QChar('.'), start);
+        if (end < 0)
+            end = text.size();
+        QStringView part = text.mid(start, end - start);
+        SelectorSegment segment;
+        segment.Iterate = false;
+        segment.Index = -1;
+        int bracket = part.indexOf(QChar('['));
+        segment.Name = bracket < 0 ? part : part.left(bracket);
+        if (bracket >= 0)
+        {
+            if (!part.endsWith(QChar(']')))
+            {
+                *error = "missing ] in selector segment " + part.toString();
+                return false;
+            }
+            QStringView index = part.mid(bracket + 1, part.size() - bracket - 2);
+            if (index.isEmpty())
+            {
+                segment.Iterate = true;
+            } else
+            {
+                bool ok = false;
+                segment.Index = index.toString().toInt(&ok);
+                if (!ok || segment.Index < 0)
+                {
+                    *error = "invalid list index in selector segment " + part.toString();
+                    return false;
+                }
+            }
+        }
+        if (segment.Name.isEmpty())
+        {
+            *error = "empty field name in selector " + selector;
+            return false;
+        }
+        segments->append(segment);
+        start = end + 1;
+    }
+    return true;
+}
+
+//! Walks the selector over node kinds only, so mistakes are reported even when the lists are empty
+static bool CheckSegments(const QList<SelectorSegment> &segments, QString *error)
+{
+    ModelNodeKind kind = ModelNode_Project;
+    BuildProject empty;
+    BuildTarget empty_target;
+    BuildConditionalScope empty_scope;
+    BuildWarning empty_warning;
+    BuildSourceLocation empty_location;
+    for (int i = 0; i < segments.size(); i++)
+    {
+        const SelectorSegment &segment = segments.at(i);
+        int field = FieldIndex(kind, segment.Name);
+        if (field < 0)
+        {
+            *error = "unknown field " + segment.Name.toString();
+            return false;
+        }
+
+        // Field only needs an object of the right type to tell the kind of the child
+        const void *object = &empty;
+        if (kind == ModelNode_Target)
+            object = &empty_target;
+        else if (kind == ModelNode_Scope)
+            object = &empty_scope;
+        else if (kind == ModelNode_Warning)
+            object = &empty_warning;
+        else if (kind == ModelNode_Location)
+            object = &empty_location;
+        ModelNode child = Field(ModelNode(kind, object), field);
+        kind = child.Kind;
+        if (segment.Iterate || segment.Index >= 0)
+        {
+            if (!child.IsList())
+            {
+                *error = segment.Name.toString() + " is not a list";
+                return false;
+            }
+            kind = ElementKind(kind);
+        }
+        else if (child.IsList() && i + 1 < segments.size())
+        {
+            *error = segment.Name.toString() + " is a list, use " + segment.Name.toString() + "[] to select from its elements";
+            return false;
+        }
+    }
+    return true;
+}
+
+static void Select(const ModelNode &node, const QList<SelectorSegment> &segments, int position, QTextStream *out)
+{
+    if (position == segments.size())
+    {
+        WriteNode(node, out, false);
+        *out << "\n";
+        return;
+    }
+
+    const SelectorSegment &segment = segments.at(position);
+    ModelNode child = Field(node, FieldIndex(node.Kind, segment.Name));
+    if (segment.Iterate)
+    {
+        int count = ElementCount(child);
+        for (int i = 0; i < count; i++)
+            Select(Element(child, i), segments, position + 1, out);
+    }
+    else if (segment.Index >= 0)
+    {
+        if (segment.Index < ElementCount(child))
+            Select(Element(child, segment.Index), segments, position + 1, out);
+    }
+    else
+    {
+        Select(child, segments, position + 1, out);
+    }
+}
+
+void ModelJson::Write(const BuildProject &project, QTextStream *out)
+{
+    WriteNode(ModelNode(ModelNode_Project, &project), out, true);
+    *out << "\n";
+    out->flush();
+}
+
+bool ModelJson::IsValidSelector(const QString &selector, QString *error)
+{
+    QList<SelectorSegment> segments;
+    return ParseSelector(selector, &segments, error) && CheckSegments(segments, error);
+}
+
+bool ModelJson::Query(const BuildProject &project, const QString &selector, QTextStream *out, QString *error)
+{
+    QList<SelectorSegment> segments;
+    if (!ParseSelector(selector, &segments, error) || !CheckSegments(segments, error))
+        return false;
+    Select(ModelNode(ModelNode_Project, &project), segments, 0, out);
+    out->flush();
+    return true;
+}
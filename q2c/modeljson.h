@@ -0,0 +1,34 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef MODELJSON_H
+#define MODELJSON_H
+
+#include <QString>
+#include <QTextStream>
+#include "buildmodel.h"
+
+//! Writes a parsed BuildProject as JSON for tools that need the project contents
+//! but not a generated build file. Keys are the names of the model fields.
+class ModelJson
+{
+    public:
+        //! Writes the whole project as a single JSON object followed by a newline,
+        //! targets are written one by one instead of building the document first
+        static void Write(const BuildProject &project, QTextStream *out);
+        //! Checks a selector such as "Targets[].Sources" against the model layout. Segments
+        //! are separated by dots, field names ignore case, "[]" walks every element of a
+        //! list and "[N]" picks one element
+        static bool IsValidSelector(const QString &selector, QString *error);
+        //! Writes every value the selector reaches as compact JSON, one value per line
+        static bool Query(const BuildProject &project, const QString &selector, QTextStream *out, QString *error);
+};
+
+#endif // MODELJSON_H
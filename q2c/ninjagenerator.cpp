@@ -0,0 +1,423 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QRegularExpression>
+#include "ninjagenerator.h"
+
+NinjaGenerator::NinjaGenerator(const QString &directory, const QString &qt_prefix, CMakeQtVersion version) : Flags(qt_prefix)
+{
+    // The standard CMakeGenerator sets when the project does not pick one, Qt 6 headers need C++17
+    this->Flags.DefaultStandard = version == CMakeQtVersion_Qt4 || version == CMakeQtVersion_Qt5 ? "11" : "17";
+    this->Directory = QDir::cleanPath(QDir(directory).absolutePath());
+    this->QtPrefix = qt_prefix;
+    this->Version = version;
+    if (!qt_prefix.isEmpty() && QDir(QDir(qt_prefix).filePath("lib")).exists())
+        this->QtLibraries = QDir::cleanPath(QDir(qt_prefix).filePath("lib"));
+}
+
+QString NinjaGenerator::Generate(const BuildProject &project)
+{
+    QString source = "#-----------------------------------------------------------------\n";
+    source += "# Ninja build file generated from the project model by q2c\n";
+    source += "# https://github.com/benapetr/q2c at " + QDateTime::currentDateTime().toString() + "\n";
+    source += "#-----------------------------------------------------------------\n";
+    foreach (const BuildWarning &warning, project.Warnings)
+        source += "# q2c warning: " + warning.Message + "\n";
+    source += "ninja_required_version = 1.3\n\n";
+    source += this->GenerateRules();
+
+    QStringList defaults;
+    foreach (const BuildTarget &target, project.Targets)
+    {
+        if (target.Type == BuildTarget_Subdirs)
+        {
+            source += "\n# q2c warning: subdirectories of " + target.Name + " need a build.ninja of their own: "
+                      + target.Subdirectories.join(", ") + "\n";
+            continue;
+        }
+        source += this->GenerateTarget(target, &defaults);
+    }
+    if (!defaults.isEmpty())
+        source += "\ndefault " + defaults.join(" ") + "\n";
+    return source;
+}
+
+QString NinjaGenerator::EscapePath(const QString &path)
+{
+    QString escaped;
+    escaped.reserve(path.size());
+    for (QChar c : path)
+    {
+        if (c == '$' || c == ' ' || c == ':')
+            escaped += '$';
+        escaped += c;
+    }
+    return escaped;
+}
+
+QString NinjaGenerator::QuoteArgument(const QString &argument)
+{
+    static const QString plain = "+-_=/.,@%^:";
+    bool safe = !argument.isEmpty();
+    for (QChar c : argument)
+    {
+        if (!c.isLetterOrNumber() && !plain.contains(c))
+        {
+            safe = false;
+            break;
+        }
+    }
+    if (safe)
+        return argument;
+    QString quoted = argument;
+    quoted.replace("'", "'\\''");
+    return "'" + quoted + "'";
+}
+
+QString NinjaGenerator::GenerateRules() const
+{
+    QString rules;
+    rules += "cxx = c++\n";
+    rules += "cc = cc\n";
+    rules += "ar = ar\n";
+    rules += "moc = " + this->QtTool("moc") + "\n";
+    rules += "uic = " + this->QtTool("uic") + "\n";
+    rules += "rcc = " + this->QtTool("rcc") + "\n\n";
+
+    // Arguments go through response files, a target with many defines and include
+    // paths would otherwise run into the command line limit of the platform
+    rules += "rule cxx\n"
+             "  command = $cxx @$out.rsp -MD -MF $out.d -c $in -o $out\n"
+             "  rspfile = $out.rsp\n"
+             "  rspfile_content = $flags\n"
+             "  depfile = $out.d\n"
+             "  deps = gcc\n"
+             "  description = CXX $out\n\n";
+    rules += "rule cc\n"
+             "  command = $cc @$out.rsp -MD -MF $out.d -c $in -o $out\n"
+             "  rspfile = $out.rsp\n"
+             "  rspfile_content = $flags\n"
+             "  depfile = $out.d\n"
+             "  deps = gcc\n"
+             "  description = CC $out\n\n";
+    // moc reads one option per line from @file and ninja writes response files on a
+    // single line, so the moc flags stay on the command line
+    rules += "rule moc\n"
+             "  command = $moc $mocflags $in -o $out\n"
+             "  description = MOC $out\n\n";
+    rules += "rule uic\n"
+             "  command = $uic $in -o $out\n"
+             "  description = UIC $out\n\n";
+    rules += "rule rcc\n"
+             "  command = $rcc --name $name $in -o $out\n"
+             "  description = RCC $out\n\n";
+    rules += "rule link\n"
+             "  command = $cxx @$out.rsp -o $out\n"
+             "  rspfile = $out.rsp\n"
+             "  rspfile_content = $in $ldflags\n"
+             "  description = LINK $out\n\n";
+    rules += "rule link_shared\n"
+             "  command = $cxx -shared @$out.rsp -o $out\n"
+             "  rspfile = $out.rsp\n"
+             "  rspfile_content = $in $ldflags\n"
+             "  description = LINK $out\n\n";
+    rules += "rule archive\n"
+             "  command = $ar rcs $out @$out.rsp\n"
+             "  rspfile = $out.rsp\n"
+             "  rspfile_content = $in\n"
+             "  description = AR $out\n";
+    return rules;
+}
+
+QString NinjaGenerator::GenerateTarget(const BuildTarget &target, QStringList *defaults) const
+{
+    QList<const BuildConditionalScope*> scopes = CompileFlags::HostScopes(target);
+    QString target_directory = target.Name + ".dir";
+    QStringList sources = this->Flags.Sources(target);
+    QHash<QString, QStringList> moc_includes;
+    foreach (const QString &file, sources)
+    {
+        QStringList includes = CompileFlags::IsCSource(file) ? QStringList() : this->MocIncludes(file);
+        if (!includes.isEmpty())
+            moc_includes.insert(file, includes);
+    }
+
+    QStringList cxx_arguments = this->Flags.Arguments(target, false);
+    QString cxx_flags = this->JoinArguments(cxx_arguments);
+    QString c_flags = this->JoinArguments(this->Flags.Arguments(target, true));
+    QStringList moc_arguments;
+    foreach (const QString &argument, cxx_arguments)
+    {
+        if (argument.startsWith("-D") || argument.startsWith("-I"))
+            moc_arguments << argument;
+    }
+
+    QString source = "\n# " + target.TypeName() + " " + target.Name + "\n";
+    QStringList objects;
+
+    // uic headers are included by the sources of the target, so every compile waits for them
+    QStringList ui_headers;
+    QList<QString> ui_files = target.UiFiles;
+    foreach (const BuildConditionalScope *scope, scopes)
+        ui_files.append(scope->UiFiles);
+    foreach (const QString &value, ui_files)
+    {
+        QString file;
+        if (!CompileFlags::ReleaseValue(value, &file))
+            continue;
+        QString header = "ui_" + QFileInfo(file).completeBaseName() + ".h";
+        if (ui_headers.contains(header))
+            continue;
+        ui_headers << header;
+        source += "build " + NinjaGenerator::EscapePath(header) + ": uic " + NinjaGenerator::EscapePath(this->SourcePath(file)) + "\n";
+    }
+    QString order_only;
+    if (!ui_headers.isEmpty())
+    {
+        QStringList escaped;
+        foreach (const QString &header, ui_headers)
+            escaped << NinjaGenerator::EscapePath(header);
+        order_only = " || " + escaped.join(" ");
+    }
+
+    QStringList compiled;
+    foreach (const QString &file, sources)
+    {
+        QString object = this->ObjectPath(target_directory, file);
+        bool c_source = CompileFlags::IsCSource(file);
+        QString moc_outputs;
+        // A source that includes the moc output of its own classes waits for it, it is written
+        // next to the build files like the uic headers so -I. finds it
+        foreach (const QString &moc_output, moc_includes.value(file))
+        {
+            moc_outputs += " " + NinjaGenerator::EscapePath(moc_output);
+            if (compiled.contains(moc_output))
+                continue;
+            compiled << moc_output;
+            source += "build " + NinjaGenerator::EscapePath(moc_output) + ": moc " + NinjaGenerator::EscapePath(this->SourcePath(file)) + "\n";
+            source += "  mocflags = " + this->JoinArguments(moc_arguments) + "\n";
+        }
+        source += "build " + NinjaGenerator::EscapePath(object) + ": " + (c_source ? "cc " : "cxx ")
+                  + NinjaGenerator::EscapePath(this->SourcePath(file)) + (moc_outputs.isEmpty() ? QString() : " |" + moc_outputs)
+                  + order_only + "\n";
+        source += "  flags = " + (c_source ? c_flags : cxx_flags) + "\n";
+        objects << object;
+    }
+
+    QList<QString> headers = target.Headers;
+    foreach (const BuildConditionalScope *scope, scopes)
+        headers.append(scope->Headers);
+    foreach (const QString &value, headers)
+    {
+        QString header;
+        if (!CompileFlags::ReleaseValue(value, &header) || !this->NeedsMoc(header))
+            continue;
+        QString moc_source = target_directory + "/moc_" + QFileInfo(header).completeBaseName() + ".cpp";
+        if (compiled.contains(moc_source))
+            continue;
+        compiled << moc_source;
+        source += "build " + NinjaGenerator::EscapePath(moc_source) + ": moc " + NinjaGenerator::EscapePath(this->SourcePath(header)) + "\n";
+        source += "  mocflags = " + this->JoinArguments(moc_arguments) + "\n";
+        source += "build " + NinjaGenerator::EscapePath(moc_source + ".o") + ": cxx " + NinjaGenerator::EscapePath(moc_source) + order_only + "\n";
+        source += "  flags = " + cxx_flags + "\n";
+        objects << moc_source + ".o";
+    }
+
+    QList<QString> resources = target.ResourceFiles;
+    foreach (const BuildConditionalScope *scope, scopes)
+        resources.append(scope->ResourceFiles);
+    foreach (const QString &value, resources)
+    {
+        QString resource;
+        if (!CompileFlags::ReleaseValue(value, &resource))
+            continue;
+        QString name = QFileInfo(resource).completeBaseName();
+        QString rcc_source = target_directory + "/qrc_" + name + ".cpp";
+        if (compiled.contains(rcc_source))
+            continue;
+        compiled << rcc_source;
+        source += "build " + NinjaGenerator::EscapePath(rcc_source) + ": rcc " + NinjaGenerator::EscapePath(this->SourcePath(resource)) + "\n";
+        source += "  name = " + NinjaGenerator::QuoteArgument(name).replace("$", "$$") + "\n";
+        source += "build " + NinjaGenerator::EscapePath(rcc_source + ".o") + ": cxx " + NinjaGenerator::EscapePath(rcc_source) + "\n";
+        source += "  flags = " + cxx_flags + "\n";
+        objects << rcc_source + ".o";
+    }
+
+    if (objects.isEmpty())
+    {
+        source += "# q2c warning: " + target.Name + " has no sources to compile\n";
+        return source;
+    }
+
+    QString output = this->OutputName(target);
+    QStringList escaped_objects;
+    foreach (const QString &object, objects)
+        escaped_objects << NinjaGenerator::EscapePath(object);
+    source += "build " + NinjaGenerator::EscapePath(output) + ": " + this->LinkRule(target) + " " + escaped_objects.join(" ") + "\n";
+    if (this->LinkRule(target) != "archive")
+        source += "  ldflags = " + this->JoinArguments(this->LinkArguments(target)) + "\n";
+    defaults->append(NinjaGenerator::EscapePath(output));
+    return source;
+}
+
+QString NinjaGenerator::OutputName(const BuildTarget &target) const
+{
+    if (target.Type == BuildTarget_Library || target.Type == BuildTarget_Plugin)
+    {
+        if (this->LinkRule(target) == "archive")
+            return "lib" + target.Name + ".a";
+#if defined(Q_OS_MACOS)
+        return "lib" + target.Name + ".dylib";
+#else
+        return "lib" + target.Name + ".so";
+#endif
+    }
+#if defined(Q_OS_WIN)
+    return target.Name + ".exe";
+#else
+    return target.Name;
+#endif
+}
+
+QString NinjaGenerator::LinkRule(const BuildTarget &target) const
+{
+    if (target.Type != BuildTarget_Library && target.Type != BuildTarget_Plugin)
+        return "link";
+    if (target.Type == BuildTarget_Library && (target.Config.contains("staticlib") || target.Config.contains("static")))
+        return "archive";
+    return "link_shared";
+}
+
+QStringList NinjaGenerator::LinkArguments(const BuildTarget &target) const
+{
+    QStringList arguments;
+    // Link time code generation has to be repeated when linking the objects built with -flto
+    if (target.Config.contains("ltcg"))
+        arguments << "-flto";
+    QList<QString> options = target.LinkOptions;
+    QList<QString> libraries = target.Libraries;
+    foreach (const BuildConditionalScope *scope, CompileFlags::HostScopes(target))
+    {
+        options.append(scope->LinkOptions);
+        libraries.append(scope->Libraries);
+    }
+    foreach (const QString &value, options)
+    {
+        QString option;
+        if (CompileFlags::ReleaseValue(value, &option))
+            arguments << option;
+    }
+
+    for (int i = 0; i < libraries.size(); i++)
+    {
+        QString library;
+        if (!CompileFlags::ReleaseValue(libraries.at(i), &library))
+            continue;
+        if (library == "-framework" && i + 1 < libraries.size())
+            arguments << library << libraries.at(++i);
+        else if (library.startsWith("-framework "))
+            arguments << "-framework" << library.mid(11);
+        else if (library.startsWith("-L"))
+            arguments << "-L" + this->SourcePath(library.mid(2));
+        else if (library.startsWith("-") || library.contains('/') || library.endsWith(".a") || library.endsWith(".so"))
+            arguments << library;
+        else
+            arguments << "-l" + library;   // CMake spelling of a library name
+    }
+
+    if (!target.QtModules.isEmpty() && !this->QtLibraries.isEmpty())
+        arguments << "-L" + this->QtLibraries << "-Wl,-rpath," + this->QtLibraries;
+    QString qt_library = this->Version == CMakeQtVersion_Qt4 ? "Qt" : this->Version == CMakeQtVersion_Qt5 ? "Qt5" : "Qt6";
+    foreach (const QString &module, target.QtModules)
+        arguments << "-l" + qt_library + CompileFlags::QtModuleName(module);
+    return arguments;
+}
+
+QString NinjaGenerator::SourcePath(const QString &file) const
+{
+    return QDir::cleanPath(QDir(this->Directory).absoluteFilePath(file));
+}
+
+QString NinjaGenerator::ObjectPath(const QString &target_directory, const QString &file) const
+{
+    // Objects mirror the source tree below the target directory, parent and absolute paths included
+    QString relative = QDir::cleanPath(file);
+    relative.replace("../", "__/");
+    relative.remove(':');
+    while (relative.startsWith('/'))
+        relative.remove(0, 1);
+    return target_directory + "/" + relative + ".o";
+}
+
+bool NinjaGenerator::NeedsMoc(const QString &header) const
+{
+    QFile file(this->SourcePath(header));
+    // A header that cannot be read is passed to moc anyway, moc only warns when it has nothing to do
+    if (!file.open(QIODevice::ReadOnly))
+        return true;
+    QString text = QString(file.readAll());
+    file.close();
+    return text.contains("Q_OBJECT") || text.contains("Q_GADGET") || text.contains("Q_NAMESPACE");
+}
+
+QStringList NinjaGenerator::MocIncludes(const QString &file) const
+{
+    QStringList includes;
+    QFile source(this->SourcePath(file));
+    if (!source.open(QIODevice::ReadOnly))
+        return includes;
+    QString text = QString(source.readAll());
+    source.close();
+    static const QString extension = ".moc";
+    if (!text.contains(extension))
+        return includes;
+    static const QRegularExpression moc_include("^\\s*#\\s*include\\s*[\"<]([^\">]+\\.moc)[\">]", QRegularExpression::MultilineOption);
+    QRegularExpressionMatchIterator it = moc_include.globalMatch(text);
+    while (it.hasNext())
+    {
+        QString include = it.next().captured(1);
+        if (!includes.contains(include))
+            includes << include;
+    }
+    return includes;
+}
+
+QString NinjaGenerator::QtTool(const QString &name) const
+{
+    if (this->QtPrefix.isEmpty())
+        return name;
+    // Qt 6 keeps its build tools in libexec, Qt 5 and older in bin
+    foreach (const QString &directory, QStringList() << "libexec" << "bin")
+    {
+        QString path = QDir::cleanPath(QDir(this->QtPrefix).filePath(directory + "/" + name));
+        if (QFile::exists(path))
+            return NinjaGenerator::QuoteArgument(path).replace("$", "$$");
+    }
+    return name;
+}
+
+QString NinjaGenerator::JoinArguments(const QStringList &arguments) const
+{
+    QStringList quoted;
+    foreach (const QString &argument, arguments)
+    {
+        QString value = argument;
+        // Include paths are relative to the project file, ninja runs in the build directory
+        if (value.startsWith("-I") && value != "-I." && QDir::isRelativePath(value.mid(2)))
+            value = "-I" + this->SourcePath(value.mid(2));
+        quoted << NinjaGenerator::QuoteArgument(value);
+    }
+    return quoted.join(" ").replace("$", "$$");
+}
@@ -0,0 +1,55 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef NINJAGENERATOR_H
+#define NINJAGENERATOR_H
+
+#include <QString>
+#include <QStringList>
+#include "buildmodel.h"
+#include "cmakegenerator.h"
+#include "compileflags.h"
+
+//! Writes a build.ninja that compiles and links the model for the host without qmake or CMake.
+//! ninja runs in the directory of the generated file, sources are referred to by absolute path
+class NinjaGenerator
+{
+    public:
+        //! directory is where the project file is, qt_prefix is a Qt installation or its include
+        //! directory, version picks the Qt library names (CMakeQtVersion_All links Qt 6)
+        NinjaGenerator(const QString &directory, const QString &qt_prefix, CMakeQtVersion version);
+        QString Generate(const BuildProject &project);
+        //! Escapes a path for the build and input lists of a ninja file
+        static QString EscapePath(const QString &path);
+        //! Quotes an argument for a shell command line or a compiler response file
+        static QString QuoteArgument(const QString &argument);
+
+    private:
+        QString GenerateRules() const;
+        QString GenerateTarget(const BuildTarget &target, QStringList *defaults) const;
+        QString OutputName(const BuildTarget &target) const;
+        QString LinkRule(const BuildTarget &target) const;
+        QStringList LinkArguments(const BuildTarget &target) const;
+        QString SourcePath(const QString &file) const;
+        QString ObjectPath(const QString &target_directory, const QString &file) const;
+        bool NeedsMoc(const QString &header) const;
+        //! Files such as "view.moc" that a source includes to compile the moc output of its own classes
+        QStringList MocIncludes(const QString &file) const;
+        QString QtTool(const QString &name) const;
+        QString JoinArguments(const QStringList &arguments) const;
+
+        QString Directory;
+        QString QtPrefix;
+        QString QtLibraries;   // Directory of the Qt libraries, empty when the linker has to find them
+        CMakeQtVersion Version;
+        CompileFlags Flags;
+};
+
+#endif // NINJAGENERATOR_H
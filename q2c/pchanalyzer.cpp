@@ -0,0 +1,244 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <algorithm>
+#include <cmath>
+#include "compileflags.h"
+#include "pchanalyzer.h"
+#include "sourcescan.h"
+
+PchSuggestion::PchSuggestion()
+{
+    this->Units = 0;
+    this->CoveredUnits = 0;
+    this->Includes = 0;
+    this->CoveredIncludes = 0;
+}
+
+static int Percent(int part, int total)
+{
+    return total > 0 ? part * 100 / total : 0;
+}
+
+QString PchSuggestion::HeaderText() const
+{
+    QString text = "// Precompiled header for " + this->Target + ", suggested by q2c --suggest-pch\n";
+    text += QString("// Used by %1 of %2 translation units, %3% of their include directives\n")
+            .arg(this->CoveredUnits).arg(this->Units).arg(Percent(this->CoveredIncludes, this->Includes));
+    text += "#if defined(__cplusplus)\n";
+    foreach (const PchHeader &header, this->Headers)
+        text += "#include " + header.Include + "\n";
+    text += "#endif\n";
+    return text;
+}
+
+QString PchSuggestion::Report() const
+{
+    if (this->Headers.isEmpty())
+    {
+        return QString("No header is shared by enough of the %1 translation units of %2 for a precompiled header\n")
+               .arg(this->Units).arg(this->Target);
+    }
+    QString report = QString("Precompiled header %1 for %2: %3 headers used by %4 of %5 translation units, %6% of %7 include directives\n")
+                     .arg(this->FileName).arg(this->Target).arg(this->Headers.size()).arg(this->CoveredUnits).arg(this->Units)
+                     .arg(Percent(this->CoveredIncludes, this->Includes)).arg(this->Includes);
+    foreach (const PchHeader &header, this->Headers)
+        report += "  " + header.Include.leftJustified(40) + QString::number(header.Units).rightJustified(8) + " units\n";
+    return report;
+}
+
+class PchSourceScan
+{
+    public:
+        QString Path;
+        bool Read;
+        QStringList Includes;
+};
+
+class PchScanner : public SourceScanner
+{
+    public:
+        PchScanner(QList<PchSourceScan> *scans)
+        {
+            this->Scans = scans;
+        }
+
+        void ScanText(int index, const QString &text) override
+        {
+            PchSourceScan &scan = (*this->Scans)[index];
+            scan.Read = true;
+            scan.Includes = PchAnalyzer::ReadIncludes(text);
+        }
+
+    private:
+        QList<PchSourceScan> *Scans;
+};
+
+PchAnalyzer::PchAnalyzer(const QString &directory)
+{
+    this->Directory = QDir::cleanPath(QDir(directory).absolutePath());
+    this->MinimumShare = 0.5;
+    this->MaximumHeaders = 24;
+}
+
+QStringList PchAnalyzer::ReadIncludes(const QString &text)
+{
+    // Includes inside #if blocks depend on the platform or the configuration, a precompiled
+    // header that pulls them in unconditionally could break the build where they are missing
+    QStringList includes;
+    int conditional_depth = 0;
+    foreach (const QString &raw_line, text.split('\n'))
+    {
+        QString line = raw_line.trimmed();
+        if (!line.startsWith('#'))
+            continue;
+        line = line.mid(1).trimmed();
+        if (line.startsWith("if"))
+            conditional_depth++;
+        else if (line.startsWith("endif"))
+            conditional_depth = qMax(0, conditional_depth - 1);
+        if (conditional_depth > 0 || !line.startsWith("include"))
+            continue;
+        line = line.mid(7).trimmed();
+        if (line.isEmpty())
+            continue;
+        QChar close = line.at(0) == '<' ? QChar('>') : QChar('"');
+        if (line.at(0) != '<' && line.at(0) != '"')
+            continue;
+        int end = line.indexOf(close, 1);
+        if (end > 1)
+            includes.append(line.left(end + 1));
+    }
+    return includes;
+}
+
+bool PchAnalyzer::IsGeneratedHeader(const QString &name)
+{
+    QString file = QFileInfo(name).fileName();
+    return file.startsWith("ui_") || file.startsWith("moc_") || file.startsWith("qrc_") || file.endsWith(".moc");
+}
+
+QString PchAnalyzer::ResolveInclude(const QString &include, const QString &source_directory, const QStringList &include_paths) const
+{
+    QString name = include.mid(1, include.size() - 2);
+    QStringList directories;
+    if (include.startsWith('"'))
+        directories << source_directory << this->Directory;
+    directories << include_paths;
+    foreach (const QString &directory, directories)
+    {
+        QString path = QDir::cleanPath(QDir(directory).absoluteFilePath(name));
+        if (QFileInfo(path).isFile())
+            return path;
+    }
+    return "";
+}
+
+PchSuggestion PchAnalyzer::Analyze(const BuildTarget &target) const
+{
+    PchSuggestion suggestion;
+    suggestion.Target = target.Name;
+    suggestion.FileName = target.Name + "_pch.h";
+
+    QList<PchSourceScan> scans;
+    foreach (const QString &source, target.Sources)
+    {
+        if (!CompileFlags::IsCompiledSource(source) || CompileFlags::IsCSource(source))
+            continue;
+        PchSourceScan scan;
+        scan.Path = QDir::cleanPath(QDir(this->Directory).absoluteFilePath(source));
+        scan.Read = false;
+        scans.append(scan);
+    }
+
+    QStringList paths;
+    foreach (const PchSourceScan &scan, scans)
+        paths << scan.Path;
+    PchScanner(&scans).ReadFiles(paths);
+
+    QStringList include_paths;
+    foreach (const QString &path, target.IncludePaths)
+        include_paths << QDir::cleanPath(QDir(this->Directory).absoluteFilePath(path));
+    QSet<QString> own_headers;
+    foreach (const QString &header, target.Headers)
+        own_headers.insert(QDir::cleanPath(QDir(this->Directory).absoluteFilePath(header)));
+
+    // Headers are keyed by the include that reaches them from a header in the project directory,
+    // so "util.h" of two different source directories are counted apart
+    QHash<QString, int> units_by_header;
+    QList<QStringList> unit_headers;
+    foreach (const PchSourceScan &scan, scans)
+    {
+        if (!scan.Read)
+            continue;
+        suggestion.Units++;
+        suggestion.Includes += scan.Includes.size();
+        QString source_directory = QFileInfo(scan.Path).absolutePath();
+        QStringList headers;
+        foreach (const QString &include, scan.Includes)
+        {
+            if (IsGeneratedHeader(include.mid(1, include.size() - 2)))
+                continue;
+            QString resolved = this->ResolveInclude(include, source_directory, include_paths);
+            if (own_headers.contains(resolved))
+                continue;
+            QString key = include;
+            if (include.startsWith('"'))
+            {
+                // Quoted headers that are not on disk are most likely generated during the build
+                if (resolved.isEmpty())
+                    continue;
+                key = "\"" + QDir(this->Directory).relativeFilePath(resolved) + "\"";
+            }
+            if (!headers.contains(key))
+                units_by_header[key]++;
+            headers.append(key);
+        }
+        unit_headers.append(headers);
+    }
+
+    int minimum_units = qMax(2, static_cast<int>(std::ceil(this->MinimumShare * suggestion.Units)));
+    for (auto it = units_by_header.constBegin(); it != units_by_header.constEnd(); ++it)
+    {
+        if (it.value() < minimum_units)
+            continue;
+        PchHeader header;
+        header.Include = it.key();
+        header.Units = it.value();
+        suggestion.Headers.append(header);
+    }
+    std::sort(suggestion.Headers.begin(), suggestion.Headers.end(), [](const PchHeader &a, const PchHeader &b)
+    {
+        return a.Units != b.Units ? a.Units > b.Units : a.Include < b.Include;
+    });
+    while (suggestion.Headers.size() > this->MaximumHeaders)
+        suggestion.Headers.removeLast();
+
+    QSet<QString> chosen;
+    foreach (const PchHeader &header, suggestion.Headers)
+        chosen.insert(header.Include);
+    foreach (const QStringList &headers, unit_headers)
+    {
+        int covered = 0;
+        foreach (const QString &header, headers)
+        {
+            if (chosen.contains(header))
+                covered++;
+        }
+        suggestion.CoveredIncludes += covered;
+        if (covered > 0)
+            suggestion.CoveredUnits++;
+    }
+    return suggestion;
+}
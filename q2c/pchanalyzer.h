@@ -0,0 +1,67 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef PCHANALYZER_H
+#define PCHANALYZER_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include "buildmodel.h"
+
+class PchHeader
+{
+    public:
+        QString Include;    // As it goes into the generated header, with <> or ""
+        int Units;          // Translation units that include it
+};
+
+//! Headers picked for a generated precompiled header and how much of the target they cover
+class PchSuggestion
+{
+    public:
+        PchSuggestion();
+        //! Text of the generated header, C sources skip it
+        QString HeaderText() const;
+        //! Human readable summary with the coverage estimate
+        QString Report() const;
+
+        QString Target;
+        QString FileName;           // <target>_pch.h
+        QList<PchHeader> Headers;
+        int Units;                  // Translation units that were read
+        int CoveredUnits;           // Units that include at least one of the headers
+        int Includes;               // Include directives of all units
+        int CoveredIncludes;        // Directives the precompiled header takes care of
+};
+
+//! Counts the direct includes of the sources of a target and picks the stable ones most units share
+class PchAnalyzer
+{
+    public:
+        //! directory is where the project file is, sources and include paths are relative to it
+        PchAnalyzer(const QString &directory);
+        //! Reads the C++ sources of the target in parallel, unreadable sources are skipped
+        PchSuggestion Analyze(const BuildTarget &target) const;
+        //! Include directives of a source as written, "name" or <name>, outside of #if blocks
+        static QStringList ReadIncludes(const QString &text);
+        //! moc, uic and rcc output, these change with the project and are never precompiled
+        static bool IsGeneratedHeader(const QString &name);
+
+        double MinimumShare;    // Part of the units that has to include a header
+        int MaximumHeaders;
+
+    private:
+        QString ResolveInclude(const QString &include, const QString &source_directory, const QStringList &include_paths) const;
+
+        QString Directory;
+};
+
+#endif // PCHANALYZER_H
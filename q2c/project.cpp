@@ -8,16 +8,84 @@
 //MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
 //GNU General Public License for more details.
 
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
 #include "project.h"
 #include "cmakeparser.h"
+#include "cmakepresetsgenerator.h"
+#include "compilecommandsgenerator.h"
 #include "configuration.h"
+#include "logs.h"
+#include "modelcache.h"
+#include "ninjagenerator.h"
 #include "qmakegenerator.h"
 #include "qmakeparser.h"
 
+ProjectOutput::ProjectOutput()
+{
+    this->Format = ProjectOutput_CMake;
+    this->Version = CMakeQtVersion_All;
+}
+
+bool ProjectOutput::Parse(const QString &spec, ProjectOutput *output, QString *error)
+{
+    int separator = spec.indexOf(':');
+    if (separator <= 0 || separator == spec.size() - 1)
+    {
+        *error = "expected KIND:FILE, got " + spec;
+        return false;
+    }
+    QString kind = spec.left(separator).toLower();
+    output->FileName = spec.mid(separator + 1);
+    output->Format = ProjectOutput_CMake;
+    if (kind == "qt4")
+        output->Version = CMakeQtVersion_Qt4;
+    else if (kind == "qt5")
+        output->Version = CMakeQtVersion_Qt5;
+    else if (kind == "qt6")
+        output->Version = CMakeQtVersion_Qt6;
+    else if (kind == "cmake")
+        output->Version = CMakeQtVersion_All;
+    else if (kind == "qmake")
+        output->Format = ProjectOutput_QMake;
+    else if (kind == "compile-commands")
+        output->Format = ProjectOutput_CompileCommands;
+    else if (kind == "ninja")
+        output->Format = ProjectOutput_Ninja;
+    else if (kind == "presets")
+        output->Format = ProjectOutput_CMakePresets;
+    else
+    {
+        *error = "unknown output kind " + kind + ", use qt4, qt5, qt6, cmake, qmake, compile-commands, ninja or presets";
+        return false;
+    }
+    return true;
+}
+
+class ProjectOutputJob : public QRunnable
+{
+    public:
+        ProjectOutputJob(const Project *project, ProjectOutput *output)
+        {
+            this->Source = project;
+            this->Output = output;
+        }
+
+        void run() override
+        {
+            this->Output->Text = this->Source->GenerateOutput(*this->Output);
+        }
+
+    private:
+        const Project *Source;
+        ProjectOutput *Output;
+};
+
 Project::Project()
 {
     this->ProjectName = "";
-    this->CMakeMinumumVersion = "VERSION 3.1.0";
     this->Version = CMakeQtVersion_All;
     if (Configuration::only_qt4)
     {
@@ -28,8 +96,8 @@ Project::Project()
     } else if (Configuration::only_qt6)
     {
         this->Version = CMakeQtVersion_Qt6;
-        this->CMakeMinumumVersion = "VERSION 3.16.0";
     }
+    this->CMakeMinumumVersion = Project::DefaultCMakeMinimumVersion(this->Version);
     this->Model.CMakeMinimumVersion = this->CMakeMinumumVersion;
 }
 
@@ -55,11 +123,46 @@ bool Project::ParseCmake(QString text)
     CMakeParser parser;
     if (!parser.Parse(text, &this->Model, Configuration::InputFile))
         return false;
+    this->CommandStats = parser.GetCommandStats();
 
     this->ProjectName = this->Model.Name;
     return true;
 }
 
+bool Project::SaveModel(const QString &path)
+{
+    ModelCacheInfo info;
+    info.QMakeInput = Configuration::q2c;
+    info.SourceFile = Configuration::InputFile;
+    QString error;
+    if (!ModelCache::Save(path, this->Model, info, &error))
+    {
+        Logs::ErrorLog("Unable to save model: " + error);
+        return false;
+    }
+    return true;
+}
+
+bool Project::LoadModel(const QString &path)
+{
+    ModelCacheInfo info;
+    QString error;
+    if (!ModelCache::Load(path, &this->Model, &info, &error))
+    {
+        Logs::ErrorLog("Unable to load model from " + path + ": " + error);
+        return false;
+    }
+    if (!Configuration::direction_explicit)
+        Configuration::q2c = info.QMakeInput;
+    if (Configuration::InputFile.isEmpty())
+        Configuration::InputFile = info.SourceFile;
+    // The qmake parser only records the minimum CMake version of the Qt choice it ran with
+    if (info.QMakeInput)
+        this->Model.CMakeMinimumVersion = this->CMakeMinumumVersion;
+    this->ProjectName = this->Model.Name;
+    return true;
+}
+
 QString Project::ToQmake()
 {
     QMakeGenerator generator;
@@ -69,9 +172,81 @@ QString Project::ToQmake()
 QString Project::ToCmake()
 {
     CMakeGenerator generator(this->Version);
+    generator.SetUnityPlan(this->Unity);
     return generator.Generate(this->Model, this->CMakeOptions);
 }
 
+void Project::GenerateOutputs(QList<ProjectOutput> *outputs)
+{
+    if (outputs->size() == 1)
+    {
+        (*outputs)[0].Text = this->GenerateOutput(outputs->at(0));
+        return;
+    }
+
+    // Generators only read the model, so every output gets its own thread and writes its own text
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMin(static_cast<int>(outputs->size()), QThread::idealThreadCount()));
+    for (int i = 0; i < outputs->size(); i++)
+        pool.start(new ProjectOutputJob(this, &(*outputs)[i]));
+    pool.waitForDone();
+}
+
+QString Project::GenerateOutput(const ProjectOutput &output) const
+{
+    if (output.Format == ProjectOutput_QMake)
+        return QMakeGenerator().Generate(this->Model);
+    QString qt_prefix = Configuration::QtPrefix.isEmpty() ? qEnvironmentVariable("QTDIR") : Configuration::QtPrefix;
+    if (output.Format == ProjectOutput_CMakePresets)
+        return CMakePresetsGenerator(this->Version, qt_prefix).Generate(this->Model, this->CMakeOptions);
+    if (output.Format == ProjectOutput_CompileCommands || output.Format == ProjectOutput_Ninja)
+    {
+        QString directory = QFileInfo(Configuration::InputFile).absolutePath();
+        if (output.Format == ProjectOutput_Ninja)
+            return NinjaGenerator(directory, qt_prefix, this->Version).Generate(this->Model);
+        return CompileCommandsGenerator(directory, qt_prefix).Generate(this->Model);
+    }
+
+    CMakeGenerator generator(output.Version);
+    generator.SetUnityPlan(this->Unity);
+    // The qmake parser stored the minimum version of the Qt choice on the command line
+    if (Configuration::q2c)
+        generator.SetMinimumVersion(Project::DefaultCMakeMinimumVersion(output.Version));
+    return generator.Generate(this->Model, this->CMakeOptions);
+}
+
+PchSuggestion Project::SuggestPrecompiledHeader()
+{
+    BuildTarget *target = this->Model.PrimaryTarget();
+    if (target == nullptr)
+        return PchSuggestion();
+    PchSuggestion suggestion = PchAnalyzer(QFileInfo(Configuration::InputFile).absolutePath()).Analyze(*target);
+    if (!suggestion.Headers.isEmpty())
+        target->PrecompiledHeaders.append(suggestion.FileName);
+    return suggestion;
+}
+
+UnityPlan Project::PlanUnityBuild(int batch_size)
+{
+    const BuildTarget *target = this->Model.PrimaryTarget();
+    if (target == nullptr)
+        return UnityPlan();
+    this->Unity = UnityPlanner(QFileInfo(Configuration::InputFile).absolutePath(), batch_size).Plan(*target);
+    return this->Unity;
+}
+
+bool Project::VerifyRoundTrip(QList<RoundTripDifference> *differences)
+{
+    return RoundTrip::Verify(this->Model, Configuration::q2c, this->Version, this->CMakeOptions, differences);
+}
+
+QString Project::DefaultCMakeMinimumVersion(CMakeQtVersion version)
+{
+    if (version == CMakeQtVersion_Qt6)
+        return "VERSION 3.16.0";
+    return "VERSION 3.1.0";
+}
+
 const BuildProject &Project::GetModel() const
 {
     return this->Model;
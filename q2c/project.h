@@ -15,6 +15,32 @@
 #include <QList>
 #include "buildmodel.h"
 #include "cmakegenerator.h"
+#include "cmakeparser.h"
+#include "pchanalyzer.h"
+#include "roundtrip.h"
+
+enum ProjectOutputFormat
+{
+    ProjectOutput_CMake,
+    ProjectOutput_QMake,
+    ProjectOutput_CompileCommands,
+    ProjectOutput_Ninja,
+    ProjectOutput_CMakePresets
+};
+
+//! One generated file of a --emit run, several of them share one parsed model
+class ProjectOutput
+{
+    public:
+        ProjectOutput();
+        //! Reads "KIND:FILE" where KIND is qt4, qt5, qt6, cmake (all Qt versions), qmake, compile-commands, ninja or presets
+        static bool Parse(const QString &spec, ProjectOutput *output, QString *error);
+
+        ProjectOutputFormat Format;
+        CMakeQtVersion Version;     // Only used by CMake outputs
+        QString FileName;
+        QString Text;  // Filled by Project::GenerateOutputs()
+};
 
 class Project
 {
@@ -23,15 +49,33 @@ class Project
         bool Load(QString text);
         bool ParseQmake(QString text);
         bool ParseCmake(QString text);
+        //! Writes the model to a cache file that LoadModel() reads back
+        bool SaveModel(const QString &path);
+        //! Replaces the model with a cached one, sets the conversion direction unless it was given explicitly
+        bool LoadModel(const QString &path);
         QString ToQmake();
         QString ToCmake();
+        //! Runs one generator per output over the parsed model, outputs are generated in parallel
+        void GenerateOutputs(QList<ProjectOutput> *outputs);
+        //! Text of a single output, safe to call from several threads at once
+        QString GenerateOutput(const ProjectOutput &output) const;
+        //! Converts the model to the other format, parses it back and lists what did not survive
+        bool VerifyRoundTrip(QList<RoundTripDifference> *differences);
+        //! Picks a precompiled header for the primary target and adds it to the model when headers were found
+        PchSuggestion SuggestPrecompiledHeader();
+        //! Plans unity batches for the primary target, CMake output uses them from then on
+        UnityPlan PlanUnityBuild(int batch_size);
+        //! Minimum CMake version the qmake conversion asks for with the given Qt choice
+        static QString DefaultCMakeMinimumVersion(CMakeQtVersion version);
         QList<CMakeOption> CMakeOptions;
         CMakeQtVersion Version;
         QString ProjectName;
         QString CMakeMinumumVersion;
+        QList<CMakeCommandStat> CommandStats; // Filled when the input is CMake
         const BuildProject &GetModel() const;
     private:
         BuildProject Model;
+        UnityPlan Unity;
 };
 
 #endif // PROJECT_H
@@ -21,11 +21,25 @@ SOURCES += main.cpp \
     configuration.cpp \
     project.cpp \
     logs.cpp \
+    memoryreport.cpp \
+    modelcache.cpp \
+    modeljson.cpp \
     generic.cpp \
     buildmodel.cpp \
+    charscanner.cpp \
     qmakeparser.cpp \
+    roundtrip.cpp \
+    tokenview.cpp \
+    warningreport.cpp \
     cmakeparser.cpp \
+    cmakepresetsgenerator.cpp \
     cmakegenerator.cpp \
+    compilecommandsgenerator.cpp \
+    compileflags.cpp \
+    ninjagenerator.cpp \
+    pchanalyzer.cpp \
+    sourcescan.cpp \
+    unityplanner.cpp \
     qmakegenerator.cpp
 
 HEADERS += \
@@ -33,9 +47,28 @@ HEADERS += \
     configuration.h \
     project.h \
     logs.h \
+    memoryreport.h \
+    modelcache.h \
+    modeljson.h \
     generic.h \
     buildmodel.h \
+    charscanner.h \
     qmakeparser.h \
+    roundtrip.h \
+    tokenview.h \
+    warningreport.h \
     cmakeparser.h \
+    cmakepresetsgenerator.h \
     cmakegenerator.h \
+    compilecommandsgenerator.h \
+    compileflags.h \
+    ninjagenerator.h \
+    pchanalyzer.h \
+    sourcescan.h \
+    unityplanner.h \
     qmakegenerator.h
+
+# qmake CONFIG+=count_allocations, counterpart of -DQ2C_COUNT_ALLOCATIONS=ON
+count_allocations {
+    SOURCES += allocationcounter.cpp
+}
@@ -12,6 +12,73 @@
 #include <QDateTime>
 #include <QRegularExpression>
 
+static const QString BuildConfigRelease = "release";
+static const QString BuildConfigDebug = "debug";
+static const QString UnsupportedScopeComment = "# ";
+static const int MaximumScopeIndentation = 32;
+
+// Splits $<condition:value> of a build configuration into the configuration and the
+// value, the outer expression has to span the whole item. Plain $<CONFIG:Release> of
+// hand written CMake counts as release as well
+static bool SplitBuildConfig(const QString &item, QString *config, QString *value)
+{
+    static const QString release_prefix = "$<" + BuildConfig::Release + ":";
+    static const QString debug_prefix = "$<" + BuildConfig::Debug + ":";
+    static const QString plain_release_prefix = "$<$<CONFIG:Release>:";
+    int prefix_size = 0;
+    if (item.startsWith(release_prefix, Qt::CaseInsensitive))
+    {
+        prefix_size = static_cast<int>(release_prefix.size());
+        *config = BuildConfigRelease;
+    }
+    else if (item.startsWith(plain_release_prefix, Qt::CaseInsensitive))
+    {
+        prefix_size = static_cast<int>(plain_release_prefix.size());
+        *config = BuildConfigRelease;
+    }
+    else if (item.startsWith(debug_prefix, Qt::CaseInsensitive))
+    {
+        prefix_size = static_cast<int>(debug_prefix.size());
+        *config = BuildConfigDebug;
+    }
+    if (prefix_size == 0 || !item.endsWith('>'))
+        return false;
+    int depth = 1;
+    for (int i = prefix_size; i < item.size() - 1; i++)
+    {
+        if (item[i] == '$' && item[i + 1] == '<')
+            depth++;
+        else if (item[i] == '>' && --depth == 0)
+            return false;
+    }
+    *value = item.mid(prefix_size, item.size() - prefix_size - 1);
+    return true;
+}
+
+// Values of one build configuration, or with an empty config the values that are not tied to one
+static QList<QString> BuildConfigValues(const QList<QString> &items, const QString &config)
+{
+    static const QString prefix = "$<$<";
+    bool has_config = false;
+    for (const QString &item : items)
+        has_config = has_config || item.startsWith(prefix);
+    if (!has_config)
+        return config.isEmpty() ? items : QList<QString>();
+
+    QList<QString> result;
+    for (const QString &item : items)
+    {
+        QString item_config;
+        QString value;
+        bool split = SplitBuildConfig(item, &item_config, &value);
+        if (config.isEmpty() && !split)
+            result << item;
+        else if (split && item_config == config)
+            result << value;
+    }
+    return result;
+}
+
 QString QMakeGenerator::Generate(const BuildProject &project)
 {
     const BuildTarget *primary = project.PrimaryTarget();
@@ -20,8 +87,8 @@ QString QMakeGenerator::Generate(const BuildProject &project)
     source += "# Project converted from cmake file using q2c\n";
     source += "# https://github.com/benapetr/q2c at " + QDateTime::currentDateTime().toString() + "\n";
     source += "#-----------------------------------------------------------------\n";
-    foreach (QString warning, project.Warnings)
-        source += "# q2c warning: " + warning + "\n";
+    foreach (const BuildWarning &warning, project.Warnings)
+        source += "# q2c warning: " + warning.Message + "\n";
 
     if (primary == nullptr)
     {
@@ -56,21 +123,32 @@ QString QMakeGenerator::GenerateAssignments(const BuildTarget &target)
         config.append("plugin");
     if (target.Type == BuildTarget_Test && !config.contains("testcase"))
         config.append("testcase");
+    if (!target.PrecompiledHeaders.isEmpty() && !config.contains("precompile_header"))
+        config.append("precompile_header");
 
     source += this->Assignment("QT", target.QtModules);
     source += this->Assignment("CONFIG", config);
-    source += this->Assignment("DEFINES", target.Defines);
-    source += this->Assignment("INCLUDEPATH", target.IncludePaths);
-    source += this->Assignment("SOURCES", target.Sources);
-    source += this->Assignment("HEADERS", target.Headers);
-    source += this->Assignment("FORMS", target.UiFiles);
-    source += this->Assignment("RESOURCES", target.ResourceFiles);
+    source += this->Assignment("DEFINES", BuildConfigValues(target.Defines, QString()));
+    source += this->Assignment("INCLUDEPATH", BuildConfigValues(target.IncludePaths, QString()));
+    source += this->Assignment("SOURCES", BuildConfigValues(target.Sources, QString()));
+    source += this->Assignment("HEADERS", BuildConfigValues(target.Headers, QString()));
+    // qmake takes a single header, the CMake parser warns about the others
+    if (!target.PrecompiledHeaders.isEmpty())
+        source += "PRECOMPILED_HEADER = " + this->Quote(target.PrecompiledHeaders.first()) + "\n";
+    source += this->Assignment("FORMS", BuildConfigValues(target.UiFiles, QString()));
+    source += this->Assignment("RESOURCES", BuildConfigValues(target.ResourceFiles, QString()));
     source += this->Assignment("TRANSLATIONS", target.TranslationFiles);
     source += this->Assignment("LIBS", this->LibrariesForQmake(target.Libraries));
     source += this->Assignment("QMAKE_CXXFLAGS", this->CompileOptionsForQmake(target.CompileOptions));
+    source += this->Assignment("QMAKE_CXXFLAGS_RELEASE", BuildConfigValues(target.CompileOptions, BuildConfigRelease));
+    source += this->Assignment("QMAKE_CXXFLAGS_DEBUG", BuildConfigValues(target.CompileOptions, BuildConfigDebug));
     source += this->Assignment("QMAKE_LFLAGS", this->LinkOptionsForQmake(target.LinkOptions));
+    source += this->Assignment("QMAKE_LFLAGS_RELEASE", BuildConfigValues(target.LinkOptions, BuildConfigRelease));
+    source += this->Assignment("QMAKE_LFLAGS_DEBUG", BuildConfigValues(target.LinkOptions, BuildConfigDebug));
     source += this->Assignment("INSTALLS", target.InstallRules);
     source += this->Assignment("SUBDIRS", target.Subdirectories);
+    source += this->GenerateBuildConfigScope(target, BuildConfigRelease);
+    source += this->GenerateBuildConfigScope(target, BuildConfigDebug);
 
     if (this->HasUnsupportedGeneratorExpression(target.Sources) ||
         this->HasUnsupportedGeneratorExpression(target.Headers) ||
@@ -85,35 +163,92 @@ QString QMakeGenerator::GenerateAssignments(const BuildTarget &target)
     return source;
 }
 
+QString QMakeGenerator::GenerateBuildConfigScope(const BuildTarget &target, const QString &config)
+{
+    QList<QString> sources = BuildConfigValues(target.Sources, config);
+    QList<QString> headers = BuildConfigValues(target.Headers, config);
+    QList<QString> ui_files = BuildConfigValues(target.UiFiles, config);
+    QList<QString> resource_files = BuildConfigValues(target.ResourceFiles, config);
+    QList<QString> defines = BuildConfigValues(target.Defines, config);
+    QList<QString> include_paths = BuildConfigValues(target.IncludePaths, config);
+    QStringList libraries = this->LibrariesForQmake(BuildConfigValues(target.Libraries, config));
+    if (sources.isEmpty() && headers.isEmpty() && ui_files.isEmpty() && resource_files.isEmpty()
+        && defines.isEmpty() && include_paths.isEmpty() && libraries.isEmpty())
+        return "";
+
+    QString block;
+    block += this->ScopedAssignment("SOURCES", sources);
+    block += this->ScopedAssignment("HEADERS", headers);
+    block += this->ScopedAssignment("FORMS", ui_files);
+    block += this->ScopedAssignment("RESOURCES", resource_files);
+    block += this->ScopedAssignment("DEFINES", defines);
+    block += this->ScopedAssignment("INCLUDEPATH", include_paths);
+    block += this->ScopedAssignment("LIBS", libraries);
+    return "CONFIG(" + config + ", debug|release) {\n" + block + "}\n";
+}
+
 QString QMakeGenerator::GenerateConditionalScopes(const BuildTarget &target)
 {
-    QString source;
-    foreach (const BuildConditionalScope &scope, target.ConditionalScopes)
+    // Nested scopes of a CMake input are written inside the block of their parent
+    QList<QList<int>> children;
+    children.reserve(target.ConditionalScopes.size());
+    QList<int> roots;
+    for (int i = 0; i < target.ConditionalScopes.size(); i++)
     {
-        bool supported = true;
-        QString condition = this->MapCondition(scope.Condition, &supported);
-        QString block;
-        if (!supported)
-            source += "# q2c warning: Unsupported CMake condition for qmake scope: " + scope.Condition + "\n";
-
-        block += condition + " {\n";
-        block += this->ScopedAssignment("SOURCES", scope.Sources);
-        block += this->ScopedAssignment("HEADERS", scope.Headers);
-        block += this->ScopedAssignment("DEFINES", scope.Defines);
-        block += this->ScopedAssignment("INCLUDEPATH", scope.IncludePaths);
-        block += this->ScopedAssignment("LIBS", this->LibrariesForQmake(scope.Libraries));
-        block += this->ScopedAssignment("TRANSLATIONS", scope.TranslationFiles);
-        block += this->ScopedAssignment("QMAKE_CXXFLAGS", this->CompileOptionsForQmake(scope.CompileOptions));
-        block += this->ScopedAssignment("QMAKE_LFLAGS", this->LinkOptionsForQmake(scope.LinkOptions));
-        block += this->ScopedAssignment("INSTALLS", scope.InstallRules);
-        block += "}\n";
-        if (!supported)
-            block = "# " + block.replace("\n", "\n# ").trimmed() + "\n";
-        source += block;
+        children.append(QList<int>());
+        int parent = target.ConditionalScopes.at(i).Parent;
+        if (parent >= 0 && parent < i)
+            children[parent].append(i);
+        else
+            roots.append(i);
     }
+
+    QString source;
+    foreach (int index, roots)
+        this->GenerateConditionalScope(target, children, index, QString(), QString(), &source);
     return source;
 }
 
+void QMakeGenerator::GenerateConditionalScope(const BuildTarget &target, const QList<QList<int>> &children, int index,
+                                              const QString &comment, const QString &indent, QString *source)
+{
+    const BuildConditionalScope &scope = target.ConditionalScopes.at(index);
+    bool supported = true;
+    QString condition = this->MapCondition(scope.Condition, &supported);
+    QString block;
+    if (!supported)
+        *source += comment + indent + "# q2c warning: Unsupported CMake condition for qmake scope: " + scope.Condition + "\n";
+
+    block += condition + " {\n";
+    block += this->ScopedAssignment("SOURCES", scope.Sources);
+    block += this->ScopedAssignment("HEADERS", scope.Headers);
+    block += this->ScopedAssignment("FORMS", scope.UiFiles);
+    block += this->ScopedAssignment("RESOURCES", scope.ResourceFiles);
+    block += this->ScopedAssignment("DEFINES", scope.Defines);
+    block += this->ScopedAssignment("INCLUDEPATH", scope.IncludePaths);
+    block += this->ScopedAssignment("LIBS", this->LibrariesForQmake(scope.Libraries));
+    block += this->ScopedAssignment("TRANSLATIONS", scope.TranslationFiles);
+    block += this->ScopedAssignment("QMAKE_CXXFLAGS", this->CompileOptionsForQmake(scope.CompileOptions));
+    block += this->ScopedAssignment("QMAKE_CXXFLAGS_RELEASE", BuildConfigValues(scope.CompileOptions, BuildConfigRelease));
+    block += this->ScopedAssignment("QMAKE_CXXFLAGS_DEBUG", BuildConfigValues(scope.CompileOptions, BuildConfigDebug));
+    block += this->ScopedAssignment("QMAKE_LFLAGS", this->LinkOptionsForQmake(scope.LinkOptions));
+    block += this->ScopedAssignment("QMAKE_LFLAGS_RELEASE", BuildConfigValues(scope.LinkOptions, BuildConfigRelease));
+    block += this->ScopedAssignment("QMAKE_LFLAGS_DEBUG", BuildConfigValues(scope.LinkOptions, BuildConfigDebug));
+    block += this->ScopedAssignment("INSTALLS", scope.InstallRules);
+
+    // Blocks under an unsupported condition are commented out together with the scopes nested in them
+    const QString &prefix_comment = supported ? comment : UnsupportedScopeComment;
+    const QString prefix = prefix_comment + indent;
+    block.chop(1);
+    *source += prefix + block.replace("\n", "\n" + prefix) + "\n";
+
+    // Indentation stops growing at some depth, otherwise the output would grow with the square of it
+    const QString nested_indent = indent.size() < MaximumScopeIndentation ? indent + "    " : indent;
+    foreach (int child, children.at(index))
+        this->GenerateConditionalScope(target, children, child, prefix_comment, nested_indent, source);
+    *source += prefix + "}\n";
+}
+
 QString QMakeGenerator::GenerateAdditionalTargetNotes(const BuildProject &project, const BuildTarget &primary)
 {
     QString source;
@@ -129,18 +264,20 @@ QString QMakeGenerator::GenerateAdditionalTargetNotes(const BuildProject &projec
     return source;
 }
 
-QString QMakeGenerator::Assignment(QString variable, const QList<QString> &items) const
+QString QMakeGenerator::Assignment(const char *variable, const QList<QString> &items) const
 {
+    // Most variables are empty, the name is only turned into a string when it is written
     if (items.isEmpty())
         return "";
 
     if (items.size() == 1)
-        return variable + " += " + this->Quote(items.first()) + "\n";
+        return QString(variable) + " += " + this->Quote(items.first()) + "\n";
 
-    QString result = variable + " += \\\n";
+    QString result = QString(variable) + " += \\\n";
     for (int i = 0; i < items.size(); i++)
     {
-        result += "    " + this->Quote(items[i]);
+        result += "    ";
+        result += this->Quote(items[i]);
         if (i + 1 < items.size())
             result += " \\";
         result += "\n";
@@ -148,7 +285,7 @@ QString QMakeGenerator::Assignment(QString variable, const QList<QString> &items
     return result;
 }
 
-QString QMakeGenerator::ScopedAssignment(QString variable, const QList<QString> &items) const
+QString QMakeGenerator::ScopedAssignment(const char *variable, const QList<QString> &items) const
 {
     QString assignment = this->Assignment(variable, items);
     if (assignment.isEmpty())
@@ -169,7 +306,7 @@ QString QMakeGenerator::ConfigForTarget(const BuildTarget &target) const
 QStringList QMakeGenerator::LibrariesForQmake(const QList<QString> &libraries) const
 {
     QStringList result;
-    foreach (QString library, libraries)
+    foreach (const QString &library, libraries)
     {
         if (library.startsWith("$<"))
             continue;
@@ -184,7 +321,7 @@ QStringList QMakeGenerator::LibrariesForQmake(const QList<QString> &libraries) c
 QStringList QMakeGenerator::CompileOptionsForQmake(const QList<QString> &options) const
 {
     QStringList result;
-    foreach (QString option, options)
+    foreach (const QString &option, options)
     {
         if (!option.startsWith("$<"))
             result << option;
@@ -195,7 +332,7 @@ QStringList QMakeGenerator::CompileOptionsForQmake(const QList<QString> &options
 QStringList QMakeGenerator::LinkOptionsForQmake(const QList<QString> &options) const
 {
     QStringList result;
-    foreach (QString option, options)
+    foreach (const QString &option, options)
     {
         if (!option.startsWith("$<"))
             result << option;
@@ -203,7 +340,7 @@ QStringList QMakeGenerator::LinkOptionsForQmake(const QList<QString> &options) c
     return result;
 }
 
-QString QMakeGenerator::MapCondition(QString condition, bool *supported) const
+QString QMakeGenerator::MapCondition(const QString &condition, bool *supported) const
 {
     QString normalized = condition.trimmed();
     normalized.remove("(");
@@ -223,7 +360,7 @@ QString QMakeGenerator::MapCondition(QString condition, bool *supported) const
         QStringList parts = normalized.split(QRegularExpression("\\s+AND\\s+"), Qt::SkipEmptyParts);
         QStringList mapped_parts;
         bool all_supported = true;
-        foreach (QString part, parts)
+        foreach (const QString &part, parts)
         {
             bool part_supported = true;
             mapped_parts << this->MapCondition(part, &part_supported);
@@ -251,7 +388,7 @@ QString QMakeGenerator::MapCondition(QString condition, bool *supported) const
     return normalized;
 }
 
-QString QMakeGenerator::Quote(QString value) const
+QString QMakeGenerator::Quote(const QString &value) const
 {
     if (value.contains(" ") || value.contains(";") || value.contains(":"))
         return "\"" + value + "\"";
@@ -260,9 +397,16 @@ QString QMakeGenerator::Quote(QString value) const
 
 bool QMakeGenerator::HasUnsupportedGeneratorExpression(const QList<QString> &items) const
 {
-    foreach (QString item, items)
+    foreach (const QString &item, items)
     {
-        if (item.contains("$<"))
+        QString config;
+        QString value;
+        if (SplitBuildConfig(item, &config, &value))
+        {
+            if (value.contains("$<"))
+                return true;
+        }
+        else if (item.contains("$<"))
             return true;
     }
     return false;
@@ -23,16 +23,21 @@ class QMakeGenerator
     private:
         QString GenerateTarget(const BuildProject &project, const BuildTarget &target);
         QString GenerateAssignments(const BuildTarget &target);
+        //! CONFIG(release, debug|release) block for defines, include paths and libraries of one build configuration
+        QString GenerateBuildConfigScope(const BuildTarget &target, const QString &config);
         QString GenerateConditionalScopes(const BuildTarget &target);
+        //! Appends the block of one scope and of the scopes nested in it, comment is "# " inside an unsupported scope
+        void GenerateConditionalScope(const BuildTarget &target, const QList<QList<int>> &children, int index,
+                                      const QString &comment, const QString &indent, QString *source);
         QString GenerateAdditionalTargetNotes(const BuildProject &project, const BuildTarget &primary);
-        QString Assignment(QString variable, const QList<QString> &items) const;
-        QString ScopedAssignment(QString variable, const QList<QString> &items) const;
+        QString Assignment(const char *variable, const QList<QString> &items) const;
+        QString ScopedAssignment(const char *variable, const QList<QString> &items) const;
         QString ConfigForTarget(const BuildTarget &target) const;
         QStringList LibrariesForQmake(const QList<QString> &libraries) const;
         QStringList CompileOptionsForQmake(const QList<QString> &options) const;
         QStringList LinkOptionsForQmake(const QList<QString> &options) const;
-        QString MapCondition(QString condition, bool *supported) const;
-        QString Quote(QString value) const;
+        QString MapCondition(const QString &condition, bool *supported) const;
+        QString Quote(const QString &value) const;
         bool HasUnsupportedGeneratorExpression(const QList<QString> &items) const;
 };
 
@@ -9,25 +9,200 @@
 //GNU General Public License for more details.
 
 #include "qmakeparser.h"
+#include "charscanner.h"
 #include "logs.h"
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #include <QProcessEnvironment>
 #include <QRegularExpression>
+#include <QSet>
+
+enum QMakeVariableKind
+{
+    QMakeVariable_List,      // Maps onto a list of the target and, when ScopeList is set, of conditional scopes
+    QMakeVariable_BuildConfigList, // Values of one build configuration, added to the target list wrapped in a BuildConfig condition
+    QMakeVariable_Target,
+    QMakeVariable_Template,
+    QMakeVariable_Directory  // Only kept for $$ expansion
+};
+
+struct QMakeVariableField
+{
+    const char *Name;
+    QMakeVariableKind Kind;
+    QList<QString> BuildTarget::*TargetList;
+    QList<QString> BuildConditionalScope::*ScopeList;
+};
+
+// Every qmake variable the parser understands. Adding a list here makes it work
+// in top-level assignments, inline scopes and scope blocks alike.
+static constexpr QMakeVariableField QMakeVariableFields[] =
+{
+    { "TARGET", QMakeVariable_Target, nullptr, nullptr },
+    { "TEMPLATE", QMakeVariable_Template, nullptr, nullptr },
+    { "SOURCES", QMakeVariable_List, &BuildTarget::Sources, &BuildConditionalScope::Sources },
+    { "HEADERS", QMakeVariable_List, &BuildTarget::Headers, &BuildConditionalScope::Headers },
+    { "FORMS", QMakeVariable_List, &BuildTarget::UiFiles, &BuildConditionalScope::UiFiles },
+    { "RESOURCES", QMakeVariable_List, &BuildTarget::ResourceFiles, &BuildConditionalScope::ResourceFiles },
+    { "TRANSLATIONS", QMakeVariable_List, &BuildTarget::TranslationFiles, &BuildConditionalScope::TranslationFiles },
+    { "QT", QMakeVariable_List, &BuildTarget::QtModules, nullptr },
+    { "CONFIG", QMakeVariable_List, &BuildTarget::Config, &BuildConditionalScope::Config },
+    { "DEFINES", QMakeVariable_List, &BuildTarget::Defines, &BuildConditionalScope::Defines },
+    { "INCLUDEPATH", QMakeVariable_List, &BuildTarget::IncludePaths, &BuildConditionalScope::IncludePaths },
+    { "DEPENDPATH", QMakeVariable_List, &BuildTarget::IncludePaths, &BuildConditionalScope::IncludePaths },
+    { "LIBS", QMakeVariable_List, &BuildTarget::Libraries, &BuildConditionalScope::Libraries },
+    { "SUBDIRS", QMakeVariable_List, &BuildTarget::Subdirectories, nullptr },
+    { "INSTALLS", QMakeVariable_List, &BuildTarget::InstallRules, &BuildConditionalScope::InstallRules },
+    { "QMAKE_CXXFLAGS", QMakeVariable_List, &BuildTarget::CompileOptions, &BuildConditionalScope::CompileOptions },
+    { "QMAKE_LFLAGS", QMakeVariable_List, &BuildTarget::LinkOptions, &BuildConditionalScope::LinkOptions },
+    { "QMAKE_CXXFLAGS_RELEASE", QMakeVariable_BuildConfigList, &BuildTarget::CompileOptions, &BuildConditionalScope::CompileOptions },
+    { "QMAKE_CXXFLAGS_DEBUG", QMakeVariable_BuildConfigList, &BuildTarget::CompileOptions, &BuildConditionalScope::CompileOptions },
+    { "QMAKE_LFLAGS_RELEASE", QMakeVariable_BuildConfigList, &BuildTarget::LinkOptions, &BuildConditionalScope::LinkOptions },
+    { "QMAKE_LFLAGS_DEBUG", QMakeVariable_BuildConfigList, &BuildTarget::LinkOptions, &BuildConditionalScope::LinkOptions },
+    { "QMAKE_POST_LINK", QMakeVariable_List, &BuildTarget::LinkOptions, &BuildConditionalScope::LinkOptions },
+    { "PRECOMPILED_HEADER", QMakeVariable_List, &BuildTarget::PrecompiledHeaders, nullptr },
+    { "DESTDIR", QMakeVariable_Directory, nullptr, nullptr },
+    { "OBJECTS_DIR", QMakeVariable_Directory, nullptr, nullptr },
+    { "MOC_DIR", QMakeVariable_Directory, nullptr, nullptr },
+    { "RCC_DIR", QMakeVariable_Directory, nullptr, nullptr },
+    { "UI_DIR", QMakeVariable_Directory, nullptr, nullptr }
+};
+
+static constexpr int QMakeVariableFieldCount = sizeof(QMakeVariableFields) / sizeof(QMakeVariableFields[0]);
+static constexpr int QMakeVariableSlotCount = 64;
+// Chosen so that no two names share a slot, the static_assert below fails when a new name collides
+static constexpr unsigned int QMakeVariableHashSeed = 3309;
+
+static constexpr unsigned int QMakeVariableUpper(unsigned int c)
+{
+    return c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c;
+}
+
+// Case-insensitive FNV-1a, variable names have always been matched regardless of case
+static constexpr unsigned int QMakeVariableHashStep(unsigned int hash, unsigned int c)
+{
+    return (hash ^ QMakeVariableUpper(c)) * 16777619u;
+}
+
+static constexpr int QMakeVariableSlot(const char *name)
+{
+    unsigned int hash = 2166136261u ^ QMakeVariableHashSeed;
+    for (int i = 0; name[i] != 0; i++)
+        hash = QMakeVariableHashStep(hash, static_cast<unsigned char>(name[i]));
+    return static_cast<int>((hash >> 16) % QMakeVariableSlotCount);
+}
+
+struct QMakeVariableSlots
+{
+    signed char Field[QMakeVariableSlotCount]; // Index into QMakeVariableFields, -1 for an empty slot
+    bool Collision;
+};
+
+static constexpr QMakeVariableSlots BuildQMakeVariableSlots()
+{
+    QMakeVariableSlots slots {};
+    slots.Collision = false;
+    for (int i = 0; i < QMakeVariableSlotCount; i++)
+        slots.Field[i] = -1;
+    for (int i = 0; i < QMakeVariableFieldCount; i++)
+    {
+        int slot = QMakeVariableSlot(QMakeVariableFields[i].Name);
+        if (slots.Field[slot] >= 0)
+            slots.Collision = true;
+        slots.Field[slot] = static_cast<signed char>(i);
+    }
+    return slots;
+}
+
+static constexpr QMakeVariableSlots QMakeVariableTable = BuildQMakeVariableSlots();
+static_assert(!QMakeVariableTable.Collision, "qmake variable names collide, pick another QMakeVariableHashSeed");
+
+static const QMakeVariableField *FindQMakeVariable(const QString &word)
+{
+    unsigned int hash = 2166136261u ^ QMakeVariableHashSeed;
+    for (QChar c : word)
+    {
+        if (c.unicode() > 0x7f)
+            return nullptr;
+        hash = QMakeVariableHashStep(hash, c.unicode());
+    }
+    int index = QMakeVariableTable.Field[(hash >> 16) % QMakeVariableSlotCount];
+    if (index < 0)
+        return nullptr;
+
+    const char *name = QMakeVariableFields[index].Name;
+    int length = static_cast<int>(word.size());
+    for (int i = 0; i < length; i++)
+    {
+        if (name[i] == 0 || QMakeVariableUpper(word[i].unicode()) != static_cast<unsigned char>(name[i]))
+            return nullptr;
+    }
+    if (name[length] != 0)
+        return nullptr;
+    return &QMakeVariableFields[index];
+}
+
+// Name of the first plain list variable that fills the target list
+static QString TargetListKey(QList<QString> BuildTarget::*target_list)
+{
+    for (int i = 0; i < QMakeVariableFieldCount; i++)
+    {
+        if (QMakeVariableFields[i].Kind == QMakeVariable_List && QMakeVariableFields[i].TargetList == target_list)
+            return QLatin1String(QMakeVariableFields[i].Name);
+    }
+    return QString();
+}
+
+// Known variables are stored under their canonical spelling and variables that
+// fill the same target list, like INCLUDEPATH and DEPENDPATH, share one entry
+static QString VariableKey(const QString &name)
+{
+    const QMakeVariableField *field = FindQMakeVariable(name);
+    if (field == nullptr)
+        return name;
+    if (field->Kind == QMakeVariable_List)
+        return TargetListKey(field->TargetList);
+    return QLatin1String(field->Name);
+}
+
+// Build configurations are not scopes in CMake, conditions on them are kept as
+// the generator expressions of BuildConfig and wrap the values they apply to
+static bool IsBuildConfigCondition(const QString &condition)
+{
+    return condition == BuildConfig::Release || condition == BuildConfig::Debug;
+}
+
+static const QString &BuildConfigCondition(const QMakeVariableField *field)
+{
+    return QString(field->Name).endsWith("_DEBUG") ? BuildConfig::Debug : BuildConfig::Release;
+}
+
+static QStringList WrapInBuildConfig(const QString &condition, const QStringList &items)
+{
+    QStringList result;
+    result.reserve(items.size());
+    foreach (const QString &item, items)
+        result << "$<" + condition + ":" + item + ">";
+    return result;
+}
+
+// Lists that CMake accepts generator expressions in, files go to target_sources()
+static bool AcceptsBuildConfigValues(const QMakeVariableField *field)
+{
+    return field->ScopeList == &BuildConditionalScope::Sources || field->ScopeList == &BuildConditionalScope::Headers ||
+           field->ScopeList == &BuildConditionalScope::UiFiles || field->ScopeList == &BuildConditionalScope::ResourceFiles ||
+           field->ScopeList == &BuildConditionalScope::CompileOptions || field->ScopeList == &BuildConditionalScope::LinkOptions ||
+           field->ScopeList == &BuildConditionalScope::Defines || field->ScopeList == &BuildConditionalScope::IncludePaths ||
+           field->ScopeList == &BuildConditionalScope::Libraries;
+}
 
 QMakeParser::QMakeParser()
 {
     this->Model = nullptr;
-    this->KnownSimpleKeywords << "TARGET" << "TEMPLATE";
-    this->KnownComplexKeywords << "SOURCES" << "HEADERS" << "QT" << "CONFIG" << "DEFINES"
-                               << "INCLUDEPATH" << "DEPENDPATH" << "LIBS" << "FORMS"
-                               << "RESOURCES" << "TRANSLATIONS" << "SUBDIRS" << "INSTALLS"
-                               << "QMAKE_CXXFLAGS" << "QMAKE_LFLAGS" << "QMAKE_POST_LINK"
-                               << "DESTDIR" << "OBJECTS_DIR" << "MOC_DIR" << "RCC_DIR" << "UI_DIR";
 }
 
-bool QMakeParser::Parse(QString text, BuildProject *model, QString source_file, QString cmake_minimum_version)
+bool QMakeParser::Parse(const QString &text, BuildProject *model, const QString &source_file, const QString &cmake_minimum_version)
 {
     this->Model = model;
     this->SourceFile = source_file;
@@ -38,30 +213,17 @@ bool QMakeParser::Parse(QString text, BuildProject *model, QString source_file,
     this->CMakeMinimumVersion = cmake_minimum_version;
     this->ProjectName = "";
     this->TemplateName = "app";
-    this->Sources.clear();
-    this->Headers.clear();
-    this->Modules.clear();
-    this->Config.clear();
-    this->Defines.clear();
-    this->IncludePaths.clear();
-    this->Libraries.clear();
+    this->Target = BuildTarget();
     this->Variables.clear();
-    this->UIFiles.clear();
-    this->ResourceFiles.clear();
-    this->TranslationFiles.clear();
-    this->CompileOptions.clear();
-    this->LinkOptions.clear();
-    this->InstallRules.clear();
-    this->Subdirectories.clear();
     this->ConditionalBlocks.clear();
     this->RequiredKeywords.clear();
     this->RemainingRequiredKeywords.clear();
     this->RequiredKeywords << "TARGET";
     this->RemainingRequiredKeywords = this->RequiredKeywords;
-    this->Modules << "core";
-    this->Variables.insert("QT", this->Modules);
-    this->Variables.insert("PWD", QStringList() << this->BaseDirectory);
-    this->Variables.insert("OUT_PWD", QStringList() << ".");
+    this->Target.QtModules << "core";
+    this->FindOrCreateVariable("QT");
+    this->ApplyListOperation(this->FindOrCreateVariable("PWD")->List(), nullptr, "=", QStringList() << this->BaseDirectory);
+    this->ApplyListOperation(this->FindOrCreateVariable("OUT_PWD")->List(), nullptr, "=", QStringList() << ".");
     this->TargetType = BuildTarget_Application;
     this->CurrentLineNumber = 0;
     this->TargetLine = 0;
@@ -75,8 +237,9 @@ bool QMakeParser::Parse(QString text, BuildProject *model, QString source_file,
         if (line.isEmpty())
             continue;
 
-        if ((line.contains("{") && (line.startsWith("win32") || line.startsWith("unix") ||
-             line.startsWith("linux") || line.startsWith("macx") || line.startsWith("if("))) ||
+        if ((line.contains('{') && (line.startsWith("win32") || line.startsWith("unix") ||
+             line.startsWith("linux") || line.startsWith("macx") || line.startsWith("if(") ||
+             !this->BuildConfigScope(line.left(line.indexOf('{'))).isEmpty())) ||
             line.startsWith("else") || line.startsWith("} else"))
         {
             if (!this->ProcessScope(line, lines, i))
@@ -90,8 +253,8 @@ bool QMakeParser::Parse(QString text, BuildProject *model, QString source_file,
 
     if (!this->RemainingRequiredKeywords.isEmpty())
     {
-        foreach (QString word, this->RemainingRequiredKeywords)
-            Logs::ErrorLog("Required keyword not found: " + word);
+        foreach (const QString &word, this->RemainingRequiredKeywords)
+            Logs::Write(LogLevel_Error, "qmake", this->SourceFile, 0, "Required keyword not found: " + word);
         return false;
     }
 
@@ -99,33 +262,42 @@ bool QMakeParser::Parse(QString text, BuildProject *model, QString source_file,
     return true;
 }
 
-QStringList QMakeParser::NormalizeLines(QString text)
+QStringList QMakeParser::NormalizeLines(const QString &text) const
 {
     QStringList physical_lines = text.split("\n");
     QStringList result;
+    result.reserve(physical_lines.size());
     QString current;
-    foreach (QString physical_line, physical_lines)
+    foreach (const QString &physical_line, physical_lines)
     {
         QString line = physical_line.trimmed();
-        if (line.endsWith("\\"))
+        if (line.endsWith('\\'))
         {
-            current += line.left(line.length() - 1) + " ";
+            line.chop(1);
+            current += line;
+            current += ' ';
+            continue;
+        }
+        if (current.isEmpty())
+        {
+            result.append(std::move(line));
             continue;
         }
         current += line;
-        result << current;
-        current.clear();
+        result.append(std::move(current));
+        current = QString();
     }
     if (!current.isEmpty())
-        result << current;
+        result.append(std::move(current));
     return result;
 }
 
-QString QMakeParser::StripComment(QString line)
+QString QMakeParser::StripComment(const QString &line) const
 {
+    static const CharScanner scanner("#\"'");
     bool in_quote = false;
     QChar quote_char;
-    for (int i = 0; i < line.length(); i++)
+    for (int i = scanner.Next(line, 0); i < line.length(); i = scanner.Next(line, i + 1))
     {
         QChar ch = line[i];
         if ((ch == '"' || ch == '\'') && (i == 0 || line[i - 1] != '\\'))
@@ -146,13 +318,14 @@ QString QMakeParser::StripComment(QString line)
     return line;
 }
 
-bool QMakeParser::ProcessLine(QString line)
+bool QMakeParser::ProcessLine(const QString &line)
 {
     if (this->ProcessInclude(line))
         return true;
 
     int colon = this->FindScopeColon(line);
-    if (colon > 0 && !line.left(colon).contains("="))
+    int equals = line.indexOf('=');
+    if (colon > 0 && (equals < 0 || equals > colon))
     {
         QString condition = line.left(colon).trimmed();
         QString scoped_line = line.mid(colon + 1).trimmed();
@@ -166,20 +339,20 @@ bool QMakeParser::ProcessLine(QString line)
     if (!this->ExtractAssignment(line, &word, &op, &data))
     {
         if (line.contains("("))
-            this->AddWarning("Unsupported qmake function or statement at line " + QString::number(this->CurrentLineNumber) + ": " + line);
+            this->AddWarning(BuildWarning_UnsupportedQMakeStatement, this->CurrentLineNumber,
+                             "Unsupported qmake function or statement at line " + QString::number(this->CurrentLineNumber) + ": " + line);
         else
-            Logs::DebugLog("Ignoring unknown qmake line: " + line);
+            Q2C_DEBUG_LOG(1, "qmake", this->SourceFile, this->CurrentLineNumber, "Ignoring unknown qmake line: " + line);
         return true;
     }
 
     return this->ProcessAssignment(word, op, data);
 }
 
-bool QMakeParser::ExtractAssignment(QString line, QString *word, QString *op, QString *data)
+bool QMakeParser::ExtractAssignment(const QString &line, QString *word, QString *op, QString *data)
 {
-    QStringList ops;
-    ops << "+=" << "-=" << "*=" << "~=" << "=";
-    foreach (QString candidate, ops)
+    static const QString ops[] = { "+=", "-=", "*=", "~=", "=" };
+    for (const QString &candidate : ops)
     {
         int index = line.indexOf(candidate);
         if (index <= 0)
@@ -193,13 +366,14 @@ bool QMakeParser::ExtractAssignment(QString line, QString *word, QString *op, QS
     return false;
 }
 
-int QMakeParser::FindScopeColon(QString line)
+int QMakeParser::FindScopeColon(const QString &line) const
 {
+    static const CharScanner scanner("\"'():");
     bool in_quote = false;
     QChar quote_char;
     int paren_depth = 0;
 
-    for (int i = 0; i < line.length(); i++)
+    for (int i = scanner.Next(line, 0); i < line.length(); i = scanner.Next(line, i + 1))
     {
         QChar ch = line[i];
         if ((ch == '"' || ch == '\'') && (i == 0 || line[i - 1] != '\\'))
@@ -225,13 +399,16 @@ int QMakeParser::FindScopeColon(QString line)
     return -1;
 }
 
-bool QMakeParser::ProcessInclude(QString line)
+bool QMakeParser::ProcessInclude(const QString &line)
 {
+    static const QString include_prefix = "include(";
+    if (!line.startsWith(include_prefix))
+        return false;
     QString trimmed = line.trimmed();
-    if (!trimmed.startsWith("include(") || !trimmed.endsWith(")"))
+    if (!trimmed.endsWith(')'))
         return false;
 
-    QString include_path = trimmed.mid(QString("include(").length());
+    QString include_path = trimmed.mid(include_prefix.length());
     include_path.chop(1);
     include_path = this->ExpandVariables(include_path.trimmed());
     include_path.replace("\"", "");
@@ -240,7 +417,8 @@ bool QMakeParser::ProcessInclude(QString line)
     QString included_text = this->LoadIncludedFile(include_path);
     if (included_text.isEmpty())
     {
-        this->AddWarning("Unable to read included qmake file: " + include_path);
+        this->AddWarning(BuildWarning_UnreadableInclude, this->CurrentLineNumber, "Unable to read included qmake file: " + include_path,
+                         "Check that the file exists relative to the including project");
         return true;
     }
 
@@ -266,7 +444,7 @@ bool QMakeParser::ProcessInclude(QString line)
     return true;
 }
 
-QString QMakeParser::LoadIncludedFile(QString include_path)
+QString QMakeParser::LoadIncludedFile(const QString &include_path)
 {
     QFileInfo info(include_path);
     if (info.isRelative())
@@ -282,34 +460,39 @@ QString QMakeParser::LoadIncludedFile(QString include_path)
 
 QString QMakeParser::ExpandVariables(QString text)
 {
+    if (!text.contains('$'))
+        return text;
+
     text.replace("$$PWD", this->BaseDirectory);
     text.replace("$${PWD}", this->BaseDirectory);
     text.replace("$$OUT_PWD", ".");
     text.replace("$${OUT_PWD}", ".");
 
-    QRegularExpression braced("\\$\\$\\{([^}]+)\\}");
+    static const QRegularExpression braced("\\$\\$\\{([^}]+)\\}");
     QRegularExpressionMatchIterator braced_it = braced.globalMatch(text);
     while (braced_it.hasNext())
     {
         QRegularExpressionMatch match = braced_it.next();
         QString name = match.captured(1);
         QString replacement;
-        if (this->Variables.contains(name))
-            replacement = this->Variables.value(name).join(" ");
+        const QList<QString> *values = this->FindVariable(name);
+        if (values != nullptr)
+            replacement = QStringList(*values).join(" ");
         else
             replacement = QProcessEnvironment::systemEnvironment().value(name);
         text.replace(match.captured(0), replacement);
     }
 
-    QRegularExpression simple("\\$\\$([A-Za-z_][A-Za-z0-9_]*)");
+    static const QRegularExpression simple("\\$\\$([A-Za-z_][A-Za-z0-9_]*)");
     QRegularExpressionMatchIterator simple_it = simple.globalMatch(text);
     while (simple_it.hasNext())
     {
         QRegularExpressionMatch match = simple_it.next();
         QString name = match.captured(1);
         QString replacement;
-        if (this->Variables.contains(name))
-            replacement = this->Variables.value(name).join(" ");
+        const QList<QString> *values = this->FindVariable(name);
+        if (values != nullptr)
+            replacement = QStringList(*values).join(" ");
         else
             replacement = QProcessEnvironment::systemEnvironment().value(name);
         text.replace(match.captured(0), replacement);
@@ -317,16 +500,40 @@ QString QMakeParser::ExpandVariables(QString text)
     return text;
 }
 
-QStringList QMakeParser::TokenizeValueList(QString text)
+void QMakeParser::TokenizeValueList(QStringView text, QList<TokenView> *tokens) const
 {
-    QStringList raw_tokens;
-    QString token;
+    static const CharScanner scanner("\"'", true);
     bool in_quote = false;
+    bool quoted = false;
+    bool has_value = false;
     QChar quote_char;
+    int start = -1;
 
     for (int i = 0; i < text.length(); i++)
     {
+        // Everything up to the next quote or whitespace belongs to the current token
+        int next = scanner.Next(text, i);
+        if (next > i)
+        {
+            if (start < 0)
+                start = i;
+            has_value = true;
+            i = next;
+            if (i == text.length())
+                break;
+        }
         QChar ch = text[i];
+        if (ch.isSpace() && !in_quote)
+        {
+            if (has_value)
+                tokens->append(TokenView(text.mid(start, i - start), quoted));
+            start = -1;
+            quoted = false;
+            has_value = false;
+            continue;
+        }
+        if (start < 0)
+            start = i;
         if ((ch == '"' || ch == '\'') && (i == 0 || text[i - 1] != '\\'))
         {
             if (in_quote && ch == quote_char)
@@ -336,32 +543,39 @@ QStringList QMakeParser::TokenizeValueList(QString text)
                 in_quote = true;
                 quote_char = ch;
             }
+            quoted = true;
             continue;
         }
-        if (ch.isSpace() && !in_quote)
-        {
-            if (!token.isEmpty())
-            {
-                raw_tokens << token;
-                token.clear();
-            }
-            continue;
-        }
-        token += ch;
+        has_value = true;
     }
-    if (!token.isEmpty())
-        raw_tokens << token;
+    if (has_value)
+        tokens->append(TokenView(text.mid(start), quoted));
+}
+
+QStringList QMakeParser::ReadValueList(QStringView text)
+{
+    // The token buffer is reused from line to line, only the values that are
+    // returned are copied out of the text
+    this->Tokens.clear();
+    this->TokenizeValueList(text, &this->Tokens);
 
     QStringList result;
-    foreach (QString raw_token, raw_tokens)
-        result.append(this->ExpandToken(raw_token));
+    result.reserve(this->Tokens.size());
+    for (int i = 0; i < this->Tokens.size(); i++)
+    {
+        const TokenView &token = this->Tokens.at(i);
+        if (token.Contains('$'))
+            result.append(this->ExpandToken(token.ToString()));
+        else
+            result.append(token.ToString());
+    }
     return result;
 }
 
-QStringList QMakeParser::ExpandToken(QString token)
+QStringList QMakeParser::ExpandToken(const QString &token)
 {
-    QRegularExpression braced("^\\$\\$\\{([^}]+)\\}$");
-    QRegularExpression simple("^\\$\\$([A-Za-z_][A-Za-z0-9_]*)$");
+    static const QRegularExpression braced("^\\$\\$\\{([^}]+)\\}$");
+    static const QRegularExpression simple("^\\$\\$([A-Za-z_][A-Za-z0-9_]*)$");
     QRegularExpressionMatch match = braced.match(token);
     if (!match.hasMatch())
         match = simple.match(token);
@@ -369,8 +583,9 @@ QStringList QMakeParser::ExpandToken(QString token)
     if (match.hasMatch())
     {
         QString name = match.captured(1);
-        if (this->Variables.contains(name))
-            return this->Variables.value(name);
+        const QList<QString> *values = this->FindVariable(name);
+        if (values != nullptr)
+            return *values;
         QString env_value = QProcessEnvironment::systemEnvironment().value(name);
         if (!env_value.isEmpty())
             return QStringList() << env_value;
@@ -380,141 +595,144 @@ QStringList QMakeParser::ExpandToken(QString token)
     return QStringList() << this->ExpandVariables(token);
 }
 
-bool QMakeParser::ApplyListOperation(QList<QString> *list, QString op, QStringList items)
+bool QMakeParser::ApplyListOperation(QList<QString> *list, QSet<QString> *entries, const QString &op, const QStringList &items)
 {
     if (op == "=")
+    {
         list->clear();
+        if (entries != nullptr)
+            entries->clear();
+    }
 
     if (op == "-=")
     {
-        foreach (QString item, items)
+        foreach (const QString &item, items)
+        {
             list->removeAll(item);
+            if (entries != nullptr)
+                entries->remove(item);
+        }
         return true;
     }
 
     if (op == "~=")
     {
-        this->AddWarning("Regex replacement operator '~=' is not supported at line " + QString::number(this->CurrentLineNumber));
+        this->AddWarning(BuildWarning_UnsupportedRegexReplace, this->CurrentLineNumber,
+                         "Regex replacement operator '~=' is not supported at line " + QString::number(this->CurrentLineNumber),
+                         "Replace the operator with the resulting values");
         return true;
     }
 
-    foreach (QString item, items)
+    // Lists without a variable behind them only live for one scope, so their
+    // index is built per call; variables keep theirs across assignments
+    QSet<QString> local_entries;
+    if (entries == nullptr)
     {
-        if (op == "*=" && list->contains(item))
+        local_entries = QSet<QString>(list->begin(), list->end());
+        entries = &local_entries;
+    }
+    foreach (const QString &item, items)
+    {
+        if (entries->contains(item))
             continue;
-        if (!list->contains(item))
-            list->append(item);
+        entries->insert(item);
+        list->append(item);
     }
     return true;
 }
 
-bool QMakeParser::ParseStandardQMakeList(QList<QString> *list, QString line, QString text)
+QMakeParser::Variable *QMakeParser::FindOrCreateVariable(const QString &name)
+{
+    // The returned pointer is only valid until the next variable is created
+    QString key = VariableKey(name);
+    QHash<QString, Variable>::iterator it = this->Variables.find(key);
+    if (it != this->Variables.end())
+        return &it.value();
+
+    Variable variable;
+    variable.Values = nullptr;
+    const QMakeVariableField *field = FindQMakeVariable(key);
+    if (field != nullptr && field->Kind == QMakeVariable_List)
+    {
+        variable.Values = &(this->Target.*(field->TargetList));
+        variable.Entries = QSet<QString>(variable.Values->begin(), variable.Values->end());
+    }
+    return &this->Variables.insert(key, variable).value();
+}
+
+const QList<QString> *QMakeParser::FindVariable(const QString &name) const
+{
+    QHash<QString, Variable>::const_iterator it = this->Variables.constFind(VariableKey(name));
+    if (it == this->Variables.constEnd())
+        return nullptr;
+    return it.value().List();
+}
+
+bool QMakeParser::ParseStandardQMakeList(QList<QString> *list, const QString &line, const QString &text)
 {
     QString word;
     QString op;
     QString data;
     if (!this->ExtractAssignment(text.isEmpty() ? line : text, &word, &op, &data))
     {
-        Logs::ErrorLog("Syntax error: expected assignment operator");
-        Logs::ErrorLog("Line: " + line);
+        Logs::Write(LogLevel_Error, "qmake", this->SourceFile, this->CurrentLineNumber, "Syntax error: expected assignment operator: " + line);
         return false;
     }
     Q_UNUSED(word);
-    return this->ApplyListOperation(list, op, this->TokenizeValueList(data));
+    return this->ApplyListOperation(list, nullptr, op, this->ReadValueList(data));
 }
 
-bool QMakeParser::ProcessAssignment(QString word, QString op, QString data)
+bool QMakeParser::ProcessAssignment(const QString &raw_word, const QString &op, const QString &data)
 {
-    word = word.trimmed();
-    QString upper = word.toUpper();
-    QStringList items = this->TokenizeValueList(data);
-
-    if (this->RemainingRequiredKeywords.contains(upper))
-        this->RemainingRequiredKeywords.removeAll(upper);
-
-    if (upper == "TARGET")
+    QString word = raw_word.trimmed();
+    QStringList items = this->ReadValueList(data);
+    const QMakeVariableField *field = FindQMakeVariable(word);
+    if (field == nullptr || field->Kind == QMakeVariable_List || field->Kind == QMakeVariable_BuildConfigList ||
+        field->Kind == QMakeVariable_Directory)
     {
-        QList<QString> target;
-        this->ApplyListOperation(&target, "=", items);
-        if (!target.isEmpty())
-        {
-            QString target_name = target.join("_").trimmed();
-            target_name = target_name.replace(" ", "_");
-            this->ProjectName = target_name;
-            this->TargetLine = this->CurrentLineNumber;
-            this->Variables.insert("TARGET", QStringList() << this->ProjectName);
-        }
-        return true;
+        // Lists of the target are changed in place, there is no second copy to keep in sync
+        Variable *variable = this->FindOrCreateVariable(word);
+        return this->ApplyListOperation(variable->List(), &variable->Entries, op, items);
     }
 
-    if (upper == "TEMPLATE")
+    QString name = QLatin1String(field->Name);
+    switch (field->Kind)
     {
-        if (!items.isEmpty())
+        case QMakeVariable_Target:
         {
-            this->TemplateName = items.first();
-            this->TargetType = this->TargetTypeFromTemplate(this->TemplateName);
-            if (this->TemplateName == "subdirs")
+            this->RemainingRequiredKeywords.removeAll(name);
+            QList<QString> target;
+            this->ApplyListOperation(&target, nullptr, "=", items);
+            if (!target.isEmpty())
             {
-                this->IsSubdirsProject = true;
-                this->RequiredKeywords.removeAll("TARGET");
-                this->RemainingRequiredKeywords.removeAll("TARGET");
+                QString target_name = target.join("_").trimmed();
+                target_name = target_name.replace(" ", "_");
+                this->ProjectName = target_name;
+                this->TargetLine = this->CurrentLineNumber;
+                Variable *variable = this->FindOrCreateVariable(name);
+                this->ApplyListOperation(variable->List(), &variable->Entries, "=", QStringList() << this->ProjectName);
             }
+            return true;
         }
-        return true;
-    }
-
-    QList<QString> *target_list = nullptr;
-    if (upper == "SOURCES")
-        target_list = &this->Sources;
-    else if (upper == "HEADERS")
-        target_list = &this->Headers;
-    else if (upper == "QT")
-        target_list = &this->Modules;
-    else if (upper == "CONFIG")
-        target_list = &this->Config;
-    else if (upper == "DEFINES")
-        target_list = &this->Defines;
-    else if (upper == "INCLUDEPATH" || upper == "DEPENDPATH")
-        target_list = &this->IncludePaths;
-    else if (upper == "LIBS")
-        target_list = &this->Libraries;
-    else if (upper == "FORMS")
-        target_list = &this->UIFiles;
-    else if (upper == "RESOURCES")
-        target_list = &this->ResourceFiles;
-    else if (upper == "TRANSLATIONS")
-        target_list = &this->TranslationFiles;
-    else if (upper == "SUBDIRS")
-        target_list = &this->Subdirectories;
-    else if (upper == "INSTALLS")
-        target_list = &this->InstallRules;
-    else if (upper == "QMAKE_CXXFLAGS")
-        target_list = &this->CompileOptions;
-    else if (upper == "QMAKE_LFLAGS" || upper == "QMAKE_POST_LINK")
-        target_list = &this->LinkOptions;
-
-    if (target_list != nullptr)
-    {
-        this->ApplyListOperation(target_list, op, items);
-        this->Variables.insert(upper, *target_list);
-        return true;
-    }
-
-    if (upper == "DESTDIR" || upper == "OBJECTS_DIR" || upper == "MOC_DIR" || upper == "RCC_DIR" || upper == "UI_DIR")
-    {
-        QStringList existing = this->Variables.value(upper);
-        this->ApplyListOperation(&existing, op, items);
-        this->Variables.insert(upper, existing);
-        return true;
+        case QMakeVariable_Template:
+            if (!items.isEmpty())
+            {
+                this->TemplateName = items.first();
+                this->TargetType = this->TargetTypeFromTemplate(this->TemplateName);
+                if (this->TemplateName == "subdirs")
+                {
+                    this->IsSubdirsProject = true;
+                    this->RequiredKeywords.removeAll("TARGET");
+                    this->RemainingRequiredKeywords.removeAll("TARGET");
+                }
+            }
+            return true;
+        default:
+            return true;
     }
-
-    QStringList existing = this->Variables.value(word);
-    this->ApplyListOperation(&existing, op, items);
-    this->Variables.insert(word, existing);
-    return true;
 }
 
-bool QMakeParser::ProcessSimpleKeyword(QString word, QString line)
+bool QMakeParser::ProcessSimpleKeyword(const QString &word, const QString &line)
 {
     QString parsed_word;
     QString op;
@@ -525,7 +743,7 @@ bool QMakeParser::ProcessSimpleKeyword(QString word, QString line)
     return this->ProcessAssignment(parsed_word, op, data);
 }
 
-bool QMakeParser::ProcessComplexKeyword(QString word, QString line, QString data_buffer)
+bool QMakeParser::ProcessComplexKeyword(const QString &word, const QString &line, const QString &data_buffer)
 {
     QString parsed_word;
     QString op;
@@ -537,11 +755,11 @@ bool QMakeParser::ProcessComplexKeyword(QString word, QString line, QString data
     return this->ProcessAssignment(parsed_word, op, data);
 }
 
-bool QMakeParser::ProcessInlineScope(QString condition, QString scoped_line, int line_number)
+bool QMakeParser::ProcessInlineScope(const QString &condition, const QString &scoped_line, int line_number)
 {
     ConditionalBlock block;
     if (condition.trimmed() == "else")
-        block.condition = "NOT " + (this->ConditionalBlocks.isEmpty() ? QString("FALSE") : this->ConditionalBlocks.last().condition);
+        block.condition = this->ElseCondition();
     else
         block.condition = this->NormalizeCondition(condition);
     block.active = this->EvaluateCondition(block.condition);
@@ -552,47 +770,62 @@ bool QMakeParser::ProcessInlineScope(QString condition, QString scoped_line, int
     QString data;
     if (!this->ExtractAssignment(scoped_line, &word, &op, &data))
     {
-        this->AddWarning("Unsupported scoped qmake statement at line " + QString::number(line_number) + ": " + scoped_line);
-        this->ConditionalBlocks.append(block);
+        this->AddWarning(BuildWarning_UnsupportedScopedStatement, line_number,
+                         "Unsupported scoped qmake statement at line " + QString::number(line_number) + ": " + scoped_line);
+        this->ConditionalBlocks.append(std::move(block));
         return true;
     }
 
-    QString upper = word.toUpper();
-    QStringList items = this->TokenizeValueList(data);
-    if (upper == "SOURCES")
-        this->ApplyListOperation(&block.Sources, op, items);
-    else if (upper == "HEADERS")
-        this->ApplyListOperation(&block.Headers, op, items);
-    else if (upper == "DEFINES")
-        this->ApplyListOperation(&block.Defines, op, items);
-    else if (upper == "INCLUDEPATH" || upper == "DEPENDPATH")
-        this->ApplyListOperation(&block.IncludePaths, op, items);
-    else if (upper == "LIBS")
-        this->ApplyListOperation(&block.Libraries, op, items);
-    else if (upper == "CONFIG")
-        this->ApplyListOperation(&block.Config, op, items);
-    else if (upper == "TRANSLATIONS")
-        this->ApplyListOperation(&block.TranslationFiles, op, items);
-    else if (upper == "QMAKE_CXXFLAGS")
-        this->ApplyListOperation(&block.CompileOptions, op, items);
-    else if (upper == "QMAKE_LFLAGS" || upper == "QMAKE_POST_LINK")
-        this->ApplyListOperation(&block.LinkOptions, op, items);
-    else if (upper == "INSTALLS")
-        this->ApplyListOperation(&block.InstallRules, op, items);
-    else
-        this->AddWarning("Unsupported scoped qmake variable at line " + QString::number(line_number) + ": " + word);
-
-    this->ConditionalBlocks.append(block);
+    this->ProcessScopedAssignment(&block, word, op, data, line_number);
+    this->ConditionalBlocks.append(std::move(block));
     return true;
 }
 
-bool QMakeParser::ProcessScope(QString line, QStringList &lines, int &current_line)
+bool QMakeParser::ProcessScopedAssignment(ConditionalBlock *block, const QString &word, const QString &op, const QString &data, int line_number)
+{
+    const QMakeVariableField *field = FindQMakeVariable(word.trimmed());
+    bool build_config = IsBuildConfigCondition(block->condition);
+    if (field == nullptr || field->ScopeList == nullptr || (build_config && !AcceptsBuildConfigValues(field)))
+    {
+        this->AddWarning(BuildWarning_UnsupportedScopedVariable, line_number,
+                         "Unsupported scoped qmake variable at line " + QString::number(line_number) + ": " + word);
+        return false;
+    }
+
+    QStringList items = this->ReadValueList(data);
+    if (field->Kind == QMakeVariable_BuildConfigList)
+    {
+        // Inside a scope of the same configuration the scope already wraps the values, inside
+        // the other one they never apply, qmake does not use _DEBUG flags for a release build
+        const QString &field_config = BuildConfigCondition(field);
+        if (build_config && field_config != block->condition)
+        {
+            this->AddWarning(BuildWarning_UnusedBuildConfigValues, line_number,
+                             QString(field->Name) + " is never used in the other build configuration at line " + QString::number(line_number),
+                             "Move " + QString(field->Name) + " out of the build configuration scope");
+            return false;
+        }
+        if (!build_config)
+            items = WrapInBuildConfig(field_config, items);
+    }
+    if (!build_config)
+        return this->ApplyListOperation(&(block->Scope.*(field->ScopeList)), nullptr, op, items);
+
+    // The values go to the target wrapped in the configuration, an assignment can
+    // not reset the list of a single configuration so it appends like +=
+    Variable *variable = this->FindOrCreateVariable(TargetListKey(field->TargetList));
+    return this->ApplyListOperation(variable->List(), &variable->Entries, op == "=" ? "+=" : op, WrapInBuildConfig(block->condition, items));
+}
+
+bool QMakeParser::ProcessScope(const QString &line, const QStringList &lines, int &current_line)
 {
     ConditionalBlock block;
     QString condition;
     block.line = current_line + 1;
 
     QString trimmed = line.trimmed();
+    if (trimmed.startsWith("}"))
+        trimmed = trimmed.mid(1).trimmed();
     int colon = this->FindScopeColon(trimmed);
     if (colon > 0)
     {
@@ -606,16 +839,17 @@ bool QMakeParser::ProcessScope(QString line, QStringList &lines, int &current_li
         condition = trimmed.mid(trimmed.indexOf("(") + 1);
         condition = condition.left(condition.indexOf(")"));
     }
-    else if (trimmed.contains("{"))
+    else if (trimmed.startsWith("else"))
     {
-        condition = trimmed.left(trimmed.indexOf("{")).trimmed();
+        condition = this->ElseCondition();
     }
-    else if (trimmed.startsWith("else"))
+    else if (trimmed.contains("{"))
     {
-        condition = "NOT " + (this->ConditionalBlocks.isEmpty() ? QString("FALSE") : this->ConditionalBlocks.last().condition);
+        condition = trimmed.left(trimmed.indexOf("{")).trimmed();
     }
 
-    block.condition = this->NormalizeCondition(condition);
+    // The condition of an else block is built from the previous one and is already normalized
+    block.condition = trimmed.startsWith("else") ? condition : this->NormalizeCondition(condition);
     block.active = this->EvaluateCondition(block.condition);
 
     int brace_count = trimmed.contains("{") ? 1 : 0;
@@ -627,6 +861,12 @@ bool QMakeParser::ProcessScope(QString line, QStringList &lines, int &current_li
         if (current.isEmpty())
             continue;
 
+        if (brace_count == 1 && current.startsWith("}") && current.mid(1).trimmed().startsWith("else"))
+        {
+            // "} else {" ends this block, the caller reads the line again as the start of the next one
+            current_line--;
+            break;
+        }
         if (current.contains("{"))
             brace_count++;
         if (current.startsWith("}"))
@@ -643,31 +883,10 @@ bool QMakeParser::ProcessScope(QString line, QStringList &lines, int &current_li
         if (!this->ExtractAssignment(current, &word, &op, &data))
             continue;
 
-        QString upper = word.toUpper();
-        QStringList items = this->TokenizeValueList(data);
-        if (upper == "SOURCES")
-            this->ApplyListOperation(&block.Sources, op, items);
-        else if (upper == "HEADERS")
-            this->ApplyListOperation(&block.Headers, op, items);
-        else if (upper == "DEFINES")
-            this->ApplyListOperation(&block.Defines, op, items);
-        else if (upper == "INCLUDEPATH" || upper == "DEPENDPATH")
-            this->ApplyListOperation(&block.IncludePaths, op, items);
-        else if (upper == "LIBS")
-            this->ApplyListOperation(&block.Libraries, op, items);
-        else if (upper == "CONFIG")
-            this->ApplyListOperation(&block.Config, op, items);
-        else if (upper == "TRANSLATIONS")
-            this->ApplyListOperation(&block.TranslationFiles, op, items);
-        else if (upper == "QMAKE_CXXFLAGS")
-            this->ApplyListOperation(&block.CompileOptions, op, items);
-        else if (upper == "QMAKE_LFLAGS" || upper == "QMAKE_POST_LINK")
-            this->ApplyListOperation(&block.LinkOptions, op, items);
-        else if (upper == "INSTALLS")
-            this->ApplyListOperation(&block.InstallRules, op, items);
-    }
-
-    this->ConditionalBlocks.append(block);
+        this->ProcessScopedAssignment(&block, word, op, data, current_line + 1);
+    }
+
+    this->ConditionalBlocks.append(std::move(block));
     return true;
 }
 
@@ -688,11 +907,49 @@ QString QMakeParser::ParseCondition(QString condition)
         condition.startsWith("isEmpty(") || condition.startsWith("exists(") ||
         condition.startsWith("greaterThan(") || condition.startsWith("lessThan("))
     {
-        this->AddWarning("Condition function kept as a raw expression at line " + QString::number(this->CurrentLineNumber) + ": " + condition);
+        this->AddWarning(BuildWarning_RawCondition, this->CurrentLineNumber,
+                         "Condition function kept as a raw expression at line " + QString::number(this->CurrentLineNumber) + ": " + condition,
+                         "Check the generated condition by hand");
     }
     return condition;
 }
 
+QString QMakeParser::ElseCondition() const
+{
+    if (this->ConditionalBlocks.isEmpty())
+        return "NOT FALSE";
+    QString previous = this->ConditionalBlocks.last().condition;
+    if (previous == BuildConfig::Release)
+        return BuildConfig::Debug;
+    if (previous == BuildConfig::Debug)
+        return BuildConfig::Release;
+    return "NOT " + previous;
+}
+
+QString QMakeParser::BuildConfigScope(QString condition) const
+{
+    // debug, release and CONFIG(debug, debug|release) select a build configuration, a
+    // negated one selects the other configuration because qmake builds only these two
+    static const QRegularExpression config_function("^CONFIG\\(\\s*(debug|release)\\s*(,\\s*(debug\\|release|release\\|debug)\\s*)?\\)$");
+    condition = condition.trimmed();
+    bool negated = condition.startsWith("!");
+    if (negated)
+        condition = condition.mid(1).trimmed();
+    QString config;
+    if (condition == "debug" || condition == "release")
+        config = condition;
+    else
+    {
+        QRegularExpressionMatch match = config_function.match(condition);
+        if (!match.hasMatch())
+            return "";
+        config = match.captured(1);
+    }
+    if (negated)
+        config = config == "debug" ? "release" : "debug";
+    return config == "debug" ? BuildConfig::Debug : BuildConfig::Release;
+}
+
 QString QMakeParser::NormalizeCondition(QString condition)
 {
     condition = condition.trimmed();
@@ -702,6 +959,10 @@ QString QMakeParser::NormalizeCondition(QString condition)
         condition.chop(1);
     condition = condition.trimmed();
 
+    QString build_config = this->BuildConfigScope(condition);
+    if (!build_config.isEmpty())
+        return build_config;
+
     if (condition == "win32")
         return "WIN32";
     if (condition == "unix")
@@ -717,7 +978,7 @@ QString QMakeParser::NormalizeCondition(QString condition)
     return this->ParseCondition(condition);
 }
 
-bool QMakeParser::EvaluateCondition(QString condition)
+bool QMakeParser::EvaluateCondition(const QString &condition)
 {
     Q_UNUSED(condition);
     return true;
@@ -737,63 +998,66 @@ BuildTargetType QMakeParser::TargetTypeFromTemplate(QString value)
 
 BuildTargetType QMakeParser::TargetTypeFromConfig(BuildTargetType current_type) const
 {
-    if (this->Config.contains("testcase"))
+    if (this->Target.Config.contains("testcase"))
         return BuildTarget_Test;
-    if (this->Config.contains("plugin"))
+    if (this->Target.Config.contains("plugin"))
         return BuildTarget_Plugin;
     return current_type;
 }
 
 void QMakeParser::RefreshModel()
 {
-    QList<QString> warnings = this->Model->Warnings;
+    QList<BuildWarning> warnings = std::move(this->Model->Warnings);
+    QSet<QString> warning_keys = std::move(this->Model->WarningKeys);
     this->Model->Clear();
-    this->Model->Warnings = warnings;
+    this->Model->Warnings = std::move(warnings);
+    this->Model->WarningKeys = std::move(warning_keys);
     this->Model->Name = this->ProjectName;
     this->Model->CMakeMinimumVersion = this->CMakeMinimumVersion;
-    this->Model->GlobalConfig = this->Config;
-    this->Model->GlobalQtModules = this->Modules;
+    this->Model->GlobalConfig = this->Target.Config;
+    this->Model->GlobalQtModules = this->Target.QtModules;
+
+    // The parser is done with its lists, so they are handed over instead of copied.
+    // Variables still point at the moved-from lists until the next Parse() clears them.
+    // Values of the _RELEASE and _DEBUG variables join the target lists as generator expressions
+    for (int i = 0; i < QMakeVariableFieldCount; i++)
+    {
+        const QMakeVariableField *field = &QMakeVariableFields[i];
+        const QList<QString> *values = field->Kind == QMakeVariable_BuildConfigList ? this->FindVariable(field->Name) : nullptr;
+        if (values == nullptr || values->isEmpty())
+            continue;
+        QStringList wrapped = WrapInBuildConfig(BuildConfigCondition(field), *values);
+        Variable *variable = this->FindOrCreateVariable(TargetListKey(field->TargetList));
+        this->ApplyListOperation(variable->List(), &variable->Entries, "+=", wrapped);
+    }
 
+    BuildTargetType target_type = this->TargetTypeFromConfig(this->TargetType);
     BuildTarget *target = this->Model->EnsurePrimaryTarget();
+    *target = std::move(this->Target);
+    this->Target = BuildTarget();
     target->Name = this->ProjectName;
     if (target->Name.isEmpty() && this->IsSubdirsProject)
         target->Name = "MainProject";
-    target->Type = this->TargetTypeFromConfig(this->TargetType);
+    target->Type = target_type;
     target->Location = BuildSourceLocation(this->SourceFile, this->TargetLine);
-    target->Sources = this->Sources;
-    target->Headers = this->Headers;
-    target->UiFiles = this->UIFiles;
-    target->ResourceFiles = this->ResourceFiles;
-    target->TranslationFiles = this->TranslationFiles;
-    target->QtModules = this->Modules;
-    target->Config = this->Config;
-    target->Defines = this->Defines;
-    target->IncludePaths = this->IncludePaths;
-    target->Libraries = this->Libraries;
-    target->CompileOptions = this->CompileOptions;
-    target->LinkOptions = this->LinkOptions;
-    target->InstallRules = this->InstallRules;
-    target->Subdirectories = this->Subdirectories;
-
-    foreach (const ConditionalBlock &block, this->ConditionalBlocks)
-    {
-        BuildConditionalScope scope;
-        scope.Condition = block.condition;
-        scope.Location = BuildSourceLocation(this->SourceFile, block.line);
-        scope.Sources = block.Sources;
-        scope.Headers = block.Headers;
-        scope.Defines = block.Defines;
-        scope.IncludePaths = block.IncludePaths;
-        scope.Libraries = block.Libraries;
-        scope.TranslationFiles = block.TranslationFiles;
-        scope.CompileOptions = block.CompileOptions;
-        scope.LinkOptions = block.LinkOptions;
-        scope.InstallRules = block.InstallRules;
-        scope.Config = block.Config;
-        target->ConditionalScopes.append(scope);
-    }
-
-    foreach (QString subdir, this->Subdirectories)
+
+    target->ConditionalScopes.reserve(target->ConditionalScopes.size() + this->ConditionalBlocks.size());
+    for (int i = 0; i < this->ConditionalBlocks.size(); i++)
+    {
+        ConditionalBlock &block = this->ConditionalBlocks[i];
+        // Their values were already added to the target lists
+        if (IsBuildConfigCondition(block.condition))
+            continue;
+        block.Scope.Condition = std::move(block.condition);
+        block.Scope.Location = BuildSourceLocation(this->SourceFile, block.line);
+        target->ConditionalScopes.append(std::move(block.Scope));
+    }
+    this->ConditionalBlocks.clear();
+
+    // Appending targets moves the primary one, so the names are read from a copy
+    QList<QString> subdirectories = target->Subdirectories;
+    this->Model->Targets.reserve(this->Model->Targets.size() + subdirectories.size());
+    foreach (const QString &subdir, subdirectories)
     {
         BuildTarget subtarget;
         subtarget.Name = subdir;
@@ -803,9 +1067,9 @@ void QMakeParser::RefreshModel()
     }
 }
 
-void QMakeParser::AddWarning(QString warning)
+void QMakeParser::AddWarning(BuildWarningCode code, int line_number, QString message, QString suggestion)
 {
     if (this->Model != nullptr)
-        this->Model->AddWarning(warning);
-    Logs::DebugLog(warning);
+        this->Model->AddWarning(BuildWarning(code, BuildSourceLocation(this->SourceFile, line_number), message, suggestion));
+    Q2C_DEBUG_LOG(1, "qmake", this->SourceFile, line_number, message);
 }
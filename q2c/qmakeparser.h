@@ -13,9 +13,11 @@
 
 #include <QList>
 #include <QHash>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include "buildmodel.h"
+#include "tokenview.h"
 
 class QMakeParser
 {
@@ -25,52 +27,62 @@ class QMakeParser
         ParserState_FetchingData
     };
 
+    //! Value of a qmake variable. Variables that map onto the target point at its list,
+    //! so appending to them and expanding $$NAME never copies the values around.
+    struct Variable
+    {
+        QList<QString> *Values;   // Target list of known variables, nullptr when Storage holds the values
+        QList<QString> Storage;
+        QSet<QString> Entries;    // Same items as the values, keeps += linear in the number of new items
+
+        QList<QString> *List() { return this->Values != nullptr ? this->Values : &this->Storage; }
+        const QList<QString> *List() const { return this->Values != nullptr ? this->Values : &this->Storage; }
+    };
+
     struct ConditionalBlock
     {
         QString condition;
         bool active;
         int line;
-        QList<QString> Sources;
-        QList<QString> Headers;
-        QList<QString> Defines;
-        QList<QString> IncludePaths;
-        QList<QString> Libraries;
-        QList<QString> TranslationFiles;
-        QList<QString> CompileOptions;
-        QList<QString> LinkOptions;
-        QList<QString> InstallRules;
-        QList<QString> Config;
+        BuildConditionalScope Scope;
     };
 
     public:
         QMakeParser();
-        bool Parse(QString text, BuildProject *model, QString source_file, QString cmake_minimum_version);
+        bool Parse(const QString &text, BuildProject *model, const QString &source_file, const QString &cmake_minimum_version);
 
     private:
-        bool ParseStandardQMakeList(QList<QString> *list, QString line, QString text);
-        bool ApplyListOperation(QList<QString> *list, QString op, QStringList items);
-        bool ProcessAssignment(QString word, QString op, QString data);
-        bool ProcessSimpleKeyword(QString word, QString line);
-        bool ProcessComplexKeyword(QString word, QString line, QString data_buffer);
-        bool ProcessScope(QString line, QStringList &lines, int &current_line);
-        bool ProcessInlineScope(QString condition, QString scoped_line, int line_number);
-        bool ProcessLine(QString line);
-        bool ExtractAssignment(QString line, QString *word, QString *op, QString *data);
-        int FindScopeColon(QString line);
-        bool ProcessInclude(QString line);
-        QString LoadIncludedFile(QString include_path);
-        QString StripComment(QString line);
+        bool ParseStandardQMakeList(QList<QString> *list, const QString &line, const QString &text);
+        bool ApplyListOperation(QList<QString> *list, QSet<QString> *entries, const QString &op, const QStringList &items);
+        Variable *FindOrCreateVariable(const QString &name);
+        const QList<QString> *FindVariable(const QString &name) const;
+        bool ProcessAssignment(const QString &raw_word, const QString &op, const QString &data);
+        bool ProcessSimpleKeyword(const QString &word, const QString &line);
+        bool ProcessComplexKeyword(const QString &word, const QString &line, const QString &data_buffer);
+        bool ProcessScope(const QString &line, const QStringList &lines, int &current_line);
+        bool ProcessInlineScope(const QString &condition, const QString &scoped_line, int line_number);
+        bool ProcessScopedAssignment(ConditionalBlock *block, const QString &word, const QString &op, const QString &data, int line_number);
+        bool ProcessLine(const QString &line);
+        bool ExtractAssignment(const QString &line, QString *word, QString *op, QString *data);
+        int FindScopeColon(const QString &line) const;
+        bool ProcessInclude(const QString &line);
+        QString LoadIncludedFile(const QString &include_path);
+        QString StripComment(const QString &line) const;
         QString ExpandVariables(QString text);
-        QStringList ExpandToken(QString token);
-        QStringList TokenizeValueList(QString text);
+        QStringList ExpandToken(const QString &token);
+        void TokenizeValueList(QStringView text, QList<TokenView> *tokens) const;
+        QStringList ReadValueList(QStringView text);
         QString NormalizeCondition(QString condition);
-        QStringList NormalizeLines(QString text);
+        QString ElseCondition() const;
+        //! BuildConfig::Debug or BuildConfig::Release for a qmake condition on the build configuration, empty otherwise
+        QString BuildConfigScope(QString condition) const;
+        QStringList NormalizeLines(const QString &text) const;
         QString ParseCondition(QString condition);
-        bool EvaluateCondition(QString condition);
+        bool EvaluateCondition(const QString &condition);
         void RefreshModel();
         BuildTargetType TargetTypeFromTemplate(QString value);
         BuildTargetType TargetTypeFromConfig(BuildTargetType current_type) const;
-        void AddWarning(QString warning);
+        void AddWarning(BuildWarningCode code, int line_number, QString message, QString suggestion = "");
 
         BuildProject *Model;
         QString SourceFile;
@@ -78,26 +90,12 @@ class QMakeParser
         QString CMakeMinimumVersion;
         QString ProjectName;
         QString TemplateName;
-        QList<QString> KnownSimpleKeywords;
-        QList<QString> KnownComplexKeywords;
         QList<QString> RequiredKeywords;
         QList<QString> RemainingRequiredKeywords;
-        QList<QString> Sources;
-        QList<QString> Headers;
-        QList<QString> Modules;
-        QList<QString> Config;
-        QList<QString> Defines;
-        QList<QString> IncludePaths;
-        QList<QString> Libraries;
-        QHash<QString, QStringList> Variables;
-        QList<QString> UIFiles;
-        QList<QString> ResourceFiles;
-        QList<QString> TranslationFiles;
-        QList<QString> CompileOptions;
-        QList<QString> LinkOptions;
-        QList<QString> InstallRules;
-        QList<QString> Subdirectories;
+        BuildTarget Target; // Top-level lists, filled through the variable table in qmakeparser.cpp
+        QHash<QString, Variable> Variables; // Keyed by VariableKey(), see qmakeparser.cpp
         QList<ConditionalBlock> ConditionalBlocks;
+        QList<TokenView> Tokens; // Reused by ReadValueList(), points into the line being parsed
         BuildTargetType TargetType;
         int CurrentLineNumber;
         int TargetLine;
@@ -0,0 +1,231 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include <QHash>
+#include <QSet>
+#include "roundtrip.h"
+#include "cmakeparser.h"
+#include "qmakegenerator.h"
+#include "qmakeparser.h"
+
+static void CompareLists(const QString &target, const QString &condition, const QString &field, const QList<QString> &original,
+                         const QList<QString> &reparsed, QList<RoundTripDifference> *differences)
+{
+    if (original == reparsed)
+        return;
+    QSet<QString> original_set(original.begin(), original.end());
+    QSet<QString> reparsed_set(reparsed.begin(), reparsed.end());
+    RoundTripDifference difference;
+    foreach (const QString &value, original)
+    {
+        if (!reparsed_set.contains(value) && !difference.Lost.contains(value))
+            difference.Lost.append(value);
+    }
+    foreach (const QString &value, reparsed)
+    {
+        if (!original_set.contains(value) && !difference.Added.contains(value))
+            difference.Added.append(value);
+    }
+    if (difference.Lost.isEmpty() && difference.Added.isEmpty())
+        return;
+    difference.Target = target;
+    difference.Condition = condition;
+    difference.Field = field;
+    differences->append(difference);
+}
+
+static void CompareValue(const QString &target, const QString &field, const QString &original, const QString &reparsed,
+                         QList<RoundTripDifference> *differences)
+{
+    if (original == reparsed)
+        return;
+    QList<QString> original_list;
+    QList<QString> reparsed_list;
+    if (!original.isEmpty())
+        original_list.append(original);
+    if (!reparsed.isEmpty())
+        reparsed_list.append(reparsed);
+    CompareLists(target, "", field, original_list, reparsed_list, differences);
+}
+
+//! qmake links "-lssl" and "-framework Cocoa" as two words, CMake links "ssl" and "-framework Cocoa"
+static QList<QString> NormalizeLibraries(const QList<QString> &libraries)
+{
+    QList<QString> normalized;
+    for (int i = 0; i < libraries.size(); i++)
+    {
+        const QString &library = libraries.at(i);
+        if (library == "-framework" && i + 1 < libraries.size())
+            normalized.append(library + " " + libraries.at(++i));
+        else if (library.startsWith("-l"))
+            normalized.append(library.mid(2));
+        else
+            normalized.append(library);
+    }
+    return normalized;
+}
+
+//! Scopes with the same condition are merged, generators write one block per condition.
+//! Nested scopes are compared by the conditions of their parents joined with their own
+static QList<BuildConditionalScope> MergeScopes(const BuildTarget &target)
+{
+    QList<BuildConditionalScope> merged;
+    QHash<QString, int> index;
+    for (int i = 0; i < target.ConditionalScopes.size(); i++)
+    {
+        const BuildConditionalScope &scope = target.ConditionalScopes.at(i);
+        QString condition = scope.Parent >= 0 ? target.ScopeCondition(i) : scope.Condition;
+        int position = index.value(condition, -1);
+        if (position < 0)
+        {
+            index.insert(condition, merged.size());
+            merged.append(scope);
+            merged.last().Condition = condition;
+            merged.last().Parent = -1;
+            continue;
+        }
+        for (const BuildScopeList &list : BuildScopeLists)
+            (merged[position].*list.List).append(scope.*list.List);
+    }
+    return merged;
+}
+
+static void CompareTargets(const BuildTarget &original, const BuildTarget &reparsed, QList<RoundTripDifference> *differences)
+{
+    CompareValue(original.Name, "Type", original.TypeName(), reparsed.TypeName(), differences);
+    for (const BuildTargetList &list : BuildTargetLists)
+    {
+        if (list.List == &BuildTarget::Libraries)
+            CompareLists(original.Name, "", list.Name, NormalizeLibraries(original.Libraries), NormalizeLibraries(reparsed.Libraries), differences);
+        else
+            CompareLists(original.Name, "", list.Name, original.*list.List, reparsed.*list.List, differences);
+    }
+
+    QList<BuildConditionalScope> original_scopes = MergeScopes(original);
+    QList<BuildConditionalScope> reparsed_scopes = MergeScopes(reparsed);
+    BuildConditionalScope empty;
+    foreach (const BuildConditionalScope &scope, original_scopes)
+    {
+        const BuildConditionalScope *match = &empty;
+        for (int i = 0; i < reparsed_scopes.size(); i++)
+        {
+            if (reparsed_scopes.at(i).Condition == scope.Condition)
+                match = &reparsed_scopes.at(i);
+        }
+        for (const BuildScopeList &list : BuildScopeLists)
+        {
+            if (list.List == &BuildConditionalScope::Libraries)
+                CompareLists(original.Name, scope.Condition, list.Name, NormalizeLibraries(scope.Libraries), NormalizeLibraries(match->Libraries), differences);
+            else
+                CompareLists(original.Name, scope.Condition, list.Name, scope.*list.List, match->*list.List, differences);
+        }
+    }
+    foreach (const BuildConditionalScope &scope, reparsed_scopes)
+    {
+        bool known = false;
+        foreach (const BuildConditionalScope &candidate, original_scopes)
+            known = known || candidate.Condition == scope.Condition;
+        if (known)
+            continue;
+        for (const BuildScopeList &list : BuildScopeLists)
+            CompareLists(original.Name, scope.Condition, list.Name, empty.*list.List, scope.*list.List, differences);
+    }
+}
+
+bool RoundTrip::Verify(const BuildProject &original, bool qmake_input, CMakeQtVersion version,
+                       const QList<CMakeOption> &options, QList<RoundTripDifference> *differences)
+{
+    BuildProject reparsed;
+    if (qmake_input)
+    {
+        QString generated = CMakeGenerator(version).Generate(original, options);
+        if (!CMakeParser().Parse(generated, &reparsed, "generated/CMakeLists.txt"))
+            return false;
+    } else
+    {
+        QString generated = QMakeGenerator().Generate(original);
+        if (!QMakeParser().Parse(generated, &reparsed, "generated/project.pro", original.CMakeMinimumVersion))
+            return false;
+    }
+    *differences = RoundTrip::Compare(original, reparsed);
+    return true;
+}
+
+QList<RoundTripDifference> RoundTrip::Compare(const BuildProject &original, const BuildProject &reparsed)
+{
+    QList<RoundTripDifference> differences;
+    CompareValue("", "Name", original.Name, reparsed.Name, &differences);
+
+    BuildTarget empty;
+    foreach (const BuildTarget &target, original.Targets)
+    {
+        const BuildTarget *match = nullptr;
+        for (int i = 0; i < reparsed.Targets.size() && match == nullptr; i++)
+        {
+            if (reparsed.Targets.at(i).Name == target.Name)
+                match = &reparsed.Targets.at(i);
+        }
+        if (match == nullptr)
+        {
+            empty.Name = target.Name;
+            empty.Type = target.Type;
+            match = &empty;
+            RoundTripDifference difference;
+            difference.Field = "Targets";
+            difference.Lost.append(target.Name);
+            differences.append(difference);
+        }
+        CompareTargets(target, *match, &differences);
+    }
+    return differences;
+}
+
+static QString JoinValues(const QStringList &values)
+{
+    QString text;
+    foreach (const QString &value, values)
+    {
+        if (!text.isEmpty())
+            text += ", ";
+        // Keeps "src/main file.cpp" apart from the two files "src/main" and "file.cpp"
+        if (value.contains(' ') || value.contains(','))
+            text += "\"" + value + "\"";
+        else
+            text += value;
+    }
+    return text;
+}
+
+bool RoundTrip::HasLostValues(const QList<RoundTripDifference> &differences)
+{
+    foreach (const RoundTripDifference &difference, differences)
+    {
+        if (!difference.Lost.isEmpty())
+            return true;
+    }
+    return false;
+}
+
+QString RoundTrip::Format(const QList<RoundTripDifference> &differences)
+{
+    QString text;
+    foreach (const RoundTripDifference &difference, differences)
+    {
+        QString prefix = difference.Target.isEmpty() ? "project" : difference.Target;
+        if (!difference.Condition.isEmpty())
+            prefix += " [" + difference.Condition + "]";
+        prefix += " " + difference.Field;
+        if (!difference.Lost.isEmpty())
+            text += prefix + " lost: " + JoinValues(difference.Lost) + "\n";
+        if (!difference.Added.isEmpty())
+            text += prefix + " added: " + JoinValues(difference.Added) + "\n";
+    }
+    return text;
+}
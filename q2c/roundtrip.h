@@ -0,0 +1,48 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef ROUNDTRIP_H
+#define ROUNDTRIP_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include "buildmodel.h"
+#include "cmakegenerator.h"
+
+//! One model field that did not survive the conversion to the other format and back
+class RoundTripDifference
+{
+    public:
+        QString Target;     // Empty for project fields
+        QString Condition;  // Condition of the scope, empty for fields of the target itself
+        QString Field;      // Name of the model field, such as Sources
+        QStringList Lost;   // Values of the original model the reparsed model does not have
+        QStringList Added;  // Values only the reparsed model has
+};
+
+class RoundTrip
+{
+    public:
+        //! Generates the other format from the model, parses the result with the other parser and compares
+        //! both models. Returns false when the generated text does not parse
+        static bool Verify(const BuildProject &original, bool qmake_input, CMakeQtVersion version,
+                           const QList<CMakeOption> &options, QList<RoundTripDifference> *differences);
+        //! Compares two models semantically. Targets are matched by name, scopes by condition,
+        //! and lists are compared as sets because generators may reorder or merge them. Libraries are
+        //! compared in CMake spelling
+        static QList<RoundTripDifference> Compare(const BuildProject &original, const BuildProject &reparsed);
+        //! Values the reparsed model only gained are reported, but only lost values fail a verification
+        static bool HasLostValues(const QList<RoundTripDifference> &differences);
+        //! One line per difference, empty when there is none
+        static QString Format(const QList<RoundTripDifference> &differences);
+};
+
+#endif // ROUNDTRIP_H
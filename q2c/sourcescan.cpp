@@ -0,0 +1,55 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+
+#include <QFile>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include "sourcescan.h"
+
+class SourceScanJob : public QRunnable
+{
+    public:
+        SourceScanJob(SourceScanner *scanner, const QString &path, int index)
+        {
+            this->Scanner = scanner;
+            this->Path = path;
+            this->Index = index;
+        }
+
+        void run() override
+        {
+            QFile file(this->Path);
+            if (!file.open(QIODevice::ReadOnly))
+                return;
+            this->Scanner->ScanText(this->Index, QString(file.readAll()));
+            file.close();
+        }
+
+    private:
+        SourceScanner *Scanner;
+        QString Path;
+        int Index;
+};
+
+SourceScanner::~SourceScanner()
+{
+}
+
+void SourceScanner::ReadFiles(const QStringList &paths)
+{
+    // Every job fills its own entry, the results are not touched until the pool is done
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(1, qMin(static_cast<int>(paths.size()), QThread::idealThreadCount())));
+    for (int i = 0; i < paths.size(); i++)
+        pool.start(new SourceScanJob(this, paths.at(i), i));
+    pool.waitForDone();
+}
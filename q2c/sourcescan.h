@@ -0,0 +1,30 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+
+#ifndef SOURCESCAN_H
+#define SOURCESCAN_H
+
+#include <QString>
+#include <QStringList>
+
+//! Reads the sources of a target on a thread pool, for the analyzers that look at every one
+//! of them. Subclasses turn the text of each file into their own results
+class SourceScanner
+{
+    public:
+        virtual ~SourceScanner();
+        //! Returns once every file is done, ScanText() is only called for the ones that could be read
+        void ReadFiles(const QStringList &paths);
+        //! Runs on a pool thread, so it must only touch the results of the file at index
+        virtual void ScanText(int index, const QString &text) = 0;
+};
+
+#endif // SOURCESCAN_H
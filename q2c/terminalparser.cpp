@@ -15,6 +15,9 @@
 #include "generic.h"
 #include "terminalparser.h"
 #include "configuration.h"
+#include "modeljson.h"
+#include "project.h"
+#include "warningreport.h"
 
 #ifndef Q2C_VERSION
 #define Q2C_VERSION "0.1.0"
@@ -50,6 +53,26 @@ static int Parser_OutputDirectory(TerminalParser *parser, QStringList params)
     return TP_RESULT_OK;
 }
 
+static int Parser_SaveModel(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    if (params.isEmpty())
+        return TP_RESULT_FAIL;
+
+    Configuration::SaveModelFile = params.at(0);
+    return TP_RESULT_OK;
+}
+
+static int Parser_LoadModel(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    if (params.isEmpty())
+        return TP_RESULT_FAIL;
+
+    Configuration::LoadModelFile = params.at(0);
+    return TP_RESULT_OK;
+}
+
 static int Parser_Debug(TerminalParser *parser, QStringList params)
 {
     Q_UNUSED(parser);
@@ -128,6 +151,103 @@ static int Parser_Check(TerminalParser *parser, QStringList params)
     return TP_RESULT_OK;
 }
 
+static int Parser_EmitModel(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    if (params.isEmpty())
+        return TP_RESULT_FAIL;
+
+    QString format = params.at(0).toLower();
+    if (format != "json")
+    {
+        std::cerr << "Invalid model format: " << format.toStdString() << std::endl;
+        return TP_RESULT_FAIL;
+    }
+    Configuration::EmitModelFormat = format;
+    return TP_RESULT_OK;
+}
+
+static int Parser_Query(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    if (params.isEmpty())
+        return TP_RESULT_FAIL;
+
+    QString error;
+    if (!ModelJson::IsValidSelector(params.at(0), &error))
+    {
+        std::cerr << "Invalid query: " << error.toStdString() << std::endl;
+        return TP_RESULT_FAIL;
+    }
+    Configuration::ModelQuery = params.at(0);
+    Configuration::EmitModelFormat = "json";
+    return TP_RESULT_OK;
+}
+
+static int Parser_Emit(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    if (params.isEmpty())
+        return TP_RESULT_FAIL;
+
+    ProjectOutput output;
+    QString error;
+    if (!ProjectOutput::Parse(params.at(0), &output, &error))
+    {
+        std::cerr << "Invalid output: " << error.toStdString() << std::endl;
+        return TP_RESULT_FAIL;
+    }
+    Configuration::EmitOutputs.append(params.at(0));
+    return TP_RESULT_OK;
+}
+
+static int Parser_CompileCommands(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    if (params.isEmpty())
+        return TP_RESULT_FAIL;
+
+    Configuration::EmitOutputs.append("compile-commands:" + params.at(0));
+    return TP_RESULT_OK;
+}
+
+static int Parser_CMakePresets(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    if (params.isEmpty())
+        return TP_RESULT_FAIL;
+
+    Configuration::EmitOutputs.append("presets:" + params.at(0));
+    return TP_RESULT_OK;
+}
+
+static int Parser_Unity(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    if (params.isEmpty())
+        return TP_RESULT_FAIL;
+
+    bool ok = false;
+    int size = params.at(0).toInt(&ok);
+    if (!ok || size < 2)
+    {
+        std::cerr << "Invalid unity batch size: " << params.at(0).toStdString() << ", use a number of at least 2" << std::endl;
+        return TP_RESULT_FAIL;
+    }
+    Configuration::UnityBatchSize = size;
+    return TP_RESULT_OK;
+}
+
+static int Parser_QtPrefix(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    if (params.isEmpty())
+        return TP_RESULT_FAIL;
+
+    Configuration::QtPrefix = params.at(0);
+    return TP_RESULT_OK;
+}
+
 static int Parser_Strict(TerminalParser *parser, QStringList params)
 {
     Q_UNUSED(parser);
@@ -136,6 +256,54 @@ static int Parser_Strict(TerminalParser *parser, QStringList params)
     return TP_RESULT_OK;
 }
 
+static int Parser_VerifyRoundTrip(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    Q_UNUSED(params);
+    Configuration::verify_roundtrip = true;
+    return TP_RESULT_OK;
+}
+
+static int Parser_SuggestPch(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    Q_UNUSED(params);
+    Configuration::suggest_pch = true;
+    return TP_RESULT_OK;
+}
+
+static int Parser_Pgo(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    Q_UNUSED(params);
+    Configuration::pgo = true;
+    return TP_RESULT_OK;
+}
+
+static int Parser_BuildAccel(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    Q_UNUSED(params);
+    Configuration::build_accel = true;
+    return TP_RESULT_OK;
+}
+
+static int Parser_MemoryReport(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    Q_UNUSED(params);
+    Configuration::memory_report = true;
+    return TP_RESULT_OK;
+}
+
+static int Parser_ParserStats(TerminalParser *parser, QStringList params)
+{
+    Q_UNUSED(parser);
+    Q_UNUSED(params);
+    Configuration::parser_stats = true;
+    return TP_RESULT_OK;
+}
+
 static int Parser_Warnings(TerminalParser *parser, QStringList params)
 {
     Q_UNUSED(parser);
@@ -143,7 +311,7 @@ static int Parser_Warnings(TerminalParser *parser, QStringList params)
         return TP_RESULT_FAIL;
 
     QString format = params.at(0).toLower();
-    if (format != "text" && format != "json")
+    if (!WarningReport::IsSupportedFormat(format))
     {
         std::cerr << "Invalid warning format: " << format.toStdString() << std::endl;
         return TP_RESULT_FAIL;
@@ -242,6 +410,9 @@ static int PrintHelp(TerminalParser *parser, QStringList params)
               << "  q2c --cmake-to-qmake -i CMakeLists.txt -o app.pro" << std::endl
               << "  q2c --check --strict -i app.pro" << std::endl
               << "  q2c --backup --force -i app.pro -o CMakeLists.txt" << std::endl
+              << "  q2c --check --save-model app.q2cm -i app.pro && q2c --qt5 --load-model app.q2cm -o CMakeLists.txt" << std::endl
+              << "  q2c --query 'Targets[].Sources' -i app.pro" << std::endl
+              << "  q2c --emit qt5:CMakeLists.qt5.txt --emit qt6:CMakeLists.txt --emit qmake:roundtrip.pro -i app.pro" << std::endl
               << std::endl;
     std::cout << "This software is open source, contribute at http://github.com/benapetr/q2c" << std::endl;
 
@@ -267,7 +438,22 @@ TerminalParser::TerminalParser()
     this->Register(0, "dry-run", "Print converted output to stdout without writing files", 0, (TP_Callback)Parser_DryRun);
     this->Register(0, "check", "Parse and validate input without writing output", 0, (TP_Callback)Parser_Check);
     this->Register(0, "strict", "Fail when conversion warnings are emitted", 0, (TP_Callback)Parser_Strict);
-    this->Register(0, "warnings", "Warning output format: text or json", 1, (TP_Callback)Parser_Warnings);
+    this->Register(0, "verify-roundtrip", "Convert, parse the result back and fail when model fields were lost", 0, (TP_Callback)Parser_VerifyRoundTrip);
+    this->Register(0, "suggest-pch", "Write <target>_pch.h with the headers most sources include and precompile it", 0, (TP_Callback)Parser_SuggestPch);
+    this->Register(0, "unity", "Group the sources into unity batches of at most SIZE that do not share file local names", 1, (TP_Callback)Parser_Unity);
+    this->Register(0, "pgo", "Add a PGO cache variable to the CMake output that instruments or optimizes the target with GCC or Clang profiles", 0, (TP_Callback)Parser_Pgo);
+    this->Register(0, "build-accel", "Add options to the CMake output that use ccache or sccache, mold or lld, split DWARF and a Ninja link pool", 0, (TP_Callback)Parser_BuildAccel);
+    this->Register(0, "warnings", "Warning output format: text, json or sarif", 1, (TP_Callback)Parser_Warnings);
+    this->Register(0, "memory-report", "Print allocation count, allocated bytes and peak RSS to stderr", 0, (TP_Callback)Parser_MemoryReport);
+    this->Register(0, "parser-stats", "Print how many times every CMake command was handled to stderr", 0, (TP_Callback)Parser_ParserStats);
+    this->Register(0, "save-model", "Write the parsed project model to a binary cache file", 1, (TP_Callback)Parser_SaveModel);
+    this->Register(0, "load-model", "Generate output from a model cache instead of parsing input", 1, (TP_Callback)Parser_LoadModel);
+    this->Register(0, "emit", "Generate KIND:FILE from the same parse, KIND is qt4, qt5, qt6, cmake, qmake, compile-commands, ninja or presets, can be repeated", 1, (TP_Callback)Parser_Emit);
+    this->Register(0, "compile-commands", "Write a compile_commands.json for the host platform, same as --emit compile-commands:FILE", 1, (TP_Callback)Parser_CompileCommands);
+    this->Register(0, "cmake-presets", "Write a CMakePresets.json with release, relwithdebinfo and fast Ninja presets, same as --emit presets:FILE", 1, (TP_Callback)Parser_CMakePresets);
+    this->Register(0, "qt-prefix", "Qt installation or include directory used for compile commands, ninja and presets, defaults to $QTDIR", 1, (TP_Callback)Parser_QtPrefix);
+    this->Register(0, "emit-model", "Print the parsed project model to stdout instead of converting it, format json", 1, (TP_Callback)Parser_EmitModel);
+    this->Register(0, "query", "Print only the model fields picked by a selector such as Targets[].Sources as JSON lines", 1, (TP_Callback)Parser_Query);
     this->Register(0, "qmake-to-cmake", "Convert qmake input to CMake output", 0, (TP_Callback)Parser_QmakeToCmake);
     this->Register(0, "cmake-to-qmake", "Convert CMake input to qmake output", 0, (TP_Callback)Parser_CmakeToQmake);
 }
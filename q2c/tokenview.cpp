@@ -0,0 +1,41 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "tokenview.h"
+
+TokenView::TokenView()
+{
+    this->Quoted = false;
+}
+
+TokenView::TokenView(QStringView text, bool quoted)
+{
+    this->Text = text;
+    this->Quoted = quoted;
+}
+
+QString TokenView::ToString() const
+{
+    if (!this->Quoted)
+        return this->Text.toString();
+
+    // The tokenizers drop every quote character that is not escaped, the quoting
+    // state only decides where a token ends
+    QString result;
+    result.reserve(this->Text.size());
+    for (int i = 0; i < this->Text.size(); i++)
+    {
+        QChar ch = this->Text[i];
+        if ((ch == '"' || ch == '\'') && (i == 0 || this->Text[i - 1] != '\\'))
+            continue;
+        result += ch;
+    }
+    return result;
+}
@@ -0,0 +1,32 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef TOKENVIEW_H
+#define TOKENVIEW_H
+
+#include <QString>
+#include <QStringView>
+
+//! Token produced by the qmake and CMake tokenizers, it points into the text that
+//! was tokenized and is only copied into a QString once the value is kept
+class TokenView
+{
+    public:
+        TokenView();
+        TokenView(QStringView text, bool quoted);
+        //! Copy of the token with the quote characters removed
+        QString ToString() const;
+        bool Contains(QChar ch) const { return this->Text.indexOf(ch) >= 0; }
+        QStringView Text;
+        //! Text contains quote characters that are not part of the value
+        bool Quoted;
+};
+
+#endif // TOKENVIEW_H
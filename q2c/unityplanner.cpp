@@ -0,0 +1,493 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include <QDir>
+#include <QHash>
+#include <algorithm>
+#include "compileflags.h"
+#include "sourcescan.h"
+#include "unityplanner.h"
+
+enum UnityScope
+{
+    UnityScope_Namespace,
+    UnityScope_Anonymous,
+    UnityScope_Other        // Classes, functions and initializers, their contents are skipped
+};
+
+UnityPlan::UnityPlan()
+{
+    this->BatchSize = 0;
+}
+
+bool UnityPlan::IsEmpty() const
+{
+    return this->Batches.isEmpty();
+}
+
+QString UnityPlan::Report() const
+{
+    QString report = QString("Unity build of %1: %2 batches of up to %3 sources, %4 sources compiled on their own\n")
+                     .arg(this->Target).arg(this->Batches.size()).arg(this->BatchSize).arg(this->Excluded.size());
+    foreach (const UnityBatch &batch, this->Batches)
+        report += "  " + batch.Name + ": " + batch.Sources.join(" ") + "\n";
+    if (!this->Excluded.isEmpty())
+        report += "  on their own: " + this->Excluded.join(" ") + "\n";
+    foreach (const QString &note, this->Notes)
+        report += "  " + note + "\n";
+    return report;
+}
+
+static bool IsIdentifierChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == '_';
+}
+
+//! Blanks comments and the contents of string and character literals, line breaks are kept
+static QString StripCommentsAndLiterals(const QString &text)
+{
+    QString result;
+    result.reserve(text.size());
+    int i = 0;
+    while (i < text.size())
+    {
+        QChar c = text.at(i);
+        QChar next = i + 1 < text.size() ? text.at(i + 1) : QChar();
+        if (c == '/' && next == '/')
+        {
+            while (i < text.size() && text.at(i) != '\n')
+                i++;
+            continue;
+        }
+        if (c == '/' && next == '*')
+        {
+            i += 2;
+            while (i < text.size() && !(text.at(i) == '*' && i + 1 < text.size() && text.at(i + 1) == '/'))
+            {
+                if (text.at(i) == '\n')
+                    result += '\n';
+                i++;
+            }
+            i += 2;
+            result += ' ';
+            continue;
+        }
+        if ((c == '"' || c == '\'') && !(i > 0 && IsIdentifierChar(text.at(i - 1)) && c == '\''))
+        {
+            result += c;
+            i++;
+            while (i < text.size() && text.at(i) != c && text.at(i) != '\n')
+            {
+                if (text.at(i) == '\\')
+                    i++;
+                i++;
+            }
+            result += c;
+            i++;
+            continue;
+        }
+        result += c;
+        i++;
+    }
+    return result;
+}
+
+static QString FirstIdentifier(const QString &text, int from = 0)
+{
+    int start = from;
+    while (start < text.size() && !IsIdentifierChar(text.at(start)))
+        start++;
+    int end = start;
+    while (end < text.size() && IsIdentifierChar(text.at(end)))
+        end++;
+    return text.mid(start, end - start);
+}
+
+static QString LastIdentifier(const QString &text)
+{
+    int end = text.size();
+    while (end > 0 && text.at(end - 1).isSpace())
+        end--;
+    int start = end;
+    while (start > 0 && IsIdentifierChar(text.at(start - 1)))
+        start--;
+    if (start == end || text.at(start).isDigit() || text.left(start).trimmed().endsWith("::"))
+        return "";
+    return text.mid(start, end - start);
+}
+
+static int CountIdentifiers(const QString &text)
+{
+    int count = 0;
+    for (int i = 0; i < text.size(); i++)
+    {
+        if (IsIdentifierChar(text.at(i)) && (i == 0 || !IsIdentifierChar(text.at(i - 1))))
+            count++;
+    }
+    return count;
+}
+
+//! Name a file scope declaration introduces, empty when it is not a declaration
+static QString DeclaredName(QString statement)
+{
+    if (statement.startsWith("template"))
+    {
+        int depth = 0;
+        for (int i = 0; i < statement.size(); i++)
+        {
+            if (statement.at(i) == '<')
+                depth++;
+            else if (statement.at(i) == '>' && --depth == 0)
+            {
+                statement = statement.mid(i + 1).trimmed();
+                break;
+            }
+        }
+    }
+    QString first = FirstIdentifier(statement);
+    while (first == "static" || first == "inline" || first == "constexpr")
+    {
+        statement = statement.mid(statement.indexOf(first) + first.size()).trimmed();
+        first = FirstIdentifier(statement);
+    }
+    if (first == "class" || first == "struct" || first == "union" || first == "enum")
+    {
+        QString rest = statement.mid(first.size()).trimmed();
+        QString name = FirstIdentifier(rest);
+        if (first == "enum" && (name == "class" || name == "struct"))
+            name = FirstIdentifier(rest, rest.indexOf(name) + name.size());
+        return name;
+    }
+    if (first == "using")
+    {
+        int equals = statement.indexOf('=');
+        return equals > 0 ? LastIdentifier(statement.left(equals)) : "";
+    }
+    if (first == "typedef")
+        return LastIdentifier(statement);
+
+    int parenthesis = statement.indexOf('(');
+    int equals = statement.indexOf('=');
+    if (parenthesis >= 0 && (equals < 0 || parenthesis < equals))
+    {
+        // A single name in front of the parenthesis is a macro call, not a declaration
+        QString head = statement.left(parenthesis);
+        if (CountIdentifiers(head) < 2)
+            return "";
+        QString name = LastIdentifier(head);
+        return name == "operator" ? "" : name;
+    }
+    int end = statement.size();
+    foreach (QChar stop, QList<QChar>() << '=' << '[' << ',' << '{')
+    {
+        int position = statement.indexOf(stop);
+        if (position >= 0 && position < end)
+            end = position;
+    }
+    QString head = statement.left(end);
+    return CountIdentifiers(head) < 2 ? "" : LastIdentifier(head);
+}
+
+//! True for a namespace scope const or constexpr variable, those have internal linkage unless
+//! they are extern or inline
+static bool IsConstVariable(const QString &statement)
+{
+    int end = statement.size();
+    foreach (QChar stop, QList<QChar>() << '=' << '[' << '{')
+    {
+        int position = statement.indexOf(stop);
+        if (position >= 0 && position < end)
+            end = position;
+    }
+    // Template arguments such as QList<const char *> say nothing about the variable itself
+    QString head;
+    int depth = 0;
+    for (int i = 0; i < end; i++)
+    {
+        QChar c = statement.at(i);
+        if (c == '<')
+            depth++;
+        else if (c == '>')
+            depth--;
+        else if (depth == 0)
+            head += c;
+    }
+    if (head.contains('(') || CountIdentifiers(head) < 2)
+        return false;
+    QStringList words;
+    for (int i = 0; i < head.size(); i++)
+    {
+        if (IsIdentifierChar(head.at(i)) && (i == 0 || !IsIdentifierChar(head.at(i - 1))))
+            words << FirstIdentifier(head, i);
+    }
+    if (words.contains("extern") || words.contains("inline") || words.contains("typedef") || words.contains("using"))
+        return false;
+    if (words.contains("constexpr"))
+        return true;
+    // const char *name points to const data, only char *const name is a const variable
+    int pointer = head.lastIndexOf('*');
+    if (pointer >= 0)
+        return FirstIdentifier(head, pointer + 1) == "const";
+    return words.contains("const") && !head.contains('&');
+}
+
+UnitySymbols UnityPlanner::Scan(const QString &text)
+{
+    UnitySymbols symbols;
+    QStringList lines = StripCommentsAndLiterals(text).split('\n');
+    QList<UnityScope> scopes;
+    int skipped_depth = 0;
+    QString statement;
+    for (int index = 0; index < lines.size(); index++)
+    {
+        QString line = lines.at(index);
+        if (line.trimmed().startsWith('#'))
+        {
+            while (line.endsWith('\\') && index + 1 < lines.size())
+                line = line.left(line.size() - 1) + " " + lines.at(++index);
+            QString directive = line.trimmed().mid(1).trimmed();
+            QString word = FirstIdentifier(directive);
+            QString name = FirstIdentifier(directive, word.size());
+            if (word == "define" && !name.isEmpty())
+                symbols.Macros.insert(name);
+            else if (word == "undef")
+                symbols.Macros.remove(name);
+            continue;
+        }
+
+        line += '\n';
+        for (QChar c : line)
+        {
+            if (skipped_depth > 0)
+            {
+                if (c == '{')
+                    skipped_depth++;
+                else if (c == '}')
+                    skipped_depth--;
+                continue;
+            }
+            if (c != '{' && c != '}' && c != ';')
+            {
+                statement += c;
+                continue;
+            }
+
+            QString simplified = statement.simplified();
+            statement.clear();
+            if (c == '}')
+            {
+                if (!scopes.isEmpty())
+                    scopes.removeLast();
+                continue;
+            }
+
+            QString first = FirstIdentifier(simplified);
+            if (c == '{' && (first == "namespace" || (first == "inline" && simplified.contains("namespace"))))
+            {
+                QString rest = simplified.mid(simplified.indexOf("namespace") + 9).trimmed();
+                scopes.append(rest.isEmpty() ? UnityScope_Anonymous : UnityScope_Namespace);
+                continue;
+            }
+            if (c == '{' && first == "extern" && !simplified.contains('('))
+            {
+                scopes.append(UnityScope_Namespace);
+                continue;
+            }
+
+            bool anonymous = scopes.contains(UnityScope_Anonymous);
+            if (first == "using" && simplified.startsWith("using namespace ") && (scopes.isEmpty() || anonymous))
+            {
+                QString name = simplified.mid(16).trimmed();
+                if (!symbols.UsingNamespaces.contains(name))
+                    symbols.UsingNamespaces.append(name);
+            } else if (anonymous || first == "static" || IsConstVariable(simplified))
+            {
+                QString name = DeclaredName(simplified);
+                if (!name.isEmpty())
+                    symbols.LocalSymbols.insert(name);
+            } else
+            {
+                QString name = DeclaredName(simplified);
+                if (!name.isEmpty())
+                    symbols.ExternalSymbols.insert(name);
+            }
+            if (c == '{')
+                skipped_depth = 1;
+        }
+    }
+    return symbols;
+}
+
+class UnitySourceScan
+{
+    public:
+        QString File;
+        QString Path;
+        bool Read;
+        UnitySymbols Symbols;
+};
+
+class UnityScanner : public SourceScanner
+{
+    public:
+        UnityScanner(QList<UnitySourceScan> *scans)
+        {
+            this->Scans = scans;
+        }
+
+        void ScanText(int index, const QString &text) override
+        {
+            UnitySourceScan &scan = (*this->Scans)[index];
+            scan.Read = true;
+            scan.Symbols = UnityPlanner::Scan(text);
+        }
+
+    private:
+        QList<UnitySourceScan> *Scans;
+};
+
+class UnityCandidate
+{
+    public:
+        UnityBatch Batch;
+        QString UsingKey;
+        QHash<QString, QString> SymbolOwners;
+        QHash<QString, QString> ExternalOwners;
+        QHash<QString, QString> MacroOwners;
+};
+
+UnityPlanner::UnityPlanner(const QString &directory, int batch_size)
+{
+    this->Directory = QDir::cleanPath(QDir(directory).absolutePath());
+    this->BatchSize = batch_size;
+}
+
+static QString FindClash(const QSet<QString> &names, const QHash<QString, QString> &owners, QString *owner)
+{
+    foreach (const QString &name, names)
+    {
+        if (owners.contains(name))
+        {
+            *owner = owners.value(name);
+            return name;
+        }
+    }
+    return "";
+}
+
+UnityPlan UnityPlanner::Plan(const BuildTarget &target) const
+{
+    UnityPlan plan;
+    plan.Target = target.Name;
+    plan.BatchSize = this->BatchSize;
+
+    QList<UnitySourceScan> scans;
+    foreach (const QString &source, target.Sources)
+    {
+        if (!CompileFlags::IsCompiledSource(source) || CompileFlags::IsCSource(source))
+            continue;
+        UnitySourceScan scan;
+        scan.File = source;
+        scan.Path = QDir::cleanPath(QDir(this->Directory).absoluteFilePath(source));
+        scan.Read = false;
+        scans.append(scan);
+    }
+
+    QStringList paths;
+    foreach (const UnitySourceScan &scan, scans)
+        paths << scan.Path;
+    UnityScanner(&scans).ReadFiles(paths);
+
+    // Sources go into the first batch they do not clash with, in the order of the project
+    QList<UnityCandidate> candidates;
+    foreach (const UnitySourceScan &scan, scans)
+    {
+        if (!scan.Read)
+        {
+            plan.Excluded.append(scan.File);
+            plan.Notes.append(scan.File + " cannot be read, it is compiled on its own");
+            continue;
+        }
+        QStringList namespaces = scan.Symbols.UsingNamespaces;
+        std::sort(namespaces.begin(), namespaces.end());
+        QString using_key = namespaces.join(",");
+        if (!using_key.isEmpty())
+            plan.Notes.append(scan.File + " has using namespace " + namespaces.join(", ") + " at file scope, it is only batched with sources that have the same");
+
+        int chosen = -1;
+        for (int i = 0; i < candidates.size() && chosen < 0; i++)
+        {
+            UnityCandidate &candidate = candidates[i];
+            if (candidate.UsingKey != using_key || candidate.Batch.Sources.size() >= this->BatchSize)
+                continue;
+            QString owner;
+            QString name = FindClash(scan.Symbols.LocalSymbols, candidate.SymbolOwners, &owner);
+            QString kind = "file local name";
+            QString external_owner;
+            if (name.isEmpty())
+            {
+                // A file local name hides the external one of the other source, or fails to compile next to it
+                name = FindClash(scan.Symbols.LocalSymbols, candidate.ExternalOwners, &owner);
+                if (!name.isEmpty())
+                    external_owner = owner;
+            }
+            if (name.isEmpty())
+            {
+                name = FindClash(scan.Symbols.ExternalSymbols, candidate.SymbolOwners, &owner);
+                if (!name.isEmpty())
+                    external_owner = scan.File;
+            }
+            if (!external_owner.isEmpty())
+                kind = "name";
+            if (name.isEmpty())
+            {
+                name = FindClash(scan.Symbols.Macros, candidate.MacroOwners, &owner);
+                kind = "macro";
+            }
+            if (name.isEmpty())
+            {
+                chosen = i;
+                continue;
+            }
+            QString note = scan.File + " and " + owner + " both define the " + kind + " " + name;
+            if (!external_owner.isEmpty())
+                note += ", it has external linkage in " + external_owner;
+            plan.Notes.append(note + ", they are kept apart");
+        }
+        if (chosen < 0)
+        {
+            candidates.append(UnityCandidate());
+            chosen = candidates.size() - 1;
+            candidates[chosen].UsingKey = using_key;
+        }
+        UnityCandidate &candidate = candidates[chosen];
+        candidate.Batch.Sources.append(scan.File);
+        foreach (const QString &name, scan.Symbols.LocalSymbols)
+            candidate.SymbolOwners.insert(name, scan.File);
+        foreach (const QString &name, scan.Symbols.ExternalSymbols)
+            candidate.ExternalOwners.insert(name, scan.File);
+        foreach (const QString &name, scan.Symbols.Macros)
+            candidate.MacroOwners.insert(name, scan.File);
+    }
+
+    // A batch of one source gains nothing, such sources keep their own object file
+    foreach (const UnityCandidate &candidate, candidates)
+    {
+        if (candidate.Batch.Sources.size() < 2)
+        {
+            plan.Excluded.append(candidate.Batch.Sources);
+            continue;
+        }
+        UnityBatch batch = candidate.Batch;
+        batch.Name = QString("%1_unity_%2").arg(target.Name).arg(plan.Batches.size() + 1);
+        plan.Batches.append(batch);
+    }
+    return plan;
+}
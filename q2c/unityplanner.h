@@ -0,0 +1,69 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef UNITYPLANNER_H
+#define UNITYPLANNER_H
+
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include "buildmodel.h"
+
+//! Names a source file leaves behind for the files that follow it in a unity batch
+class UnitySymbols
+{
+    public:
+        QSet<QString> LocalSymbols;     // static and anonymous namespace names at file scope
+        QSet<QString> ExternalSymbols;  // Other names declared at namespace scope, those have external linkage
+        QSet<QString> Macros;           // Macros that are still defined at the end of the file
+        QStringList UsingNamespaces;    // using namespace directives at file scope
+};
+
+class UnityBatch
+{
+    public:
+        QString Name;       // UNITY_GROUP of the sources
+        QStringList Sources;
+};
+
+//! Unity batches of one target and why sources ended up where they are
+class UnityPlan
+{
+    public:
+        UnityPlan();
+        bool IsEmpty() const;
+        //! Human readable summary of the batches and of every grouping decision
+        QString Report() const;
+
+        QString Target;
+        int BatchSize;
+        QList<UnityBatch> Batches;
+        QStringList Excluded;   // Compiled on their own with SKIP_UNITY_BUILD_INCLUSION
+        QStringList Notes;
+};
+
+//! Groups the C++ sources of a target into unity batches that do not share file local names
+class UnityPlanner
+{
+    public:
+        //! directory is where the project file is, sources are relative to it
+        UnityPlanner(const QString &directory, int batch_size);
+        //! Reads the sources in parallel, sources that cannot be read are not batched
+        UnityPlan Plan(const BuildTarget &target) const;
+        //! Collects the names of a source that clash when another source is appended to it
+        static UnitySymbols Scan(const QString &text);
+
+    private:
+        QString Directory;
+        int BatchSize;
+};
+
+#endif // UNITYPLANNER_H
@@ -0,0 +1,141 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#include "warningreport.h"
+#include <QSet>
+
+#ifndef Q2C_VERSION
+#define Q2C_VERSION "0.1.0"
+#endif
+
+bool WarningReport::IsSupportedFormat(QString format)
+{
+    return format == "text" || format == "json" || format == "sarif";
+}
+
+QString WarningReport::Format(const QList<BuildWarning> &warnings, QString format)
+{
+    if (format == "json")
+        return WarningReport::FormatJson(warnings);
+    if (format == "sarif")
+        return WarningReport::FormatSarif(warnings);
+    return WarningReport::FormatText(warnings);
+}
+
+QString WarningReport::FormatText(const QList<BuildWarning> &warnings)
+{
+    QString text;
+    foreach (const BuildWarning &warning, warnings)
+    {
+        text += warning.Location.FileName;
+        if (warning.Location.LineNumber > 0)
+        {
+            text += ":" + QString::number(warning.Location.LineNumber);
+            if (warning.Column > 0)
+                text += ":" + QString::number(warning.Column);
+        }
+        text += ": " + warning.SeverityName() + ": " + warning.Message + " [" + warning.CodeName() + "]\n";
+        if (!warning.Suggestion.isEmpty())
+            text += "    suggestion: " + warning.Suggestion + "\n";
+    }
+    return text;
+}
+
+QString WarningReport::FormatJson(const QList<BuildWarning> &warnings)
+{
+    QString text;
+    foreach (const BuildWarning &warning, warnings)
+    {
+        text += "{\"type\":\"warning\",\"code\":" + WarningReport::JsonString(warning.CodeName())
+                + ",\"severity\":" + WarningReport::JsonString(warning.SeverityName())
+                + ",\"file\":" + WarningReport::JsonString(warning.Location.FileName)
+                + ",\"line\":" + QString::number(warning.Location.LineNumber > 0 ? warning.Location.LineNumber : -1)
+                + ",\"column\":" + QString::number(warning.Column > 0 ? warning.Column : -1)
+                + ",\"message\":" + WarningReport::JsonString(warning.Message);
+        if (!warning.Suggestion.isEmpty())
+            text += ",\"suggestion\":" + WarningReport::JsonString(warning.Suggestion);
+        text += "}\n";
+    }
+    return text;
+}
+
+QString WarningReport::FormatSarif(const QList<BuildWarning> &warnings)
+{
+    QString rules;
+    QString results;
+    QSet<QString> seen_rules;
+    foreach (const BuildWarning &warning, warnings)
+    {
+        QString code = warning.CodeName();
+        if (!seen_rules.contains(code))
+        {
+            seen_rules.insert(code);
+            if (!rules.isEmpty())
+                rules += ",";
+            rules += "{\"id\":" + WarningReport::JsonString(code) + "}";
+        }
+
+        if (!results.isEmpty())
+            results += ",";
+        results += "{\"ruleId\":" + WarningReport::JsonString(code)
+                   + ",\"level\":" + WarningReport::JsonString(warning.SeverityName())
+                   + ",\"message\":{\"text\":" + WarningReport::JsonString(warning.Message) + "}"
+                   + ",\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":"
+                   + WarningReport::JsonString(warning.Location.FileName) + "}";
+        if (warning.Location.LineNumber > 0)
+        {
+            results += ",\"region\":{\"startLine\":" + QString::number(warning.Location.LineNumber);
+            if (warning.Column > 0)
+                results += ",\"startColumn\":" + QString::number(warning.Column);
+            results += "}";
+        }
+        results += "}}]";
+        if (!warning.Suggestion.isEmpty())
+            results += ",\"properties\":{\"suggestion\":" + WarningReport::JsonString(warning.Suggestion) + "}";
+        results += "}";
+    }
+
+    return "{\"version\":\"2.1.0\",\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\",\"runs\":[{\"tool\":{\"driver\":{"
+           "\"name\":\"q2c\",\"version\":\"" Q2C_VERSION "\",\"informationUri\":\"https://github.com/benapetr/q2c\",\"rules\":["
+           + rules + "]}},\"results\":[" + results + "]}]}\n";
+}
+
+QString WarningReport::JsonString(const QString &value)
+{
+    QString escaped = "\"";
+    escaped.reserve(value.size() + 2);
+    for (QChar c : value)
+    {
+        switch (c.unicode())
+        {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\r':
+                escaped += "\\r";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+                if (c.unicode() < 0x20)
+                    escaped += "\\u" + QString::number(c.unicode(), 16).rightJustified(4, '0');
+                else
+                    escaped += c;
+        }
+    }
+    return escaped + "\"";
+}
@@ -0,0 +1,33 @@
+//This program is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//This program is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+#ifndef WARNINGREPORT_H
+#define WARNINGREPORT_H
+
+#include <QList>
+#include <QString>
+#include "buildmodel.h"
+
+class WarningReport
+{
+    public:
+        static bool IsSupportedFormat(QString format);
+        //! Formats every warning as text (one per line), json (one object per line) or a single SARIF 2.1.0 log
+        static QString Format(const QList<BuildWarning> &warnings, QString format);
+        //! Quotes and escapes a value for use in JSON output
+        static QString JsonString(const QString &value);
+
+    private:
+        static QString FormatText(const QList<BuildWarning> &warnings);
+        static QString FormatJson(const QList<BuildWarning> &warnings);
+        static QString FormatSarif(const QList<BuildWarning> &warnings);
+};
+
+#endif // WARNINGREPORT_H
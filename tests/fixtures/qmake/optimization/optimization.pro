@@ -0,0 +1,17 @@
+TARGET = optimized_app
+TEMPLATE = app
+QT += core
+CONFIG += c++17 ltcg optimize_full
+
+SOURCES += main.cpp
+
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
+QMAKE_LFLAGS_RELEASE += -Wl,-O1
+QMAKE_CXXFLAGS_DEBUG += -fno-omit-frame-pointer
+
+CONFIG(debug, debug|release) {
+    DEFINES += APP_TRACE
+} else {
+    DEFINES += QT_NO_DEBUG_OUTPUT
+}
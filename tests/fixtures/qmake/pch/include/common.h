@@ -0,0 +1,6 @@
+#ifndef COMMON_H
+#define COMMON_H
+
+#include <QString>
+
+#endif // COMMON_H
@@ -0,0 +1,11 @@
+#include <QApplication>
+#include <QString>
+#include "view.h"
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    View view;
+    view.show();
+    return app.exec();
+}
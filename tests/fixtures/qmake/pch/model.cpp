@@ -0,0 +1,8 @@
+#include "model.h"
+#include <QString>
+#include <vector>
+#include <common.h>
+
+Model::Model()
+{
+}
@@ -0,0 +1,7 @@
+TARGET = pch_app
+TEMPLATE = app
+QT += widgets
+INCLUDEPATH += include
+SOURCES += main.cpp model.cpp view.cpp missing.cpp
+HEADERS += model.h view.h
+FORMS += view.ui
@@ -0,0 +1,11 @@
+#include "view.h"
+#include "model.h"
+#include "ui_view.h"
+#   include <QString>
+#include <vector>
+#include <common.h>
+
+View::View(QWidget *parent) : QWidget(parent)
+{
+}
+#include "view.moc"
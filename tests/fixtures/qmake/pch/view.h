@@ -0,0 +1,13 @@
+#ifndef VIEW_H
+#define VIEW_H
+
+#include <QWidget>
+
+class View : public QWidget
+{
+        Q_OBJECT
+    public:
+        View(QWidget *parent = nullptr);
+};
+
+#endif // VIEW_H
@@ -0,0 +1,19 @@
+// static int ignored() in a comment does not count
+static int helper()
+{
+    return 1;
+}
+
+namespace
+{
+    struct Cache
+    {
+        static int size;
+    };
+    int counter = 0;
+}
+
+int Alpha()
+{
+    return helper() + counter;
+}
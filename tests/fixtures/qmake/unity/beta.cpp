@@ -0,0 +1,9 @@
+static int helper()
+{
+    return 2;
+}
+
+int Beta()
+{
+    return helper();
+}
@@ -0,0 +1,9 @@
+#define LOG_TAG "delta"
+#define SCRATCH(x) \
+    (x + 1)
+
+int Delta()
+{
+    return SCRATCH(4);
+}
+#undef SCRATCH
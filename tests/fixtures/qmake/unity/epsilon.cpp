@@ -0,0 +1,8 @@
+#include <string>
+
+using namespace std;
+
+string Epsilon()
+{
+    return "epsilon";
+}
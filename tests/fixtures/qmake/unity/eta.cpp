@@ -0,0 +1,9 @@
+int helper()
+{
+    return 5;
+}
+
+int Eta()
+{
+    return helper();
+}
@@ -0,0 +1,12 @@
+#define LOG_TAG "gamma"
+
+class Widget
+{
+    public:
+        static int helper();
+};
+
+int Widget::helper()
+{
+    return 3;
+}
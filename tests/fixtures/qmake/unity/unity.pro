@@ -0,0 +1,3 @@
+TARGET = unity_app
+TEMPLATE = app
+SOURCES += alpha.cpp beta.cpp gamma.cpp delta.cpp epsilon.cpp zeta.cpp missing.cpp eta.cpp
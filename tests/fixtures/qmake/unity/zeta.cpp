@@ -0,0 +1,12 @@
+#define SCRATCH 6
+
+namespace
+{
+    const char *Name = "zeta; static int helper()";
+}
+
+int Zeta()
+{
+    return SCRATCH;
+}
+#undef SCRATCH
@@ -11,13 +11,30 @@
 #include <QCoreApplication>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QRegularExpression>
 #include <QTextStream>
+#include <algorithm>
 #include "buildmodel.h"
+#include "charscanner.h"
 #include "cmakeparser.h"
 #include "cmakegenerator.h"
+#include "cmakepresetsgenerator.h"
+#include "compilecommandsgenerator.h"
+#include "configuration.h"
+#include "logs.h"
+#include "memoryreport.h"
+#include "modelcache.h"
+#include "modeljson.h"
+#include "pchanalyzer.h"
+#include "ninjagenerator.h"
+#include "project.h"
 #include "qmakegenerator.h"
 #include "qmakeparser.h"
+#include "roundtrip.h"
+#include "tokenview.h"
+#include "unityplanner.h"
+#include "warningreport.h"
 
 class TestRunner
 {
@@ -84,9 +101,9 @@ static bool Contains(const QList<QString> &list, QString value)
 
 static bool ContainsWarning(const BuildProject &project, QString needle)
 {
-    foreach (QString warning, project.Warnings)
+    foreach (const BuildWarning &warning, project.Warnings)
     {
-        if (warning.contains(needle))
+        if (warning.Message.contains(needle))
             return true;
     }
     return false;
@@ -388,7 +405,7 @@ static void TestCMakeFixtureParses(TestRunner *runner)
     runner->Expect(Contains(target->Defines, "HAS_CMAKE_FIXTURE"), "target_compile_definitions parses");
     runner->Expect(Contains(target->IncludePaths, "include"), "target_include_directories parses");
     runner->Expect(Contains(target->CompileOptions, "-Wall"), "target_compile_options parses");
-    runner->Expect(Contains(target->CompileOptions, "$<$<CONFIG:Debug>:-DDEBUG_BUILD>"), "target_compile_options keeps generator expression for warning");
+    runner->Expect(Contains(target->CompileOptions, "$<$<CONFIG:Debug>:-DDEBUG_BUILD>"), "target_compile_options keeps generator expression");
     runner->Expect(Contains(target->Libraries, "-Llib dir"), "target_link_directories parses");
     runner->Expect(Contains(target->Libraries, "customlib"), "target_link_libraries parses non-Qt library");
     runner->Expect(Contains(target->LinkOptions, "-pthread"), "target_link_options parses");
@@ -398,7 +415,7 @@ static void TestCMakeFixtureParses(TestRunner *runner)
     runner->Expect(HasScopeWithDefine(target, "WIN32", "WIN_ONLY"), "if target_compile_definitions parses scoped define");
     runner->Expect(Contains(target->QtModules, "core"), "Qt imported Core target maps to qt module");
     runner->Expect(Contains(target->QtModules, "widgets"), "Qt imported Widgets target maps to qt module");
-    runner->Expect(ContainsWarning(project, "set_target_properties"), "set_target_properties emits warning");
+    runner->Expect(!ContainsWarning(project, "set_target_properties"), "AUTOMOC needs no warning because qmake runs moc itself");
 
     QMakeGenerator generator;
     QString qmake = generator.Generate(project);
@@ -414,7 +431,8 @@ static void TestCMakeFixtureParses(TestRunner *runner)
     runner->Expect(qmake.contains("QMAKE_LFLAGS += -pthread"), "generated qmake contains link options");
     runner->Expect(qmake.contains("win32 {\n    SOURCES += win.cpp\n}"), "generated qmake maps WIN32 source scope");
     runner->Expect(qmake.contains("win32 {\n    DEFINES += WIN_ONLY\n}"), "generated qmake maps WIN32 define scope");
-    runner->Expect(qmake.contains("CMake generator expressions require manual qmake review"), "generated qmake warns on generator expressions");
+    runner->Expect(qmake.contains("QMAKE_CXXFLAGS_DEBUG += -DDEBUG_BUILD"), "generated qmake maps Debug generator expression");
+    runner->Expect(!qmake.contains("CMake generator expressions require manual qmake review"), "generated qmake does not warn on build configuration expressions");
     runner->Expect(qmake.contains("Additional CMake target 'plugin_module'"), "generated qmake warns on additional target");
 }
 
@@ -458,11 +476,58 @@ static void TestComplexCMakeFixture(TestRunner *runner)
     runner->Expect(qmake.contains("LIBS += \\\n    \"-Lthird party/lib\" \\\n    ssl \\\n    crypto"), "complex CMake generated qmake maps libraries");
     runner->Expect(qmake.contains("macx {\n    SOURCES += platform/mac.mm"), "complex CMake generated qmake maps APPLE scope");
     runner->Expect(qmake.contains("unix {\n    SOURCES += platform/unix.cpp"), "complex CMake generated qmake maps UNIX scope");
-    runner->Expect(qmake.contains("CMake generator expressions require manual qmake review"), "complex CMake generated qmake warns about generator expression");
+    runner->Expect(qmake.contains("QMAKE_CXXFLAGS_DEBUG += -DDEBUG_ONLY"), "complex CMake generated qmake maps Debug generator expression");
     runner->Expect(qmake.contains("Additional CMake target 'extra_plugin'"), "complex CMake generated qmake warns about module target");
     ExpectSnapshot(runner, qmake, "snapshots/complex_cmake.pro.expected", "complex CMake generated qmake snapshot matches");
 }
 
+static void TestNestedCMakeScopes(TestRunner *runner)
+{
+    QString text = "project(nested)\nadd_executable(nested main.cpp)\n"
+                   "if(UNIX)\n    target_compile_definitions(nested PRIVATE ON_UNIX)\n"
+                   "    if(APPLE)\n        target_sources(nested PRIVATE mac.mm)\n"
+                   "        if(UNIX)\n            target_compile_definitions(nested PRIVATE APPLE_UNIX)\n        endif()\n    endif()\n"
+                   "    if(CUSTOM)\n        if(NOT APPLE)\n            target_compile_definitions(nested PRIVATE CUSTOM_UNIX)\n        endif()\n    endif()\n"
+                   "else()\n    if(WIN32)\n        target_compile_definitions(nested PRIVATE ON_WINDOWS)\n    endif()\nendif()\n";
+    BuildProject project;
+    CMakeParser parser;
+    runner->Expect(parser.Parse(text, &project, "CMakeLists.txt"), "nested CMake scopes parse");
+    const BuildTarget *target = project.PrimaryTarget();
+    if (target == nullptr || target->ConditionalScopes.size() != 5)
+    {
+        runner->Expect(false, "every nested CMake block with target commands has a scope");
+        return;
+    }
+    const QList<BuildConditionalScope> &scopes = target->ConditionalScopes;
+    runner->Expect(scopes.at(0).Condition == "UNIX" && scopes.at(0).Parent == -1 && scopes.at(1).Condition == "APPLE" && scopes.at(1).Parent == 0
+                   && scopes.at(2).Condition == "UNIX" && scopes.at(2).Parent == 1, "nested scopes keep their own condition and link to their parent");
+    runner->Expect(scopes.at(3).Condition == "CUSTOM AND NOT APPLE" && scopes.at(3).Parent == 0 && target->ScopeCondition(3) == "UNIX AND CUSTOM AND NOT APPLE",
+                   "levels without a scope of the target are joined into the nested scope");
+    runner->Expect(scopes.at(4).Condition == "NOT UNIX AND WIN32" && scopes.at(4).Parent == -1, "scopes of an else() branch do not link to the if() branch");
+
+    QString qmake = QMakeGenerator().Generate(project);
+    runner->Expect(qmake.contains("unix {\n    DEFINES += ON_UNIX\n    macx {\n        SOURCES += mac.mm\n        unix {\n            DEFINES += APPLE_UNIX\n        }\n    }\n"
+                                  "    # q2c warning: Unsupported CMake condition for qmake scope: CUSTOM AND NOT APPLE\n"
+                                  "#     CUSTOM:!macx {\n#         DEFINES += CUSTOM_UNIX\n#     }\n}\n"),
+                   "qmake output writes nested scopes inside their parent");
+    runner->Expect(CMakeGenerator(CMakeQtVersion_Qt6).Generate(project, QList<CMakeOption>()).contains("\nif(UNIX AND APPLE AND UNIX)\n"),
+                   "CMake output joins the conditions of nested scopes");
+#if defined(Q_OS_LINUX)
+    QList<const BuildConditionalScope*> host_scopes = CompileFlags::HostScopes(*target);
+    runner->Expect(host_scopes.size() == 1 && host_scopes.first() == &scopes.at(0), "a nested scope only holds on the host when its parent does");
+#endif
+
+    ModelCacheInfo info;
+    info.QMakeInput = false;
+    QByteArray data = ModelCache::Serialize(project, info);
+    BuildProject loaded;
+    ModelCacheInfo loaded_info;
+    QString error;
+    runner->Expect(ModelCache::Deserialize(reinterpret_cast<const uchar *>(data.constData()), data.size(), &loaded, &loaded_info, &error)
+                   && loaded.PrimaryTarget() != nullptr && loaded.PrimaryTarget()->ConditionalScopes.size() == 5
+                   && loaded.PrimaryTarget()->ConditionalScopes.at(2).Parent == 1, "model cache keeps the parents of nested scopes");
+}
+
 static void TestRoundTrips(TestRunner *runner)
 {
     QString qmake_fixture = Fixture("qmake/complex/complex.pro");
@@ -498,6 +563,58 @@ static void TestRoundTrips(TestRunner *runner)
     runner->Expect(qmake_target != nullptr && Contains(qmake_target->Libraries, "-Lthird party/lib"), "round-trip qmake keeps link directory");
 }
 
+static void TestRoundTripVerification(TestRunner *runner)
+{
+    BuildProject original;
+    original.Name = "app";
+    BuildTarget *target = original.EnsurePrimaryTarget();
+    target->Name = "app";
+    target->Type = BuildTarget_Application;
+    target->Sources << "main.cpp" << "window.cpp";
+    target->Libraries << "-lssl" << "-framework" << "Cocoa";
+    target->Config << "c++17";
+    BuildConditionalScope scope;
+    scope.Condition = "UNIX";
+    scope.Sources << "unix.cpp";
+    target->ConditionalScopes.append(scope);
+    scope.Sources.clear();
+    scope.Defines << "PLATFORM_UNIX";
+    target->ConditionalScopes.append(scope);
+
+    BuildProject reparsed = original;
+    BuildTarget *reparsed_target = reparsed.PrimaryTarget();
+    reparsed_target->Sources = QList<QString>() << "window.cpp" << "main.cpp";
+    reparsed_target->Libraries = QList<QString>() << "ssl" << "-framework Cocoa";
+    reparsed_target->Config.clear();
+    reparsed_target->ConditionalScopes.clear();
+    scope.Sources << "unix.cpp";
+    reparsed_target->ConditionalScopes.append(scope);
+
+    QList<RoundTripDifference> differences = RoundTrip::Compare(original, reparsed);
+    runner->Expect(differences.size() == 1 && differences.at(0).Field == "Config" && differences.at(0).Lost == QStringList() << "c++17",
+                   "round-trip comparison ignores order, merged scopes and library spelling");
+    runner->Expect(RoundTrip::HasLostValues(differences) && RoundTrip::Format(differences) == "app Config lost: c++17\n",
+                   "round-trip comparison reports lost values per target and field");
+
+    reparsed_target->Config = target->Config;
+    reparsed_target->ConditionalScopes[0].Defines << "EXTRA";
+    reparsed_target->Sources << "src/main file.cpp";
+    differences = RoundTrip::Compare(original, reparsed);
+    runner->Expect(!RoundTrip::HasLostValues(differences) && differences.size() == 2
+                   && RoundTrip::Format(differences).contains("app [UNIX] Defines added: EXTRA\n")
+                   && RoundTrip::Format(differences).contains("app Sources added: \"src/main file.cpp\"\n"),
+                   "values only the reparsed model has are reported without failing");
+
+    QList<RoundTripDifference> verified;
+    QString fixture = Fixture("qmake/library/library.pro");
+    BuildProject library;
+    QMakeParser parser;
+    parser.Parse(ReadFile(fixture), &library, fixture, "VERSION 3.16");
+    runner->Expect(RoundTrip::Verify(library, true, CMakeQtVersion_Qt6, QList<CMakeOption>(), &verified) && !RoundTrip::HasLostValues(verified),
+                   "library fixture survives the round trip through CMake");
+    runner->Expect(RoundTrip::Format(verified) == "libdemo Config added: c++17\n", "the default C++ standard of the CMake output comes back as CONFIG");
+}
+
 static void TestNegativeAndUnsupportedInputs(TestRunner *runner)
 {
     BuildProject missing_target;
@@ -510,13 +627,965 @@ static void TestNegativeAndUnsupportedInputs(TestRunner *runner)
     QString unsupported_fixture = Fixture("cmake/negative/unsupported.cmake");
     runner->Expect(cmake_parser.Parse(ReadFile(unsupported_fixture), &unsupported_cmake, unsupported_fixture), "unsupported CMake fixture still parses");
     runner->Expect(ContainsWarning(unsupported_cmake, "Unsupported CMake command"), "unsupported CMake command emits warning");
-    runner->Expect(ContainsWarning(unsupported_cmake, "set_target_properties"), "unsupported CMake property emits warning");
+    runner->Expect(!ContainsWarning(unsupported_cmake, "set_target_properties"), "AUTOMOC of the unsupported CMake fixture needs no warning");
 
     QMakeGenerator qmake_generator;
     QString qmake = qmake_generator.Generate(unsupported_cmake);
     runner->Expect(qmake.contains("CMake generator expressions require manual qmake review"), "unsupported generator expression emits qmake warning");
 }
 
+static void TestQMakeVariableTable(TestRunner *runner)
+{
+    QString text = "TARGET = table\n"
+                   "sources += main.cpp\n"
+                   "FORMS += main.ui\n"
+                   "win32: RESOURCES += win.qrc\n"
+                   "unix {\n"
+                   "    FORMS += unix.ui\n"
+                   "    SUBDIRS += nested\n"
+                   "}\n";
+    BuildProject project;
+    QMakeParser parser;
+    runner->Expect(parser.Parse(text, &project, "table.pro", "VERSION 3.16"), "variable table project parses");
+    const BuildTarget *target = project.PrimaryTarget();
+    runner->Expect(target != nullptr && Contains(target->Sources, "main.cpp"), "variable names match regardless of case");
+    runner->Expect(target != nullptr && Contains(target->UiFiles, "main.ui"), "top-level FORMS maps to target UI files");
+    bool inline_resources = false;
+    bool block_forms = false;
+    if (target != nullptr)
+    {
+        foreach (const BuildConditionalScope &scope, target->ConditionalScopes)
+        {
+            inline_resources = inline_resources || (scope.Condition == "WIN32" && scope.ResourceFiles.contains("win.qrc"));
+            block_forms = block_forms || (scope.Condition == "UNIX" && scope.UiFiles.contains("unix.ui"));
+        }
+    }
+    runner->Expect(inline_resources, "inline scope uses the shared variable table");
+    runner->Expect(block_forms, "scope block uses the shared variable table");
+    runner->Expect(ContainsWarning(project, "Unsupported scoped qmake variable at line 7: SUBDIRS"), "scope block warns about variables scopes cannot hold");
+}
+
+static void TestQMakeVariableStore(TestRunner *runner)
+{
+    QString text = "TARGET = store\n"
+                   "SOURCES += a.cpp\n"
+                   "SOURCES += b.cpp\n"
+                   "SOURCES += a.cpp\n"
+                   "SOURCES -= b.cpp\n"
+                   "SOURCES += b.cpp\n"
+                   "EXTRA = one\n"
+                   "EXTRA += two\n"
+                   "INCLUDEPATH += inc\n"
+                   "DEPENDPATH += inc\n"
+                   "HEADERS += $$EXTRA\n"
+                   "LIBS += $$SOURCES\n";
+    BuildProject project;
+    QMakeParser parser;
+    runner->Expect(parser.Parse(text, &project, "store.pro", "VERSION 3.16"), "variable store project parses");
+    const BuildTarget *target = project.PrimaryTarget();
+    runner->Expect(target != nullptr && target->Sources == QList<QString>() << "a.cpp" << "b.cpp", "appends skip duplicates and -= removes the entry");
+    runner->Expect(target != nullptr && target->Headers == QList<QString>() << "one" << "two", "user variables expand after appends");
+    runner->Expect(target != nullptr && target->IncludePaths == QList<QString>() << "inc", "variables sharing a target list share their entries");
+    runner->Expect(target != nullptr && target->Libraries == QList<QString>() << "a.cpp" << "b.cpp", "known variables expand from the target list");
+}
+
+static void TestStructuredWarnings(TestRunner *runner)
+{
+    BuildProject cmake_project;
+    CMakeParser cmake_parser;
+    QString cmake_fixture = Fixture("cmake/properties/CMakeLists.txt");
+    cmake_parser.Parse(ReadFile(cmake_fixture), &cmake_project, cmake_fixture);
+    const BuildWarning *properties = nullptr;
+    for (int i = 0; i < cmake_project.Warnings.size(); i++)
+    {
+        if (cmake_project.Warnings.at(i).Code == BuildWarning_PartialTargetProperties)
+            properties = &cmake_project.Warnings.at(i);
+    }
+    runner->Expect(properties != nullptr && properties->Location.FileName == cmake_fixture && properties->Location.LineNumber == 18,
+                   "CMake warning carries its source location");
+    runner->Expect(properties != nullptr && properties->CodeName() == "Q2C2003" && !properties->Suggestion.isEmpty(),
+                   "CMake warning carries a code and a suggestion");
+
+    BuildProject project;
+    BuildWarning warning(BuildWarning_UnsupportedCMakeCommand, BuildSourceLocation("CMakeLists.txt", 4), "Unsupported \"command\"");
+    project.AddWarning(warning);
+    project.AddWarning(warning);
+    project.AddWarning(BuildWarning(BuildWarning_UnsupportedCMakeCommand, BuildSourceLocation("CMakeLists.txt", 5), "Unsupported \"command\""));
+    runner->Expect(project.Warnings.size() == 2, "identical warnings are stored once");
+
+    QString text = WarningReport::Format(project.Warnings, "text");
+    runner->Expect(text.startsWith("CMakeLists.txt:4: warning: Unsupported \"command\" [Q2C2004]\n"), "text warnings use file, line and code");
+    QString json = WarningReport::Format(project.Warnings, "json");
+    runner->Expect(json.count('\n') == 2 && json.contains("\"line\":5") && json.contains("Unsupported \\\"command\\\""),
+                   "json warnings are escaped, one per line");
+    QString sarif = WarningReport::Format(project.Warnings, "sarif");
+    runner->Expect(sarif.contains("\"ruleId\":\"Q2C2004\"") && sarif.count("\"id\":\"Q2C2004\"") == 1,
+                   "sarif log lists each rule once");
+}
+
+static void AddPluginDefine(const CMakeCommand &command, BuildProject *model)
+{
+    BuildTarget *target = model->EnsurePrimaryTarget();
+    target->Defines.append("PLUGIN_" + command.Arguments.value(0));
+}
+
+static void TestCMakeCommandRegistry(TestRunner *runner)
+{
+    QString text = "project(registry)\n"
+                   "qt_add_executable(app main.cpp)\n"
+                   "target_sources(app PRIVATE extra.cpp)\n"
+                   "TARGET_SOURCES(app PRIVATE upper.cpp)\n"
+                   "target_precompile_headers(app PRIVATE pch.h)\n"
+                   "qt_add_qml_module(app URI Registry VERSION 1.0 QML_FILES Main.qml SOURCES model.cpp model.h)\n"
+                   "set_source_files_properties(main.cpp PROPERTIES SKIP_AUTOMOC ON)\n"
+                   "add_custom_command(OUTPUT a.h COMMAND gen)\n"
+                   "my_macro(one)\n"
+                   "add_custom_command(OUTPUT b.h COMMAND gen)\n";
+    BuildProject project;
+    CMakeParser parser;
+    parser.RegisterCommand("My_Macro", AddPluginDefine);
+    runner->Expect(parser.Parse(text, &project, "CMakeLists.txt"), "registry project parses");
+    const BuildTarget *target = project.PrimaryTarget();
+    runner->Expect(target != nullptr && Contains(target->Sources, "upper.cpp"), "command names are matched regardless of case");
+    runner->Expect(target != nullptr && Contains(target->Defines, "PLUGIN_one"), "registered command handler is called");
+    runner->Expect(target != nullptr && target->PrecompiledHeaders == QList<QString>() << "pch.h", "target_precompile_headers fills the precompiled headers");
+    runner->Expect(target != nullptr && Contains(target->Sources, "model.cpp") && Contains(target->Headers, "model.h")
+                   && Contains(target->ResourceFiles, "Main.qml") && Contains(target->QtModules, "qml"),
+                   "qt_add_qml_module maps sources, QML files and the qml module");
+    runner->Expect(ContainsWarning(project, "set_source_files_properties is not represented at line 7: SKIP_AUTOMOC"),
+                   "set_source_files_properties names the dropped properties");
+
+    int unsupported = 0;
+    foreach (const BuildWarning &warning, project.Warnings)
+    {
+        if (warning.Code == BuildWarning_UnsupportedCMakeCommand)
+            unsupported++;
+    }
+    runner->Expect(unsupported == 1 && ContainsWarning(project, "Unsupported CMake command at line 8: add_custom_command (2 uses, also at lines 10)"),
+                   "unsupported commands are reported once per name");
+
+    int target_sources = 0;
+    int custom_commands = -1;
+    foreach (const CMakeCommandStat &stat, parser.GetCommandStats())
+    {
+        if (stat.Name == "target_sources")
+            target_sources = stat.Hits;
+        if (stat.Name == "add_custom_command" && !stat.Supported)
+            custom_commands = stat.Hits;
+    }
+    runner->Expect(target_sources == 2 && custom_commands == 2, "command stats count supported and unsupported commands");
+
+    QString qmake = QMakeGenerator().Generate(project);
+    runner->Expect(qmake.contains("PRECOMPILED_HEADER = pch.h") && qmake.contains("precompile_header"), "qmake output uses the precompiled header");
+
+    BuildProject external;
+    CMakeParser external_parser;
+    runner->Expect(external_parser.Parse("project(external)\n"
+                                         "add_library(ext STATIC IMPORTED GLOBAL)\n"
+                                         "set_target_properties(ext PROPERTIES IMPORTED_LOCATION /opt/ext/libext.a)\n"
+                                         "target_include_directories(ext INTERFACE /opt/ext/include)\n"
+                                         "add_library(core STATIC core.cpp)\n"
+                                         "add_library(Demo::core ALIAS core)\n"
+                                         "add_executable(tool IMPORTED)\n"
+                                         "add_executable(app main.cpp)\n"
+                                         "target_link_libraries(app PRIVATE Demo::core ext)\n", &external, "CMakeLists.txt"),
+                   "imported and alias targets parse");
+    QStringList names;
+    foreach (const BuildTarget &external_target, external.Targets)
+        names << external_target.Name;
+    runner->Expect(names == QStringList() << "core" << "app", "imported and alias targets are not converted");
+    runner->Expect(external.Targets.first().Sources == QList<QString>() << "core.cpp", "alias keywords do not become sources");
+    runner->Expect(!ContainsWarning(external, "IMPORTED_LOCATION"), "properties of imported targets are skipped");
+}
+
+static void TestPrecompiledHeaders(TestRunner *runner)
+{
+    QString text = "TARGET = pch\n"
+                   "CONFIG += precompile_header\n"
+                   "PRECOMPILED_HEADER = stable.h\n"
+                   "SOURCES += main.cpp\n"
+                   "win32: PRECOMPILED_HEADER = win.h\n";
+    BuildProject project;
+    QMakeParser parser;
+    runner->Expect(parser.Parse(text, &project, "pch.pro", "VERSION 3.16"), "precompiled header project parses");
+    const BuildTarget *target = project.PrimaryTarget();
+    runner->Expect(target != nullptr && target->PrecompiledHeaders == QList<QString>() << "stable.h", "PRECOMPILED_HEADER fills the precompiled headers");
+    runner->Expect(ContainsWarning(project, "Unsupported scoped qmake variable at line 5: PRECOMPILED_HEADER"), "scoped PRECOMPILED_HEADER is reported");
+
+    QString cmake = CMakeGenerator(CMakeQtVersion_Qt6).Generate(project, QList<CMakeOption>());
+    runner->Expect(cmake.contains("\ntarget_precompile_headers(pch PRIVATE\n    stable.h\n)\n"), "CMake output uses target_precompile_headers");
+    CMakeGenerator old_cmake(CMakeQtVersion_Qt5);
+    old_cmake.SetMinimumVersion("VERSION 3.1.0");
+    cmake = old_cmake.Generate(project, QList<CMakeOption>());
+    runner->Expect(cmake.contains("if(NOT CMAKE_VERSION VERSION_LESS 3.16)\n    target_precompile_headers(pch PRIVATE\n"),
+                   "precompiled headers are skipped by CMake versions before 3.16");
+
+    BuildProject reused;
+    CMakeParser cmake_parser;
+    runner->Expect(cmake_parser.Parse("project(shared)\nadd_library(core core.cpp)\ntarget_precompile_headers(core PRIVATE pch.h)\n"
+                                      "add_executable(app main.cpp)\ntarget_precompile_headers(app REUSE_FROM core)\n"
+                                      "add_executable(tool tool.cpp)\ntarget_precompile_headers(tool REUSE_FROM missing)\n",
+                                      &reused, "CMakeLists.txt"), "REUSE_FROM project parses");
+    const BuildTarget *app = nullptr;
+    for (int i = 0; i < reused.Targets.size(); i++)
+    {
+        if (reused.Targets.at(i).Name == "app")
+            app = &reused.Targets.at(i);
+    }
+    runner->Expect(app != nullptr && app->PrecompiledHeaders == QList<QString>() << "pch.h", "REUSE_FROM copies the header of a known target");
+    runner->Expect(ContainsWarning(reused, "target_precompile_headers REUSE_FROM is not represented at line 7"), "REUSE_FROM of an unknown target is reported");
+}
+
+static void TestOptimizationSettings(TestRunner *runner)
+{
+    QString text = "TARGET = fast\n"
+                   "SOURCES += main.cpp\n"
+                   "CONFIG += ltcg optimize_full\n"
+                   "QMAKE_CXXFLAGS_RELEASE -= -O2\n"
+                   "QMAKE_CXXFLAGS_RELEASE += -O3\n"
+                   "QMAKE_LFLAGS_RELEASE += -Wl,-O1\n"
+                   "QMAKE_CXXFLAGS_DEBUG += -fsanitize=address\n"
+                   "CONFIG(debug, debug|release) {\n"
+                   "    DEFINES += FAST_DEBUG\n"
+                   "    SOURCES += debug.cpp\n"
+                   "} else {\n"
+                   "    LIBS += -lprofiler\n"
+                   "}\n"
+                   "!debug: DEFINES += FAST_RELEASE\n"
+                   "win32: QMAKE_LFLAGS_DEBUG += /DEBUG\n";
+    BuildProject project;
+    QMakeParser parser;
+    runner->Expect(parser.Parse(text, &project, "fast.pro", "VERSION 3.16"), "optimization project parses");
+    const BuildTarget *target = project.PrimaryTarget();
+    if (target == nullptr)
+        return;
+    runner->Expect(target->CompileOptions == QList<QString>() << "$<$<OR:$<CONFIG:Release>,$<CONFIG:RelWithDebInfo>>:-O3>" << "$<$<CONFIG:Debug>:-fsanitize=address>",
+                   "_RELEASE and _DEBUG compile flags become configuration expressions");
+    runner->Expect(target->LinkOptions == QList<QString>() << "$<$<OR:$<CONFIG:Release>,$<CONFIG:RelWithDebInfo>>:-Wl,-O1>", "_RELEASE link flags become configuration expressions");
+    runner->Expect(target->Defines == QList<QString>() << "$<$<CONFIG:Debug>:FAST_DEBUG>" << "$<$<OR:$<CONFIG:Release>,$<CONFIG:RelWithDebInfo>>:FAST_RELEASE>",
+                   "build configuration scopes wrap their defines");
+    runner->Expect(target->Libraries == QList<QString>() << "$<$<OR:$<CONFIG:Release>,$<CONFIG:RelWithDebInfo>>:-lprofiler>", "else of a build configuration scope selects the other one");
+    runner->Expect(target->Sources == QList<QString>() << "main.cpp" << "$<$<CONFIG:Debug>:debug.cpp>", "build configuration scopes wrap their sources");
+    runner->Expect(!ContainsWarning(project, "Unsupported scoped qmake variable"), "sources of a build configuration scope are supported");
+    runner->Expect(target->ConditionalScopes.size() == 1 && target->ConditionalScopes.first().Condition == "WIN32"
+                   && target->ConditionalScopes.first().LinkOptions == QList<QString>() << "$<$<CONFIG:Debug>:/DEBUG>",
+                   "scoped _DEBUG flags keep their platform scope");
+
+    QString cmake = CMakeGenerator(CMakeQtVersion_Qt6).Generate(project, QList<CMakeOption>());
+    runner->Expect(cmake.contains("target_compile_options(fast PRIVATE $<$<OR:$<CONFIG:Release>,$<CONFIG:RelWithDebInfo>>:-O3>)"), "CMake output keeps release compile flags");
+    runner->Expect(cmake.contains("check_ipo_supported(RESULT IPO_SUPPORTED)\n    if(IPO_SUPPORTED)\n        set(CMAKE_INTERPROCEDURAL_OPTIMIZATION_RELEASE ON)"),
+                   "ltcg enables interprocedural optimization of release builds");
+    runner->Expect(cmake.indexOf("cmake_policy(SET CMP0069 NEW)") >= 0 && cmake.indexOf("cmake_policy(SET CMP0069 NEW)") < cmake.indexOf("add_executable(fast"),
+                   "the interprocedural optimization policy is set before the target");
+    runner->Expect(cmake.contains("set(fast_SOURCES\n    main.cpp\n)") && cmake.contains("target_sources(fast PRIVATE\n    $<$<CONFIG:Debug>:debug.cpp>\n)"),
+                   "sources of one build configuration are added with target_sources");
+    runner->Expect(cmake.contains("$<$<AND:$<OR:$<CONFIG:Release>,$<CONFIG:RelWithDebInfo>>,$<NOT:$<CXX_COMPILER_ID:MSVC>>>:-O3>"),
+                   "optimize_full raises the optimization level of release builds");
+
+    BuildProject round_trip;
+    CMakeParser round_trip_parser;
+    runner->Expect(round_trip_parser.Parse(cmake, &round_trip, "CMakeLists.txt") && round_trip.PrimaryTarget() != nullptr
+                   && Contains(round_trip.PrimaryTarget()->Config, "optimize_full") && !RoundTrip::HasLostValues(RoundTrip::Compare(project, round_trip)),
+                   "optimize_full survives a round trip through CMake");
+    BuildProject size;
+    QMakeParser size_parser;
+    size_parser.Parse("TARGET = small\nSOURCES += main.cpp\nCONFIG += optimize_size\n", &size, "small.pro", "VERSION 3.16");
+    BuildProject size_round_trip;
+    CMakeParser size_round_trip_parser;
+    size_round_trip_parser.Parse(CMakeGenerator(CMakeQtVersion_Qt6).Generate(size, QList<CMakeOption>()), &size_round_trip, "CMakeLists.txt");
+    runner->Expect(size_round_trip.PrimaryTarget() != nullptr && Contains(size_round_trip.PrimaryTarget()->Config, "optimize_size")
+                   && size_round_trip.PrimaryTarget()->CompileOptions.isEmpty(),
+                   "optimize_size survives a round trip through CMake");
+
+    BuildProject scoped;
+    QMakeParser scoped_parser;
+    scoped_parser.Parse("TARGET = scoped\nSOURCES += main.cpp\n"
+                        "CONFIG(release, debug|release) {\n    QMAKE_CXXFLAGS_RELEASE += -funroll-loops\n    QMAKE_CXXFLAGS_DEBUG += -O0\n}\n"
+                        "else: QMAKE_LFLAGS_RELEASE += -s\n", &scoped, "scoped.pro", "VERSION 3.16");
+    runner->Expect(scoped.PrimaryTarget() != nullptr
+                   && scoped.PrimaryTarget()->CompileOptions == QList<QString>() << "$<" + BuildConfig::Release + ":-funroll-loops>",
+                   "_RELEASE flags in a release scope are wrapped once");
+    runner->Expect(scoped.PrimaryTarget() != nullptr && scoped.PrimaryTarget()->LinkOptions.isEmpty()
+                   && ContainsWarning(scoped, "QMAKE_CXXFLAGS_DEBUG is never used in the other build configuration at line 5")
+                   && ContainsWarning(scoped, "QMAKE_LFLAGS_RELEASE is never used in the other build configuration at line 7"),
+                   "flags of the other build configuration are dropped with a warning");
+
+    QString qmake = QMakeGenerator().Generate(project);
+    runner->Expect(qmake.contains("QMAKE_CXXFLAGS_RELEASE += -O3\n") && qmake.contains("QMAKE_CXXFLAGS_DEBUG += -fsanitize=address\n")
+                   && qmake.contains("QMAKE_LFLAGS_RELEASE += -Wl,-O1\n"), "qmake output maps configuration expressions back to _RELEASE and _DEBUG");
+    runner->Expect(qmake.contains("CONFIG(release, debug|release) {\n    DEFINES += FAST_RELEASE\n    LIBS += -lprofiler\n}\n")
+                   && qmake.contains("CONFIG(debug, debug|release) {\n    SOURCES += debug.cpp\n    DEFINES += FAST_DEBUG\n}\n"), "qmake output scopes configuration sources, defines and libraries");
+    runner->Expect(qmake.contains("win32 {\n    QMAKE_LFLAGS_DEBUG += /DEBUG\n}"), "qmake output maps scoped configuration flags");
+    runner->Expect(!qmake.contains("CMake generator expressions require manual qmake review"), "configuration expressions need no manual review");
+
+    BuildProject reparsed;
+    CMakeParser cmake_parser;
+    runner->Expect(cmake_parser.Parse("project(lto)\nset(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)\nadd_executable(lto main.cpp)\n", &reparsed, "CMakeLists.txt")
+                   && reparsed.PrimaryTarget() != nullptr && Contains(reparsed.PrimaryTarget()->Config, "ltcg"),
+                   "CMAKE_INTERPROCEDURAL_OPTIMIZATION maps to CONFIG += ltcg");
+
+    BuildProject plain;
+    CMakeParser plain_parser;
+    runner->Expect(plain_parser.Parse("project(plain)\nadd_executable(plain main.cpp)\ntarget_compile_options(plain PRIVATE $<$<CONFIG:Release>:-O2>)\n", &plain, "CMakeLists.txt")
+                   && QMakeGenerator().Generate(plain).contains("QMAKE_CXXFLAGS_RELEASE += -O2\n"),
+                   "plain $<CONFIG:Release> of hand written CMake maps to _RELEASE");
+}
+
+static void TestProfileGuidedOptimization(TestRunner *runner)
+{
+    BuildProject project;
+    QMakeParser parser;
+    runner->Expect(parser.Parse("TARGET = service\nSOURCES += main.cpp\n", &project, "service.pro", "VERSION 3.16"), "PGO project parses");
+
+    QString plain = CMakeGenerator(CMakeQtVersion_Qt6).Generate(project, QList<CMakeOption>());
+    runner->Expect(!plain.contains("PGO"), "CMake output has no PGO block unless asked for");
+
+    QList<CMakeOption> options = CMakeGenerator::ProfileGuidedOptimizationOptions();
+    QString cmake = CMakeGenerator(CMakeQtVersion_Qt6).Generate(project, options);
+    runner->Expect(cmake.contains("set(PGO \"OFF\" CACHE STRING \"Profile guided optimization: OFF, instrument or use\")\n"
+                                  "set_property(CACHE PGO PROPERTY STRINGS OFF instrument use)\n"),
+                   "PGO is a cache variable with its choices");
+    runner->Expect(cmake.contains("set(PGO_PROFILE_DIR \"\" CACHE PATH "), "the profile directory is a cache path");
+    runner->Expect(cmake.contains("elseif(PGO STREQUAL \"instrument\")\n    target_compile_options(service PRIVATE -fprofile-generate=${PGO_PROFILE_DIR}"),
+                   "instrument builds generate profiles");
+    runner->Expect(cmake.contains("target_compile_options(service PRIVATE -fprofile-use=${PGO_PROFILE_DIR} -fprofile-partial-training -Wno-missing-profile)"),
+                   "GCC builds use the profiles and keep untrained code optimized");
+    runner->Expect(cmake.contains("target_compile_options(service PRIVATE -fprofile-use=${PGO_PROFILE_DIR}.profdata)"), "Clang builds use the merged profile");
+    runner->Expect(cmake.contains("add_custom_target(service_pgo_merge\n            COMMAND \"${LLVM_PROFDATA}\" merge"),
+                   "Clang builds get a target that merges the profiles");
+    runner->Expect(cmake.indexOf("add_executable(service") < cmake.indexOf("-fprofile-generate"), "PGO flags are added after the target");
+
+    QString presets = CMakePresetsGenerator(CMakeQtVersion_Qt6, "").Generate(project, options);
+    runner->Expect(presets.contains("\"PGO\": \"OFF\""), "presets configure PGO off");
+
+    QList<CMakeOption> boolean;
+    boolean << CMakeOption("WITH_TESTS", "Build tests", "FALSE");
+    runner->Expect(CMakeGenerator(CMakeQtVersion_Qt6).Generate(project, boolean).contains("option(WITH_TESTS \"Build tests\" FALSE)\n"),
+                   "options without a type stay option()");
+}
+
+static void TestBuildAcceleration(TestRunner *runner)
+{
+    BuildProject project;
+    QMakeParser parser;
+    runner->Expect(parser.Parse("TARGET = service\nSOURCES += main.cpp\n", &project, "service.pro", "VERSION 3.16"), "build acceleration project parses");
+
+    QString plain = CMakeGenerator(CMakeQtVersion_Qt6).Generate(project, QList<CMakeOption>());
+    runner->Expect(!plain.contains("COMPILER_LAUNCHER") && !plain.contains("JOB_POOL"), "CMake output has no build acceleration unless asked for");
+
+    QString cmake = CMakeGenerator(CMakeQtVersion_Qt6).Generate(project, CMakeGenerator::BuildAccelerationOptions());
+    runner->Expect(cmake.contains("option(USE_COMPILER_LAUNCHER ") && cmake.contains("option(USE_FAST_LINKER ")
+                   && cmake.contains("option(USE_SPLIT_DWARF ") && cmake.contains("option(LIMIT_LINK_JOBS "),
+                   "every part of the build acceleration has its option");
+    runner->Expect(cmake.contains("if(USE_COMPILER_LAUNCHER AND NOT CMAKE_CXX_COMPILER_LAUNCHER)\n    find_program(COMPILER_LAUNCHER NAMES ccache sccache)"),
+                   "ccache or sccache becomes the compiler launcher");
+    runner->Expect(!cmake.contains("VERSION_LESS 3.4"), "the launcher needs no version check with a new enough minimum");
+    runner->Expect(cmake.contains("if(NOT CMAKE_VERSION VERSION_LESS 3.18)\n    if(USE_FAST_LINKER"), "the linker check is guarded by the CMake version");
+    runner->Expect(cmake.contains("add_link_options(-fuse-ld=${FAST_LINKER})") && cmake.contains("string(TOUPPER ${FAST_LINKER} CMAKE_LINKER_TYPE)"),
+                   "the linker is picked with LINKER_TYPE or -fuse-ld");
+    runner->Expect(cmake.contains("add_compile_options($<$<OR:$<CONFIG:Debug>,$<CONFIG:RelWithDebInfo>>:-gsplit-dwarf>)"), "builds with debug info split DWARF");
+    runner->Expect(cmake.contains("set_property(GLOBAL APPEND PROPERTY JOB_POOLS link_jobs=${LINK_JOBS})\n    set(CMAKE_JOB_POOL_LINK link_jobs)"),
+                   "Ninja links run in their own pool");
+    runner->Expect(cmake.indexOf("set(CMAKE_JOB_POOL_LINK") < cmake.indexOf("add_executable(service"), "build acceleration comes before the target");
+
+    QList<CMakeOption> launcher_only;
+    launcher_only << CMakeGenerator::BuildAccelerationOptions().first();
+    CMakeGenerator old_generator(CMakeQtVersion_Qt5);
+    old_generator.SetMinimumVersion("VERSION 3.1.0");
+    QString old_cmake = old_generator.Generate(project, launcher_only);
+    runner->Expect(old_cmake.contains("if(NOT CMAKE_VERSION VERSION_LESS 3.4)\n    if(USE_COMPILER_LAUNCHER"), "older minimums check the version for the launcher");
+    runner->Expect(!old_cmake.contains("USE_FAST_LINKER") && !old_cmake.contains("-gsplit-dwarf"), "only the parts of the given options are generated");
+}
+
+static void TestCMakeTargetProperties(TestRunner *runner)
+{
+    QString fixture = Fixture("cmake/properties/CMakeLists.txt");
+    BuildProject project;
+    CMakeParser parser;
+    runner->Expect(parser.Parse(ReadFile(fixture), &project, fixture), "target property fixture parses");
+    const BuildTarget *core = nullptr;
+    const BuildTarget *props = nullptr;
+    const BuildTarget *legacy = nullptr;
+    for (int i = 0; i < project.Targets.size(); i++)
+    {
+        if (project.Targets.at(i).Name == "core")
+            core = &project.Targets.at(i);
+        else if (project.Targets.at(i).Name == "props")
+            props = &project.Targets.at(i);
+        else if (project.Targets.at(i).Name == "legacy")
+            legacy = &project.Targets.at(i);
+    }
+    if (core == nullptr || props == nullptr || legacy == nullptr)
+    {
+        runner->Expect(false, "target property fixture has every target");
+        return;
+    }
+    runner->Expect(core->Config == QList<QString>() << "c++20", "CMAKE_CXX_STANDARD initializes targets created after it");
+    runner->Expect(core->PrecompiledHeaders == QList<QString>() << "core_pch.h" << "extra_pch.h", "set_property APPEND adds precompiled headers");
+    runner->Expect(Contains(props->Config, "c++17") && !Contains(props->Config, "c++14"), "CXX_STANDARD replaces the standard of the target");
+    runner->Expect(Contains(props->Config, "strict_c++") && Contains(props->Config, "ltcg"), "CXX_EXTENSIONS and INTERPROCEDURAL_OPTIMIZATION map to CONFIG");
+    runner->Expect(props->PrecompiledHeaders == QList<QString>() << "core_pch.h", "PRECOMPILE_HEADERS_REUSE_FROM copies the header of a known target");
+    runner->Expect(ContainsWarning(project, "set_target_properties is not fully represented at line 8: UNITY_BUILD"), "unity builds are reported");
+    runner->Expect(ContainsWarning(project, "set_property is not fully represented at line 12: UNITY_BUILD_BATCH_SIZE"), "set_property reports target properties qmake lacks");
+    runner->Expect(ContainsWarning(project, "set_property on DIRECTORY is not represented at line 13"), "set_property outside of targets is reported");
+    runner->Expect(ContainsWarning(project, "set_target_properties is not fully represented at line 15: INTERPROCEDURAL_OPTIMIZATION"), "conditional properties are reported");
+    runner->Expect(!Contains(core->Config, "ltcg"), "conditional properties do not apply to every platform");
+    runner->Expect(ContainsWarning(project, "set_target_properties is not fully represented at line 18: CXX_STANDARD, VS_GLOBAL_KEYWORD")
+                   && Contains(legacy->Config, "c++14"), "C++98 and Visual Studio properties are reported");
+    runner->Expect(ContainsWarning(project, "set_target_properties on the unknown target lagacy is not represented at line 19")
+                   && ContainsWarning(project, "set_property on the unknown target missing is not represented at line 20")
+                   && project.Targets.size() == 3 && Contains(legacy->Config, "strict_c++"), "properties of unknown targets are reported, not turned into targets");
+    runner->Expect(ContainsWarning(project, "qmake supports one precompiled header, core defined at line 4 also lists: extra_pch.h"),
+                   "extra precompiled headers are reported");
+
+    QString qmake = QMakeGenerator().Generate(project);
+    runner->Expect(qmake.contains("CONFIG += \\\n    c++20 \\\n    precompile_header\n"), "qmake output keeps the standard and the precompiled header");
+    runner->Expect(qmake.contains("PRECOMPILED_HEADER = core_pch.h\n"), "qmake output uses the first precompiled header");
+
+    BuildProject app;
+    runner->Expect(parser.Parse("project(app)\nadd_executable(app main.cpp)\nset_target_properties(app PROPERTIES CXX_STANDARD 17 INTERPROCEDURAL_OPTIMIZATION ON)\n",
+                                &app, "CMakeLists.txt"), "single target property project parses");
+    qmake = QMakeGenerator().Generate(app);
+    runner->Expect(qmake.contains("CONFIG += \\\n    c++17 \\\n    ltcg\n"), "qmake output maps the standard and link time optimization");
+    QString cmake = CMakeGenerator(CMakeQtVersion_Qt6).Generate(app, QList<CMakeOption>());
+    runner->Expect(cmake.contains("set(CMAKE_CXX_STANDARD 17)\n") && !cmake.contains("set(CMAKE_CXX_STANDARD 11)"), "the mapped standard converts back to CMake");
+}
+
+static void TestPchAnalyzer(TestRunner *runner)
+{
+    runner->Expect(PchAnalyzer::ReadIncludes("#include <a.h>\n  #  include \"b/c.h\" // note\n#import <d.h>\n#include MACRO\n")
+                   == QStringList() << "<a.h>" << "\"b/c.h\"", "include directives are read as written");
+    runner->Expect(PchAnalyzer::ReadIncludes("#include <a.h>\n#ifdef Q_OS_WIN\n#include <windows.h>\n#else\n#if HAVE_UNISTD\n#include <unistd.h>\n#endif\n"
+                                             "#endif\n#include <b.h>\n") == QStringList() << "<a.h>" << "<b.h>",
+                   "includes inside #if blocks are not precompiled");
+    runner->Expect(PchAnalyzer::IsGeneratedHeader("forms/ui_main.h") && PchAnalyzer::IsGeneratedHeader("view.moc")
+                   && !PchAnalyzer::IsGeneratedHeader("QtCore"), "moc, uic and rcc output is never precompiled");
+
+    QString fixture = Fixture("qmake/pch/pch.pro");
+    BuildProject project;
+    QMakeParser parser;
+    runner->Expect(parser.Parse(ReadFile(fixture), &project, fixture, "VERSION 3.16"), "precompiled header fixture parses");
+    PchSuggestion suggestion = PchAnalyzer(QFileInfo(fixture).absolutePath()).Analyze(*project.PrimaryTarget());
+    runner->Expect(suggestion.Units == 3 && suggestion.Includes == 14, "sources that cannot be read are left out of the analysis");
+    QStringList headers;
+    foreach (const PchHeader &header, suggestion.Headers)
+        headers << header.Include + "=" + QString::number(header.Units);
+    runner->Expect(headers == QStringList() << "<QString>=3" << "<common.h>=2" << "<vector>=2",
+                   "headers most units share are picked, own and generated headers are not");
+    runner->Expect(suggestion.FileName == "pch_app_pch.h" && suggestion.CoveredUnits == 3 && suggestion.CoveredIncludes == 7,
+                   "coverage counts the include directives the header takes care of");
+    runner->Expect(suggestion.HeaderText().contains("#if defined(__cplusplus)\n#include <QString>\n#include <common.h>\n#include <vector>\n#endif\n")
+                   && suggestion.Report().contains("50% of 14 include directives"), "generated header and report list the picked headers");
+}
+
+static void TestUnityPlanner(TestRunner *runner)
+{
+    UnitySymbols symbols = UnityPlanner::Scan("#define KEEP 1\n#define DROP(x) \\\n    x\n#undef DROP\n"
+                                              "static const int limit = 4;\nstatic QString Name(\"a;b\");\n"
+                                              "namespace { class Cache { static int hidden; }; typedef int Count; }\n"
+                                              "namespace named { static void Run() { static int inner; } }\n"
+                                              "using namespace std;\nQ_DECLARE_METATYPE(Cache)\nint Visible() { return 0; }\n");
+    QStringList locals = symbols.LocalSymbols.values();
+    std::sort(locals.begin(), locals.end());
+    runner->Expect(locals == QStringList() << "Cache" << "Count" << "Name" << "Run" << "limit",
+                   "unity scan finds static and anonymous namespace names at file scope only");
+    runner->Expect(symbols.Macros.values() == QList<QString>() << "KEEP", "unity scan keeps macros that are not undefined");
+    runner->Expect(symbols.UsingNamespaces == QStringList() << "std", "unity scan finds using namespace at file scope");
+
+    symbols = UnityPlanner::Scan("const int kLimit = 4;\nconstexpr double kScale{2.0};\nint *const kSlot = nullptr;\nstatic_assert(kLimit > 0, \"x\");\n"
+                                 "extern const int kShared = 1;\ninline constexpr int kInline = 2;\nconst char *kName = \"a\";\n"
+                                 "const QString &Title();\nconst QList<const char *> kNames;\nnamespace named { const int kNested = 3; }\n");
+    locals = symbols.LocalSymbols.values();
+    std::sort(locals.begin(), locals.end());
+    runner->Expect(locals == QStringList() << "kLimit" << "kNames" << "kNested" << "kScale" << "kSlot",
+                   "unity scan treats const and constexpr variables that are not extern or inline as file local");
+    QStringList externals = symbols.ExternalSymbols.values();
+    std::sort(externals.begin(), externals.end());
+    runner->Expect(externals == QStringList() << "Title" << "kInline" << "kName" << "kShared",
+                   "unity scan finds the names with external linkage");
+
+    QString fixture = Fixture("qmake/unity/unity.pro");
+    BuildProject project;
+    QMakeParser parser;
+    runner->Expect(parser.Parse(ReadFile(fixture), &project, fixture, "VERSION 3.16"), "unity fixture parses");
+    UnityPlan plan = UnityPlanner(QFileInfo(fixture).absolutePath(), 3).Plan(*project.PrimaryTarget());
+    runner->Expect(plan.Batches.size() == 2 && plan.Batches.at(0).Sources == QStringList() << "alpha.cpp" << "gamma.cpp" << "zeta.cpp"
+                   && plan.Batches.at(1).Sources == QStringList() << "beta.cpp" << "delta.cpp",
+                   "unity batches keep sources with the same file local names and macros apart");
+    runner->Expect(plan.Excluded == QStringList() << "missing.cpp" << "epsilon.cpp" << "eta.cpp", "unreadable and unbatchable sources are compiled on their own");
+    runner->Expect(plan.Report().contains("beta.cpp and alpha.cpp both define the file local name helper")
+                   && plan.Report().contains("eta.cpp and beta.cpp both define the name helper, it has external linkage in eta.cpp")
+                   && plan.Report().contains("delta.cpp and gamma.cpp both define the macro LOG_TAG"), "unity report explains the grouping");
+
+    CMakeGenerator generator(CMakeQtVersion_Qt6);
+    generator.SetMinimumVersion("VERSION 3.18.0");
+    generator.SetUnityPlan(plan);
+    QString cmake = generator.Generate(project, QList<CMakeOption>());
+    runner->Expect(cmake.contains("\nset_target_properties(unity_app PROPERTIES UNITY_BUILD ON UNITY_BUILD_MODE GROUP)\n")
+                   && cmake.contains("    delta.cpp\n    PROPERTIES UNITY_GROUP unity_app_unity_2\n)\n")
+                   && cmake.contains("    epsilon.cpp\n    eta.cpp\n    PROPERTIES SKIP_UNITY_BUILD_INCLUSION ON\n)\n"), "CMake output groups the unity batches");
+    runner->Expect(CMakeGenerator(CMakeQtVersion_Qt6).Generate(project, QList<CMakeOption>()).indexOf("UNITY") < 0,
+                   "CMake output has no unity batches without a plan");
+}
+
+static QString AllocationQMakeProject(int items)
+{
+    QString text = "TARGET = allocations\nTEMPLATE = app\nQT += widgets\n";
+    for (int i = 0; i < items; i++)
+    {
+        text += QString("SOURCES += src/file%1.cpp\nHEADERS += include/file%1.h\n").arg(i);
+        text += QString("win32: DEFINES += WIN_%1\nLIBS += -lfile%1\n").arg(i);
+    }
+    return text;
+}
+
+static QString AllocationCMakeProject(int items)
+{
+    QString text = "project(allocations)\nfind_package(Qt6 COMPONENTS Core Widgets REQUIRED)\nadd_executable(allocations main.cpp)\n";
+    for (int i = 0; i < items; i++)
+    {
+        text += QString("target_sources(allocations PRIVATE src/file%1.cpp include/file%1.h)\n").arg(i);
+        text += QString("target_compile_definitions(allocations PRIVATE FILE_%1)\ntarget_link_libraries(allocations PRIVATE file%1)\n").arg(i);
+    }
+    return text;
+}
+
+static qint64 CountConversionAllocations(bool qmake_input, int items)
+{
+    QString text = qmake_input ? AllocationQMakeProject(items) : AllocationCMakeProject(items);
+    qint64 before = MemoryReport::Allocations.load();
+    BuildProject project;
+    if (qmake_input)
+    {
+        QMakeParser parser;
+        parser.Parse(text, &project, "allocations.pro", "VERSION 3.16");
+        CMakeGenerator(CMakeQtVersion_Qt6).Generate(project, QList<CMakeOption>());
+    } else
+    {
+        CMakeParser parser;
+        parser.Parse(text, &project, "CMakeLists.txt");
+        QMakeGenerator().Generate(project);
+    }
+    return MemoryReport::Allocations.load() - before;
+}
+
+static void TestConversionAllocations(TestRunner *runner)
+{
+    if (!MemoryReport::Counting)
+    {
+        runner->Skip("allocation counting is not linked into the test executable");
+        return;
+    }
+#if defined(__GLIBC__)
+    // Volatile keeps the compiler from dropping allocations that are never used
+    qint64 before = MemoryReport::Allocations.load();
+    void *volatile aligned = aligned_alloc(64, 128);
+    void *posix_aligned = nullptr;
+    bool posix_result = posix_memalign(&posix_aligned, 64, 128) == 0;
+    void *volatile kept = posix_aligned;
+    qint64 counted = MemoryReport::Allocations.load() - before;
+    runner->Expect(counted == 2 && aligned != nullptr && posix_result, "aligned allocations are counted");
+    free(aligned);
+    free(kept);
+#endif
+    // Every item is four statements, the difference between two sizes leaves out fixed costs
+    const qint64 maximum_per_item = 120;
+    for (int i = 0; i < 2; i++)
+    {
+        bool qmake_input = i == 0;
+        qint64 small = CountConversionAllocations(qmake_input, 200);
+        qint64 large = CountConversionAllocations(qmake_input, 400);
+        qint64 per_item = (large - small) / 200;
+        runner->Expect(per_item <= maximum_per_item, QString(qmake_input ? "qmake" : "CMake") + " conversion allocates "
+                       + QString::number(per_item) + " times per item, limit " + QString::number(maximum_per_item));
+    }
+}
+
+static void TestTokenViews(TestRunner *runner)
+{
+    runner->Expect(TokenView(QStringView(u"\"a b\"c"), true).ToString() == "a bc", "token view drops quote characters");
+    runner->Expect(TokenView(QStringView(u"a\\\"b"), true).ToString() == "a\\\"b", "token view keeps escaped quotes");
+
+    QString cmake = "project(tokens)\n"
+                    "add_executable(app # first comment (with parens)\n"
+                    "    \"file with space.cpp\" \"\"\n"
+                    "    # whole line comment.cpp\n"
+                    "    other.cpp $<$<CONFIG:Debug>:debug.cpp>) # trailing )\n";
+    BuildProject cmake_project;
+    CMakeParser cmake_parser;
+    runner->Expect(cmake_parser.Parse(cmake, &cmake_project, "CMakeLists.txt"), "multi-line command with comments parses");
+    const BuildTarget *target = cmake_project.PrimaryTarget();
+    runner->Expect(target != nullptr && target->Sources == QList<QString>() << "file with space.cpp" << "other.cpp" << "$<$<CONFIG:Debug>:debug.cpp>",
+                   "comments inside a command and empty quoted arguments are skipped");
+
+    QString qmake = "TARGET = tokens\nTEMPLATE = app\nSOURCES += \"a b.cpp\" \"\" c.cpp\n";
+    BuildProject qmake_project;
+    QMakeParser qmake_parser;
+    runner->Expect(qmake_parser.Parse(qmake, &qmake_project, "tokens.pro", "VERSION 3.16"), "quoted qmake values parse");
+    target = qmake_project.PrimaryTarget();
+    runner->Expect(target != nullptr && target->Sources == QList<QString>() << "a b.cpp" << "c.cpp", "quoted qmake values keep their spaces");
+
+    if (!MemoryReport::Counting)
+    {
+        runner->Skip("allocation counting is not linked into the test executable");
+        return;
+    }
+    // Arguments of commands without a handler stay views into the text
+    QString unsupported;
+    for (int i = 0; i < 1000; i++)
+        unsupported += QString("not_handled(first_argument_%1 second_argument_%1 third_argument_%1)\n").arg(i);
+    qint64 before = MemoryReport::Allocations.load();
+    cmake_parser.Parse(unsupported, &cmake_project, "CMakeLists.txt");
+    qint64 per_command = (MemoryReport::Allocations.load() - before) / 1000;
+    runner->Expect(per_command <= 3, "lexing allocates " + QString::number(per_command) + " times per unsupported command, limit 3");
+}
+
+static void TestCharScanner(TestRunner *runner)
+{
+    QString text;
+    const char16_t samples[] = { u'a', u' ', u'#', u'"', u'\'', u'(', u'\t', 0x01, 0xA0, 0xFFFF, 0x8020, u'\\', u'z', u'_' };
+    for (int i = 0; i < 300; i++)
+        text += QChar(samples[(i * 7 + i / 13) % 14]);
+
+    CharScannerLevel level = CharScanner::Level();
+    QList<CharScanner> scanners;
+    scanners << CharScanner("#\"'") << CharScanner("()", true) << CharScanner("", true) << CharScanner("q");
+    for (int candidate = CharScanner_SSE2; candidate <= CharScanner::SupportedLevel(); candidate++)
+    {
+        bool same = true;
+        for (int length = 0; length <= 40 && same; length++)
+        {
+            QStringView view = QStringView(text).mid(length, text.size() - 2 * length);
+            foreach (const CharScanner &scanner, scanners)
+            {
+                for (int from = 0; from <= view.size(); from++)
+                {
+                    CharScanner::SetLevel(CharScanner_Scalar);
+                    int expected = scanner.Next(view, from);
+                    CharScanner::SetLevel(static_cast<CharScannerLevel>(candidate));
+                    same = same && scanner.Next(view, from) == expected;
+                }
+            }
+        }
+        runner->Expect(same, CharScanner::LevelName(static_cast<CharScannerLevel>(candidate)) + " scanner matches the scalar scanner");
+    }
+    CharScanner::SetLevel(level);
+    runner->Expect(CharScanner("#").Next(QStringView(u"abc"), 0) == 3, "scanner returns the size when there is no stop");
+}
+
+static void TestModelCache(TestRunner *runner)
+{
+    QString qmake_fixture = Fixture("qmake/complex/complex.pro");
+    BuildProject qmake_project;
+    QMakeParser qmake_parser;
+    qmake_parser.Parse(ReadFile(qmake_fixture), &qmake_project, qmake_fixture, "VERSION 3.16");
+    ModelCacheInfo info;
+    info.SourceFile = qmake_fixture;
+    QByteArray data = ModelCache::Serialize(qmake_project, info);
+
+    BuildProject loaded;
+    ModelCacheInfo loaded_info;
+    QString error;
+    const uchar *bytes = reinterpret_cast<const uchar *>(data.constData());
+    runner->Expect(ModelCache::Deserialize(bytes, data.size(), &loaded, &loaded_info, &error), "qmake model cache loads");
+    runner->Expect(loaded_info.QMakeInput && loaded_info.SourceFile == qmake_fixture, "model cache keeps its origin");
+    runner->Expect(CMakeGenerator(CMakeQtVersion_Qt5).Generate(loaded, QList<CMakeOption>())
+                   == CMakeGenerator(CMakeQtVersion_Qt5).Generate(qmake_project, QList<CMakeOption>()),
+                   "CMake generated from a cached qmake model matches the parsed model");
+    runner->Expect(loaded.Warnings.size() == qmake_project.Warnings.size() && loaded.WarningKeys == qmake_project.WarningKeys,
+                   "model cache keeps warnings and their source locations");
+
+    QString cmake_fixture = Fixture("cmake/complex/CMakeLists.txt");
+    BuildProject cmake_project;
+    CMakeParser cmake_parser;
+    cmake_parser.Parse(ReadFile(cmake_fixture), &cmake_project, cmake_fixture);
+    info.QMakeInput = false;
+    info.SourceFile = cmake_fixture;
+    data = ModelCache::Serialize(cmake_project, info);
+    bytes = reinterpret_cast<const uchar *>(data.constData());
+    runner->Expect(ModelCache::Deserialize(bytes, data.size(), &loaded, &loaded_info, &error) && !loaded_info.QMakeInput
+                   && QMakeGenerator().Generate(loaded) == QMakeGenerator().Generate(cmake_project),
+                   "qmake generated from a cached CMake model matches the parsed model");
+
+    runner->Expect(!ModelCache::Deserialize(bytes, data.size() - 4, &loaded, &loaded_info, &error) && loaded.Targets.isEmpty(),
+                   "truncated model cache is refused");
+    QByteArray other_version = data;
+    other_version[4] = static_cast<char>(ModelCache::FormatVersion + 1);
+    runner->Expect(!ModelCache::Deserialize(reinterpret_cast<const uchar *>(other_version.constData()), other_version.size(), &loaded, &loaded_info, &error)
+                   && error.contains("format"), "model cache of another format version is refused");
+    QByteArray corrupted = data;
+    for (int i = corrupted.size() - 64; i < corrupted.size(); i++)
+        corrupted[i] = static_cast<char>(0xff);
+    runner->Expect(!ModelCache::Deserialize(reinterpret_cast<const uchar *>(corrupted.constData()), corrupted.size(), &loaded, &loaded_info, &error),
+                   "model cache with invalid string indexes is refused");
+}
+
+static void TestModelJson(TestRunner *runner)
+{
+    BuildProject project;
+    project.Name = "json \"app\"";
+    BuildTarget *target = project.EnsurePrimaryTarget();
+    target->Name = "app";
+    target->Sources << "main.cpp" << "dir\\win.cpp";
+    BuildConditionalScope scope;
+    scope.Condition = "UNIX";
+    scope.Sources << "unix.cpp";
+    target->ConditionalScopes.append(scope);
+    BuildTarget other;
+    other.Name = "tool";
+    other.Sources << "tool.cpp";
+    project.Targets.append(other);
+
+    QString text;
+    QTextStream out(&text);
+    ModelJson::Write(project, &out);
+    runner->Expect(text.startsWith("{\"Name\":\"json \\\"app\\\"\",") && text.endsWith("]}\n"), "model JSON escapes strings and ends with a newline");
+    runner->Expect(text.contains("\n{\"Name\":\"tool\",") && text.contains("\"Sources\":[\"main.cpp\",\"dir\\\\win.cpp\"]"),
+                   "model JSON writes every target on its own line");
+
+    QString error;
+    QString selected;
+    QTextStream query(&selected);
+    runner->Expect(ModelJson::Query(project, "targets[].Sources", &query, &error)
+                   && selected == "[\"main.cpp\",\"dir\\\\win.cpp\"]\n[\"tool.cpp\"]\n", "query prints one value per target");
+    selected.clear();
+    runner->Expect(ModelJson::Query(project, "Targets[0].ConditionalScopes[].Condition", &query, &error) && selected == "\"UNIX\"\n",
+                   "query walks indexed and nested lists");
+    selected.clear();
+    runner->Expect(ModelJson::Query(project, "Targets[5].Name", &query, &error) && selected.isEmpty(), "query past the end of a list selects nothing");
+    runner->Expect(!ModelJson::IsValidSelector("Targets.Sources", &error) && error.contains("Targets[]"), "query refuses a field of a list");
+    runner->Expect(!ModelJson::IsValidSelector("Targets[].Bogus", &error) && error.contains("Bogus"), "query refuses unknown fields");
+    runner->Expect(!ModelJson::IsValidSelector("Name[]", &error), "query refuses to iterate a string");
+    runner->Expect(ModelJson::IsValidSelector("Warnings[].Location.LineNumber", &error), "query accepts warning locations");
+}
+
+static void TestCompileCommands(TestRunner *runner)
+{
+    bool known = false;
+#if defined(Q_OS_LINUX)
+    runner->Expect(CompileFlags::IsHostCondition("UNIX AND NOT APPLE", &known) && known, "UNIX AND NOT APPLE holds on Linux");
+    runner->Expect(!CompileFlags::IsHostCondition("WIN32 OR (APPLE)", &known) && known, "WIN32 OR APPLE does not hold on Linux");
+#endif
+    CompileFlags::IsHostCondition("UNIX AND contains(QT, network)", &known);
+    runner->Expect(!known, "conditions with qmake functions are unknown");
+
+    BuildProject project;
+    BuildTarget *target = project.EnsurePrimaryTarget();
+    target->Name = "app";
+    target->Sources << "main.cpp" << "legacy.c" << "notes.txt";
+    target->Headers << "window.h";
+    target->QtModules << "core" << "printsupport";
+    target->Config << "c++17";
+    target->Defines << "APP";
+    target->IncludePaths << "include";
+    target->CompileOptions << "-Wall" << "$<$<CONFIG:Debug>:-O0>";
+    target->Defines << "$<$<CONFIG:Debug>:APP_TRACE>" << "$<" + BuildConfig::Release + ":QT_NO_DEBUG_OUTPUT>";
+    target->IncludePaths << "$<" + BuildConfig::Debug + ":debug_include>" << "$<" + BuildConfig::Release + ":release_include>";
+    target->CompileOptions << "$<" + BuildConfig::Release + ":-O3>" << "$<$<CXX_COMPILER_ID:MSVC>:/W4>";
+    BuildConditionalScope scope;
+    scope.Condition = "FALSE";
+    scope.Sources << "never.cpp";
+    scope.Defines << "NEVER";
+    target->ConditionalScopes.append(scope);
+    scope.Condition = "TRUE";
+    scope.Sources.clear();
+    scope.Sources << "always.cpp";
+    scope.Defines.clear();
+    scope.Defines << "ALWAYS";
+    target->ConditionalScopes.append(scope);
+
+    QString json = CompileCommandsGenerator("/src/app", "/opt/qt").Generate(project);
+    runner->Expect(json.startsWith("[\n  {\"directory\":\"/src/app\",\"file\":\"/src/app/main.cpp\",\"arguments\":[\"c++\",\"-std=c++17\","),
+                   "compile commands start with the first C++ source");
+    runner->Expect(json.contains("\"-DQT_PRINTSUPPORT_LIB\"") && json.contains("\"-I/opt/qt/QtPrintSupport\"") && json.contains("\"-Iinclude\""),
+                   "compile commands include Qt module headers and include paths");
+    runner->Expect(json.contains("\"file\":\"/src/app/legacy.c\",\"arguments\":[\"cc\",") && !json.contains("window.h") && !json.contains("notes.txt"),
+                   "compile commands only list compiled sources and use the C compiler for C files");
+    runner->Expect(json.contains("/src/app/always.cpp") && json.contains("\"-DALWAYS\"") && !json.contains("never.cpp") && !json.contains("NEVER"),
+                   "compile commands only use scopes that hold on the host");
+    runner->Expect(json.contains("\"-Wall\"") && !json.contains("CONFIG:Debug") && json.endsWith("]}\n]\n"),
+                   "compile commands leave out generator expressions");
+    runner->Expect(json.contains("\"-DQT_NO_DEBUG_OUTPUT\"") && json.contains("\"-Irelease_include\"") && json.contains("\"-O3\"")
+                   && !json.contains("APP_TRACE") && !json.contains("debug_include") && !json.contains("/W4") && !json.contains("$<"),
+                   "compile commands use the Release values of per-configuration defines, include paths and options");
+    runner->Expect(CompileCommandsGenerator("/src", "").Generate(BuildProject()) == "[]\n", "empty project has an empty compilation database");
+}
+
+static void TestNinjaGenerator(TestRunner *runner)
+{
+    runner->Expect(NinjaGenerator::EscapePath("C:/my dir/$x") == "C$:/my$ dir/$$x", "ninja paths escape colons, spaces and dollars");
+    runner->Expect(NinjaGenerator::QuoteArgument("-DNAME=1") == "-DNAME=1" && NinjaGenerator::QuoteArgument("-Ia b") == "'-Ia b'"
+                   && NinjaGenerator::QuoteArgument("it's") == "'it'\\''s'", "ninja command arguments are quoted only when needed");
+
+    BuildProject project;
+    BuildTarget *target = project.EnsurePrimaryTarget();
+    target->Name = "app";
+    target->Type = BuildTarget_Application;
+    target->Sources << "main.cpp" << "../shared/util.c";
+    target->Headers << "missing_window.h";
+    target->UiFiles << "ui/window.ui";
+    target->ResourceFiles << "app.qrc";
+    target->QtModules << "core" << "widgets";
+    target->IncludePaths << "include dir";
+    target->Libraries << "-Llib" << "-lssl" << "crypto";
+    target->Defines << "$<$<CONFIG:Debug>:APP_TRACE>" << "$<" + BuildConfig::Release + ":QT_NO_DEBUG_OUTPUT>";
+    target->LinkOptions << "$<" + BuildConfig::Release + ":-Wl,-O1>" << "$<$<CONFIG:Debug>:-rdynamic>";
+    BuildTarget library;
+    library.Name = "support";
+    library.Type = BuildTarget_Library;
+    library.Config << "staticlib";
+    library.Sources << "support.cpp";
+    project.Targets.append(library);
+
+    QString ninja = NinjaGenerator("/src", "", CMakeQtVersion_Qt5).Generate(project);
+    runner->Expect(ninja.contains("rule cxx\n  command = $cxx @$out.rsp -MD -MF $out.d -c $in -o $out\n  rspfile = $out.rsp\n")
+                   && ninja.contains("  depfile = $out.d\n  deps = gcc\n"), "ninja compile rule uses response and dependency files");
+    runner->Expect(ninja.contains("build ui_window.h: uic /src/ui/window.ui\n")
+                   && ninja.contains("build app.dir/main.cpp.o: cxx /src/main.cpp || ui_window.h\n"), "ninja compiles after uic headers exist");
+    runner->Expect(ninja.contains("build app.dir/__/shared/util.c.o: cc /shared/util.c || ui_window.h\n"), "ninja keeps objects of parent directories inside the target");
+    runner->Expect(ninja.contains("build app.dir/moc_missing_window.cpp: moc /src/missing_window.h\n")
+                   && ninja.contains("build app.dir/qrc_app.cpp: rcc /src/app.qrc\n  name = app\n"), "ninja runs moc and rcc");
+    runner->Expect(ninja.contains("rule moc\n  command = $moc $mocflags $in -o $out\n")
+                   && ninja.contains("build app.dir/moc_missing_window.cpp: moc /src/missing_window.h\n  mocflags = -DQT_CORE_LIB -DQT_WIDGETS_LIB")
+                   && ninja.contains(" '-I/src/include dir'\nbuild app.dir/moc_missing_window.cpp.o"),
+                   "moc gets its include paths as separate command line arguments");
+    runner->Expect(ninja.contains("'-I/src/include dir'") && ninja.contains("  ldflags = -Wl,-O1 -L/src/lib -lssl -lcrypto -lQt5Core -lQt5Widgets\n"),
+                   "ninja resolves paths against the project and links Qt libraries");
+    runner->Expect(ninja.contains(" -DQT_NO_DEBUG_OUTPUT") && !ninja.contains("APP_TRACE")
+                   && !ninja.contains("-rdynamic") && !ninja.contains("$<"),
+                   "ninja builds the Release values of per-configuration defines and link options");
+    runner->Expect(ninja.contains("build libsupport.a: archive support.dir/support.cpp.o\n") && ninja.contains("\ndefault app libsupport.a\n"),
+                   "ninja archives static libraries and builds every target by default");
+
+    QString fixture = Fixture("qmake/optimization/optimization.pro");
+    BuildProject optimization;
+    QMakeParser parser;
+    runner->Expect(parser.Parse(ReadFile(fixture), &optimization, fixture, "VERSION 3.16"), "optimization fixture parses");
+    ninja = NinjaGenerator(QFileInfo(fixture).absolutePath(), "", CMakeQtVersion_Qt6).Generate(optimization);
+    runner->Expect(ninja.contains(" -O3 -flto -DQT_CORE_LIB -DQT_NO_DEBUG_OUTPUT -I. -O3\n"),
+                   "ninja compiles the optimization fixture with its Release options and defines");
+    runner->Expect(ninja.contains("  ldflags = -flto -Wl,-O1 -lQt6Core\n"), "ninja links the optimization fixture with its Release options");
+    runner->Expect(!ninja.contains("APP_TRACE") && !ninja.contains("-fno-omit-frame-pointer") && !ninja.contains("$<"),
+                   "ninja leaves the Debug options of the optimization fixture out");
+
+    QString pch_fixture = Fixture("qmake/pch/pch.pro");
+    QString pch_directory = QFileInfo(pch_fixture).absolutePath();
+    BuildProject pch;
+    QMakeParser pch_parser;
+    pch_parser.Parse(ReadFile(pch_fixture), &pch, pch_fixture, "VERSION 3.16");
+    ninja = NinjaGenerator(pch_directory, "", CMakeQtVersion_Qt6).Generate(pch);
+    runner->Expect(ninja.contains("build view.moc: moc " + pch_directory + "/view.cpp\n  mocflags = ")
+                   && ninja.contains("build pch_app.dir/view.cpp.o: cxx " + pch_directory + "/view.cpp | view.moc || ui_view.h\n")
+                   && !ninja.contains("model.moc"), "ninja runs moc for sources that include their .moc file");
+    runner->Expect(ninja.contains("  flags = -std=c++17 "), "Qt 6 targets without a C++ standard are built as C++17");
+    runner->Expect(NinjaGenerator("/src", "", CMakeQtVersion_Qt5).Generate(project).contains("  flags = -std=c++11 "),
+                   "Qt 5 targets without a C++ standard get the default of the CMake output");
+}
+
+static void TestCMakePresets(TestRunner *runner)
+{
+    BuildProject project;
+    project.Name = "viewer";
+    BuildTarget *target = project.EnsurePrimaryTarget();
+    target->Name = "viewer";
+    target->Sources << "main.cpp";
+    QList<CMakeOption> options;
+    options << CMakeOption("WITH_TESTS", "Build tests", "FALSE");
+
+    QString presets = CMakePresetsGenerator(CMakeQtVersion_All, "/opt/Qt/6.5.3/gcc_64").Generate(project, options);
+    runner->Expect(presets.contains("\"version\": 3,") && presets.contains("\"generator\": \"Ninja\","), "presets configure a Ninja build");
+    runner->Expect(presets.contains("\"CMAKE_PREFIX_PATH\": \"/opt/Qt/6.5.3/gcc_64\""), "presets pass the Qt prefix");
+    runner->Expect(!presets.contains("LAUNCHER"), "presets do not carry the compiler launcher of the machine that converted the project");
+    runner->Expect(presets.contains("\"QT5BUILD\": \"TRUE\"") && presets.contains("\"WITH_TESTS\": \"FALSE\""),
+                   "presets set the generated options to their defaults");
+    runner->Expect(presets.contains("\"name\": \"release\"") && presets.contains("\"name\": \"relwithdebinfo\"")
+                   && presets.contains("\"CMAKE_BUILD_TYPE\": \"Debug\"\n"),
+                   "presets have release, relwithdebinfo and a fast debug preset");
+    runner->Expect(!presets.contains("CMAKE_UNITY_BUILD"), "presets leave unity builds to the targets --unity planned");
+    runner->Expect(!presets.contains("CMAKE_DISABLE_PRECOMPILE_HEADERS"), "presets leave precompiled headers alone when the project has none");
+
+    target->PrecompiledHeaders << "pch.h";
+    presets = CMakePresetsGenerator(CMakeQtVersion_Qt6, "").Generate(project, QList<CMakeOption>());
+    runner->Expect(!presets.contains("CMAKE_PREFIX_PATH") && !presets.contains("QT5BUILD"),
+                   "presets skip the prefix and Qt switch when they do not apply");
+    runner->Expect(presets.contains("\"CMAKE_DISABLE_PRECOMPILE_HEADERS\": \"OFF\""), "presets keep precompiled headers of the project on");
+
+    ProjectOutput output;
+    QString error;
+    runner->Expect(ProjectOutput::Parse("presets:CMakePresets.json", &output, &error) && output.Format == ProjectOutput_CMakePresets,
+                   "presets is an --emit output kind");
+}
+
+static QString WithoutTimestamp(const QString &text)
+{
+    QStringList lines = text.split('\n');
+    for (int i = lines.size() - 1; i >= 0; i--)
+    {
+        if (lines.at(i).startsWith("# https://"))
+            lines.removeAt(i);
+    }
+    return lines.join('\n');
+}
+
+static void TestProjectOutputs(TestRunner *runner)
+{
+    ProjectOutput output;
+    QString error;
+    runner->Expect(ProjectOutput::Parse("qt5:build/CMakeLists.txt", &output, &error) && output.Format == ProjectOutput_CMake
+                   && output.Version == CMakeQtVersion_Qt5 && output.FileName == "build/CMakeLists.txt", "qt5 output spec is parsed");
+    runner->Expect(ProjectOutput::Parse("QMAKE:C:/app.pro", &output, &error) && output.Format == ProjectOutput_QMake && output.FileName == "C:/app.pro",
+                   "output kind ignores case and the file name keeps its colons");
+    runner->Expect(!ProjectOutput::Parse("qt7:CMakeLists.txt", &output, &error) && error.contains("qt7"), "unknown output kind is refused");
+    runner->Expect(!ProjectOutput::Parse("qt5:", &output, &error) && !ProjectOutput::Parse("CMakeLists.txt", &output, &error),
+                   "output spec without a kind or a file is refused");
+
+    bool q2c = Configuration::q2c;
+    QString input = Configuration::InputFile;
+    Configuration::q2c = true;
+    Configuration::InputFile = Fixture("qmake/complex/complex.pro");
+    Project project;
+    project.Load(ReadFile(Configuration::InputFile));
+    QList<ProjectOutput> outputs;
+    foreach (const QString &spec, QStringList() << "qt5:a" << "qt6:b" << "qmake:c")
+    {
+        ProjectOutput::Parse(spec, &output, &error);
+        outputs.append(output);
+    }
+    project.GenerateOutputs(&outputs);
+    CMakeGenerator qt6(CMakeQtVersion_Qt6);
+    qt6.SetMinimumVersion("VERSION 3.16.0");
+    runner->Expect(WithoutTimestamp(outputs.at(0).Text) == WithoutTimestamp(CMakeGenerator(CMakeQtVersion_Qt5).Generate(project.GetModel(), QList<CMakeOption>()))
+                   && outputs.at(0).Text.contains("cmake_minimum_required (VERSION 3.1.0)"), "parallel qt5 output matches its generator");
+    runner->Expect(WithoutTimestamp(outputs.at(1).Text) == WithoutTimestamp(qt6.Generate(project.GetModel(), QList<CMakeOption>())),
+                   "parallel qt6 output raises the minimum CMake version");
+    runner->Expect(WithoutTimestamp(outputs.at(2).Text) == WithoutTimestamp(QMakeGenerator().Generate(project.GetModel())),
+                   "parallel qmake output matches its generator");
+    Configuration::q2c = q2c;
+    Configuration::InputFile = input;
+}
+
+static QString CountedMessage(int *formatted)
+{
+    (*formatted)++;
+    return "counted message";
+}
+
+static void TestLogging(TestRunner *runner)
+{
+    int formatted = 0;
+    int verbosity = Configuration::verbosity_level;
+    Configuration::verbosity_level = 0;
+    Q2C_DEBUG_LOG(1, "test", "app.pro", 1, CountedMessage(&formatted));
+    runner->Expect(formatted == 0, "disabled debug log does not format its message");
+    runner->Expect(!Logs::DebugEnabled(Q2C_LOG_MAX_VERBOSITY + 1), "debug log above the compile-time level is disabled");
+
+    Configuration::verbosity_level = 1;
+    Q2C_DEBUG_LOG(1, "test", "app.pro", 1, CountedMessage(&formatted));
+    Logs::Flush();
+    runner->Expect(formatted == 1, "enabled debug log formats its message once");
+    Configuration::verbosity_level = verbosity;
+}
+
 int main(int argc, char *argv[])
 {
     QCoreApplication app(argc, argv);
@@ -531,7 +1600,30 @@ int main(int argc, char *argv[])
     TestSubdirsFixture(&runner);
     TestCMakeFixtureParses(&runner);
     TestComplexCMakeFixture(&runner);
+    TestNestedCMakeScopes(&runner);
     TestRoundTrips(&runner);
+    TestRoundTripVerification(&runner);
     TestNegativeAndUnsupportedInputs(&runner);
+    TestQMakeVariableTable(&runner);
+    TestQMakeVariableStore(&runner);
+    TestStructuredWarnings(&runner);
+    TestLogging(&runner);
+    TestCMakeCommandRegistry(&runner);
+    TestPrecompiledHeaders(&runner);
+    TestOptimizationSettings(&runner);
+    TestCMakeTargetProperties(&runner);
+    TestProfileGuidedOptimization(&runner);
+    TestBuildAcceleration(&runner);
+    TestPchAnalyzer(&runner);
+    TestUnityPlanner(&runner);
+    TestConversionAllocations(&runner);
+    TestTokenViews(&runner);
+    TestCharScanner(&runner);
+    TestModelCache(&runner);
+    TestModelJson(&runner);
+    TestProjectOutputs(&runner);
+    TestCompileCommands(&runner);
+    TestNinjaGenerator(&runner);
+    TestCMakePresets(&runner);
     return runner.Finish();
 }
@@ -27,19 +27,138 @@ grep -q "qt_add_translations(complex_app TS_FILES" "$TMP_DIR/complex.cmake"
     -i "$ROOT_DIR/tests/fixtures/cmake/complex/CMakeLists.txt" > "$TMP_DIR/complex.pro"
 grep -q "TARGET = complex_cmake" "$TMP_DIR/complex.pro"
 grep -q "QT += \\\\" "$TMP_DIR/complex.pro"
-grep -q "CMake generator expressions require manual qmake review" "$TMP_DIR/complex.pro"
+grep -q "QMAKE_CXXFLAGS_DEBUG += -DDEBUG_ONLY" "$TMP_DIR/complex.pro"
 
+"$Q2C_BINARY" --strict --cmake-to-qmake --check -i "$ROOT_DIR/tests/fixtures/cmake/complex/CMakeLists.txt" 2>/dev/null
 if "$Q2C_BINARY" --strict --cmake-to-qmake --check \
-    -i "$ROOT_DIR/tests/fixtures/cmake/complex/CMakeLists.txt" >/dev/null 2>"$TMP_DIR/strict.err"; then
+    -i "$ROOT_DIR/tests/fixtures/cmake/properties/CMakeLists.txt" >/dev/null 2>"$TMP_DIR/strict.err"; then
     echo "strict mode unexpectedly accepted a warning-producing input" >&2
     exit 1
 fi
 grep -q "Strict mode failed" "$TMP_DIR/strict.err"
 
 "$Q2C_BINARY" --warnings json --cmake-to-qmake --check \
-    -i "$ROOT_DIR/tests/fixtures/cmake/complex/CMakeLists.txt" >/dev/null 2>"$TMP_DIR/warnings.jsonl"
+    -i "$ROOT_DIR/tests/fixtures/cmake/properties/CMakeLists.txt" >/dev/null 2>"$TMP_DIR/warnings.jsonl"
 grep -q '"type":"warning"' "$TMP_DIR/warnings.jsonl"
-grep -q '"line":83' "$TMP_DIR/warnings.jsonl"
+grep -q '"line":8' "$TMP_DIR/warnings.jsonl"
+grep -q '"code":"Q2C2003"' "$TMP_DIR/warnings.jsonl"
+grep -q '"code":"Q2C2007"' "$TMP_DIR/warnings.jsonl"
+
+"$Q2C_BINARY" --warnings sarif --cmake-to-qmake --check \
+    -i "$ROOT_DIR/tests/fixtures/cmake/properties/CMakeLists.txt" >/dev/null 2>"$TMP_DIR/warnings.sarif"
+grep -q '"version":"2.1.0"' "$TMP_DIR/warnings.sarif"
+grep -q '"startLine":18' "$TMP_DIR/warnings.sarif"
+
+"$Q2C_BINARY" --parser-stats --cmake-to-qmake --check \
+    -i "$ROOT_DIR/tests/fixtures/cmake/complex/CMakeLists.txt" >/dev/null 2>"$TMP_DIR/stats.txt"
+grep -Eq '^  target_sources +4$' "$TMP_DIR/stats.txt"
+
+"$Q2C_BINARY" --check --qt6 --save-model "$TMP_DIR/complex.q2cm" \
+    -i "$ROOT_DIR/tests/fixtures/qmake/complex/complex.pro" 2>/dev/null
+"$Q2C_BINARY" --dry-run --qt5 --load-model "$TMP_DIR/complex.q2cm" > "$TMP_DIR/cached.cmake" 2>/dev/null
+"$Q2C_BINARY" --dry-run --qt5 -i "$ROOT_DIR/tests/fixtures/qmake/complex/complex.pro" > "$TMP_DIR/parsed.cmake" 2>/dev/null
+diff -u <(grep -v '^# https://' "$TMP_DIR/parsed.cmake") <(grep -v '^# https://' "$TMP_DIR/cached.cmake")
+printf 'not a model' > "$TMP_DIR/broken.q2cm"
+if "$Q2C_BINARY" --dry-run --load-model "$TMP_DIR/broken.q2cm" >/dev/null 2>&1; then
+    echo "broken model cache was unexpectedly loaded" >&2
+    exit 1
+fi
+
+"$Q2C_BINARY" --emit-model json -i "$ROOT_DIR/tests/fixtures/qmake/complex/complex.pro" > "$TMP_DIR/model.json" 2>/dev/null
+grep -q '^{"Name":"complex_app",' "$TMP_DIR/model.json"
+"$Q2C_BINARY" --query 'targets[].ConditionalScopes[].Condition' \
+    -i "$ROOT_DIR/tests/fixtures/qmake/complex/complex.pro" > "$TMP_DIR/query.jsonl" 2>/dev/null
+grep -qx '"UNIX"' "$TMP_DIR/query.jsonl"
+if "$Q2C_BINARY" --query 'Targets.Sources' -i "$ROOT_DIR/tests/fixtures/qmake/complex/complex.pro" >/dev/null 2>&1; then
+    echo "invalid model query unexpectedly succeeded" >&2
+    exit 1
+fi
+
+"$Q2C_BINARY" --verify-roundtrip -i "$ROOT_DIR/tests/fixtures/qmake/library/library.pro" 2>/dev/null
+if "$Q2C_BINARY" --verify-roundtrip -i "$ROOT_DIR/tests/fixtures/qmake/console/console.pro" > "$TMP_DIR/roundtrip.txt" 2>/dev/null; then
+    echo "round trip that loses CONFIG values unexpectedly passed" >&2
+    exit 1
+fi
+grep -qx 'console_tool Config lost: console' "$TMP_DIR/roundtrip.txt"
+
+mkdir -p "$TMP_DIR/emit"
+"$Q2C_BINARY" --output-dir "$TMP_DIR/emit" --emit qt5:CMakeLists.qt5.txt --emit qt6:CMakeLists.txt --emit qmake:roundtrip.pro \
+    -i "$ROOT_DIR/tests/fixtures/qmake/complex/complex.pro" 2>/dev/null
+diff -u <(grep -v '^# https://' "$TMP_DIR/parsed.cmake") <(grep -v '^# https://' "$TMP_DIR/emit/CMakeLists.qt5.txt")
+grep -q 'cmake_minimum_required (VERSION 3.16.0)' "$TMP_DIR/emit/CMakeLists.txt"
+grep -q '^TARGET = complex_app' "$TMP_DIR/emit/roundtrip.pro"
+if "$Q2C_BINARY" --emit qt5:CMakeLists.qt5.txt --output-dir "$TMP_DIR/emit" \
+    -i "$ROOT_DIR/tests/fixtures/qmake/complex/complex.pro" >/dev/null 2>&1; then
+    echo "--emit unexpectedly overwrote an existing file" >&2
+    exit 1
+fi
+
+"$Q2C_BINARY" --compile-commands "$TMP_DIR/compile_commands.json" --qt-prefix "$TMP_DIR/qt" \
+    -i "$ROOT_DIR/tests/fixtures/qmake/library/library.pro" 2>/dev/null
+grep -q '"file":"'"$ROOT_DIR"'/tests/fixtures/qmake/library/' "$TMP_DIR/compile_commands.json"
+grep -q '"-I'"$TMP_DIR"'/qt/QtCore"' "$TMP_DIR/compile_commands.json"
+
+mkdir -p "$TMP_DIR/ninja/src"
+cp "$ROOT_DIR/tests/fixtures/qmake/qt6/qt6_widgets.pro" "$TMP_DIR/ninja/src/"
+touch "$TMP_DIR/ninja/src/main.cpp" "$TMP_DIR/ninja/src/window.cpp" "$TMP_DIR/ninja/src/window.ui" "$TMP_DIR/ninja/src/app.qrc"
+printf 'class Window { Q_OBJECT };\n' > "$TMP_DIR/ninja/src/window.h"
+"$Q2C_BINARY" --qt6 --output-dir "$TMP_DIR/ninja/build" --emit ninja:build.ninja -i "$TMP_DIR/ninja/src/qt6_widgets.pro" 2>/dev/null
+grep -q '^build qt6_widgets: link ' "$TMP_DIR/ninja/build/build.ninja"
+grep -q '^build qt6_widgets.dir/moc_window.cpp: moc ' "$TMP_DIR/ninja/build/build.ninja"
+if command -v ninja >/dev/null 2>&1; then
+    (cd "$TMP_DIR/ninja/build" && ninja -n >/dev/null)
+else
+    echo "ninja not found, skipping ninja -n check of the generated build.ninja"
+fi
+
+"$Q2C_BINARY" --qt6 --qt-prefix "$TMP_DIR/qt" --output-dir "$TMP_DIR/presets" --emit qt6:CMakeLists.txt \
+    --cmake-presets CMakePresets.json -i "$ROOT_DIR/tests/fixtures/qmake/qt6/qt6_widgets.pro" 2>/dev/null
+test -f "$TMP_DIR/presets/CMakeLists.txt"
+grep -q '"CMAKE_PREFIX_PATH": "'"$TMP_DIR"'/qt"' "$TMP_DIR/presets/CMakePresets.json"
+grep -q '"configurePreset": "fast"' "$TMP_DIR/presets/CMakePresets.json"
+
+cp -R "$ROOT_DIR/tests/fixtures/qmake/pch" "$TMP_DIR/pch"
+"$Q2C_BINARY" --qt6 --suggest-pch -i "$TMP_DIR/pch/pch.pro" -o "$TMP_DIR/pch/CMakeLists.txt" 2>"$TMP_DIR/pch/report.txt"
+grep -q '3 headers used by 3 of 3 translation units' "$TMP_DIR/pch/report.txt"
+grep -q '^#include <common.h>$' "$TMP_DIR/pch/pch_app_pch.h"
+grep -A1 '^target_precompile_headers(pch_app PRIVATE$' "$TMP_DIR/pch/CMakeLists.txt" | grep -q 'pch_app_pch.h'
+# Log lines of the main thread come out before what it prints to stdout afterwards
+printf 'TARGET = has_pch\nSOURCES += main.cpp\nPRECOMPILED_HEADER = stable.h\n' > "$TMP_DIR/pch/has_pch.pro"
+"$Q2C_BINARY" --qt6 --suggest-pch --dry-run -i "$TMP_DIR/pch/has_pch.pro" > "$TMP_DIR/pch/has_pch.cmake" 2>/dev/null
+head -n 1 "$TMP_DIR/pch/has_pch.cmake" | grep -q 'already has a precompiled header'
+
+"$Q2C_BINARY" --qt6 --unity 3 --dry-run -i "$ROOT_DIR/tests/fixtures/qmake/unity/unity.pro" \
+    >"$TMP_DIR/unity.cmake" 2>"$TMP_DIR/unity_report.txt"
+grep -q 'unity_app_unity_1: alpha.cpp gamma.cpp zeta.cpp' "$TMP_DIR/unity_report.txt"
+grep -q 'PROPERTIES UNITY_GROUP unity_app_unity_2' "$TMP_DIR/unity.cmake"
+if "$Q2C_BINARY" --unity 1 --check -i "$ROOT_DIR/tests/fixtures/qmake/unity/unity.pro" 2>/dev/null; then
+    echo "--unity accepted a batch of one source" >&2
+    exit 1
+fi
+
+"$Q2C_BINARY" --qmake-to-cmake --dry-run --qt6 \
+    -i "$ROOT_DIR/tests/fixtures/qmake/optimization/optimization.pro" > "$TMP_DIR/optimization.cmake"
+grep -q 'set(CMAKE_INTERPROCEDURAL_OPTIMIZATION_RELEASE ON)' "$TMP_DIR/optimization.cmake"
+grep -q 'target_compile_options(optimized_app PRIVATE $<$<OR:$<CONFIG:Release>,$<CONFIG:RelWithDebInfo>>:-O3>)' "$TMP_DIR/optimization.cmake"
+grep -q '$<$<OR:$<CONFIG:Release>,$<CONFIG:RelWithDebInfo>>:QT_NO_DEBUG_OUTPUT>' "$TMP_DIR/optimization.cmake"
+"$Q2C_BINARY" --cmake-to-qmake --dry-run -i "$TMP_DIR/optimization.cmake" > "$TMP_DIR/optimization.pro"
+grep -q 'QMAKE_LFLAGS_RELEASE += -Wl,-O1' "$TMP_DIR/optimization.pro"
+grep -q 'CONFIG(debug, debug|release) {' "$TMP_DIR/optimization.pro"
+"$Q2C_BINARY" --qt5 --verify-roundtrip -i "$ROOT_DIR/tests/fixtures/qmake/optimization/optimization.pro" > /dev/null 2>&1
+
+"$Q2C_BINARY" --qmake-to-cmake --dry-run --qt6 --pgo \
+    -i "$ROOT_DIR/tests/fixtures/qmake/optimization/optimization.pro" > "$TMP_DIR/pgo.cmake"
+grep -q 'set_property(CACHE PGO PROPERTY STRINGS OFF instrument use)' "$TMP_DIR/pgo.cmake"
+grep -q 'add_custom_target(optimized_app_pgo_merge' "$TMP_DIR/pgo.cmake"
+if grep -q 'PGO' "$TMP_DIR/optimization.cmake"; then
+    echo "PGO block generated without --pgo" >&2
+    exit 1
+fi
+
+"$Q2C_BINARY" --qmake-to-cmake --dry-run --qt6 --build-accel \
+    -i "$ROOT_DIR/tests/fixtures/qmake/optimization/optimization.pro" > "$TMP_DIR/accel.cmake"
+grep -q 'option(USE_COMPILER_LAUNCHER ' "$TMP_DIR/accel.cmake"
+grep -q 'set(CMAKE_JOB_POOL_LINK link_jobs)' "$TMP_DIR/accel.cmake"
 
 mkdir -p "$TMP_DIR/out"
 "$Q2C_BINARY" --qmake-to-cmake --qt6 --output-dir "$TMP_DIR/out" \